@@ -0,0 +1,480 @@
+// 后处理热路径基准测试（Google Benchmark）
+//
+// 对 yolo_cfg.cpp 中的每个配置生成合成输出张量，候选目标密度为 0 / 10 / 100 / 1000，
+// 分别测量 FilterWithSort、raw_post_processing、onnx_post_processing、Nms、完整 PostProc 和 PreProc。
+// 输出指标: 每帧耗时 (Time 列)、allocs/frame、candidates/s。
+//
+// 录制张量：设置环境变量后额外运行基于真实 NPU 输出的基准
+//   QTCAMDETECT_BENCH_CAPTURE=/path/to/capture.dxcap  (TensorRecorder 录制的文件)
+//   QTCAMDETECT_BENCH_CONFIG=yolov7_640               (录制时使用的配置名)
+#include <benchmark/benchmark.h>
+#include <QLoggingCategory>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <utils/capture_file.hpp>
+#include "yolo.h"
+#include "nms.h"
+#include "image.h"
+
+// ============================================================================
+// 分配计数（全局 operator new 替换）
+// ============================================================================
+
+static std::atomic<uint64_t> g_allocCount{0};
+
+void* operator new(std::size_t size)
+{
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// 部分后处理路径使用 std::cout 输出调试信息，计时期间重定向到空缓冲
+class CoutSilencer
+{
+public:
+    CoutSilencer() : m_old(std::cout.rdbuf(&m_null)) {}
+    ~CoutSilencer() { std::cout.rdbuf(m_old); }
+
+private:
+    struct NullBuffer : std::streambuf
+    {
+        int overflow(int c) override { return c; }
+    } m_null;
+    std::streambuf* m_old;
+};
+
+// ============================================================================
+// 合成输出张量
+// ============================================================================
+
+enum class OutputKind
+{
+    Anchor,     // 多层 anchor-based 特征图 [1, H, W, anchors*(5+numClasses)]
+    Yolov8Raw,  // 分数 [1, numClasses, N] + 框 [1, 1, 4, N]
+    Onnx,       // 单张量 [1, N, pitch]，YOLOv8 类型为 [1, 4+numClasses, N]
+};
+
+struct SyntheticOutput
+{
+    OutputKind kind;
+    std::vector<float> buffer;                     // 所有张量按顺序连续存放
+    dxrt::Tensors tensors;                         // 供 LayerReorder 使用（不持有数据）
+    dxrt::TensorPtrs tensorPtrs;                   // 指向 buffer 的张量
+    std::vector<std::vector<int64_t>> shapes;
+    int numEntries{0};
+};
+
+static OutputKind kindOf(const YoloParam& cfg)
+{
+    if (cfg.layers.empty()) {
+        return OutputKind::Onnx;
+    }
+    return cfg.layers[0].anchorWidth.empty() ? OutputKind::Yolov8Raw : OutputKind::Anchor;
+}
+
+// onnx 配置没有层信息，按输入尺寸推算候选框数量
+static int onnxEntryCount(const YoloParam& cfg)
+{
+    if (cfg.numBoxes > 0) {
+        return cfg.numBoxes;
+    }
+    int cells = 0;
+    if (cfg.postproc_type == PostProcType::POSE) {
+        // YOLOv5s6: 4 个尺度 (8/16/32/64)，每格 3 个 anchor
+        for (int stride = 8; stride <= 64; stride *= 2) {
+            cells += (cfg.width / stride) * (cfg.height / stride) * 3;
+        }
+        return cells;
+    }
+    for (int stride = 8; stride <= 32; stride *= 2) {
+        cells += (cfg.width / stride) * (cfg.height / stride);
+    }
+    return cells;
+}
+
+// 生成包含 numObjects 个高置信度目标的输出，其余位置均低于阈值
+static SyntheticOutput makeSyntheticOutput(const YoloParam& cfg, int numObjects, uint32_t seed = 1234)
+{
+    SyntheticOutput out;
+    out.kind = kindOf(cfg);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> coord(-1.f, 1.f);
+    std::uniform_int_distribution<int> cls(0, std::max(0, (int)cfg.numClasses - 1));
+    const int nc = cfg.numClasses;
+
+    std::vector<std::string> names;
+    if (out.kind == OutputKind::Anchor) {
+        for (const auto& layer : cfg.layers) {
+            int channels = (int)layer.anchorWidth.size() * (nc + 5);
+            out.shapes.push_back({1, layer.numGridY, layer.numGridX, channels});
+            names.push_back(layer.name);
+            out.numEntries += layer.numGridY * layer.numGridX * (int)layer.anchorWidth.size();
+        }
+    }
+    else if (out.kind == OutputKind::Yolov8Raw) {
+        int n = cfg.layers[0].numGridY;
+        out.shapes.push_back({1, nc, n});
+        out.shapes.push_back({1, 1, 4, n});
+        names = {cfg.layers[0].name, cfg.layers[1].name};
+        out.numEntries = n;
+    }
+    else {
+        int n = onnxEntryCount(cfg);
+        int pitch = (cfg.postproc_type == PostProcType::POSE) ? 6 + 51 : 5 + nc;
+        if (cfg.postproc_type == PostProcType::YOLOV8) {
+            out.shapes.push_back({1, 4 + nc, n});
+        }
+        else {
+            out.shapes.push_back({1, n, pitch});
+        }
+        names.push_back(cfg.onnxOutputName);
+        out.numEntries = n;
+    }
+
+    size_t total = 0;
+    std::vector<size_t> offsets;
+    for (const auto& shape : out.shapes) {
+        offsets.push_back(total);
+        size_t elems = 1;
+        for (auto d : shape) elems *= (size_t)d;
+        total += elems;
+    }
+    // anchor 输出用很小的 logit 填充（sigmoid 后远低于阈值），其余类型用 0
+    out.buffer.assign(total, out.kind == OutputKind::Anchor ? -8.f : 0.f);
+
+    // 随机选取 numObjects 个不重复的位置
+    std::vector<int> entries(out.numEntries);
+    for (int i = 0; i < out.numEntries; i++) entries[i] = i;
+    std::shuffle(entries.begin(), entries.end(), rng);
+    entries.resize(std::min(numObjects, out.numEntries));
+
+    for (int entry : entries) {
+        int c = cls(rng);
+        if (out.kind == OutputKind::Anchor) {
+            // 定位 entry 所在层与 anchor
+            int base = 0;
+            for (size_t l = 0; l < cfg.layers.size(); l++) {
+                const auto& layer = cfg.layers[l];
+                int numAnchors = (int)layer.anchorWidth.size();
+                int count = layer.numGridY * layer.numGridX * numAnchors;
+                if (entry < base + count) {
+                    int local = entry - base;
+                    int cell = local / numAnchors;
+                    int anchor = local % numAnchors;
+                    float* data = out.buffer.data() + offsets[l] + (size_t)cell * out.shapes[l][3] + anchor * (nc + 5);
+                    data[0] = coord(rng);
+                    data[1] = coord(rng);
+                    data[2] = coord(rng);
+                    data[3] = coord(rng);
+                    data[4] = 4.f;
+                    data[5 + c] = 4.f;
+                    break;
+                }
+                base += count;
+            }
+        }
+        else if (out.kind == OutputKind::Yolov8Raw) {
+            int n = out.numEntries;
+            out.buffer[offsets[0] + (size_t)c * n + entry] = 0.9f;
+            for (int k = 0; k < 4; k++) {
+                out.buffer[offsets[1] + (size_t)k * n + entry] = 1.f + coord(rng);
+            }
+        }
+        else if (cfg.postproc_type == PostProcType::YOLOV8) {
+            int n = out.numEntries;
+            float* base = out.buffer.data();
+            base[0 * n + entry] = 320.f + 100.f * coord(rng);
+            base[1 * n + entry] = 320.f + 100.f * coord(rng);
+            base[2 * n + entry] = 50.f;
+            base[3 * n + entry] = 50.f;
+            base[(size_t)(4 + c) * n + entry] = 0.9f;
+        }
+        else {
+            int pitch = (int)out.shapes[0][2];
+            float* data = out.buffer.data() + (size_t)entry * pitch;
+            data[0] = 320.f + 100.f * coord(rng);
+            data[1] = 320.f + 100.f * coord(rng);
+            data[2] = 50.f;
+            data[3] = 50.f;
+            data[4] = 0.9f;
+            data[5 + c] = 0.9f;
+        }
+    }
+
+    for (size_t i = 0; i < out.shapes.size(); i++) {
+        out.tensors.emplace_back(names[i], out.shapes[i], dxrt::DataType::FLOAT);
+        out.tensorPtrs.push_back(std::make_shared<dxrt::Tensor>(
+            names[i], out.shapes[i], dxrt::DataType::FLOAT, out.buffer.data() + offsets[i]));
+    }
+    return out;
+}
+
+// ============================================================================
+// 基准测试
+// ============================================================================
+
+struct BenchCase
+{
+    std::string configName;
+    YoloParam* param;
+    int numObjects;
+};
+
+static void reportCounters(benchmark::State& state, uint64_t allocs, uint64_t candidates)
+{
+    state.counters["allocs/frame"] = benchmark::Counter((double)allocs, benchmark::Counter::kAvgIterations);
+    state.counters["candidates/s"] = benchmark::Counter((double)candidates, benchmark::Counter::kIsRate);
+}
+
+// 准备 Yolo 实例；返回 nullptr 表示该配置不适用
+static std::unique_ptr<Yolo> makeYolo(const BenchCase& bc, const SyntheticOutput& out)
+{
+    CoutSilencer silence;
+    auto yolo = std::make_unique<Yolo>(*bc.param);
+    if (!yolo->LayerReorder(out.tensors)) {
+        return nullptr;
+    }
+    return yolo;
+}
+
+static void BM_FilterWithSort(benchmark::State& state, BenchCase bc)
+{
+    auto out = makeSyntheticOutput(*bc.param, bc.numObjects);
+    auto yolo = makeYolo(bc, out);
+    if (!yolo) {
+        state.SkipWithError("LayerReorder failed");
+        return;
+    }
+    uint64_t candidates = 0;
+    uint64_t allocBase = g_allocCount.load();
+    for (auto _ : state) {
+        yolo->ClearCandidates();
+        yolo->FilterWithSort(out.buffer.data(), out.shapes, dxrt::DataType::FLOAT);
+        candidates += yolo->CandidateCount();
+    }
+    reportCounters(state, g_allocCount.load() - allocBase, candidates);
+}
+
+static void BM_RawPostProcessing(benchmark::State& state, BenchCase bc)
+{
+    auto out = makeSyntheticOutput(*bc.param, bc.numObjects);
+    auto yolo = makeYolo(bc, out);
+    if (!yolo) {
+        state.SkipWithError("LayerReorder failed");
+        return;
+    }
+    uint64_t candidates = 0;
+    uint64_t allocBase = g_allocCount.load();
+    for (auto _ : state) {
+        yolo->ClearCandidates();
+        yolo->raw_post_processing(out.tensorPtrs);
+        candidates += yolo->CandidateCount();
+    }
+    reportCounters(state, g_allocCount.load() - allocBase, candidates);
+}
+
+static void BM_OnnxPostProcessing(benchmark::State& state, BenchCase bc)
+{
+    auto out = makeSyntheticOutput(*bc.param, bc.numObjects);
+    auto yolo = makeYolo(bc, out);
+    if (!yolo) {
+        state.SkipWithError("LayerReorder failed");
+        return;
+    }
+    CoutSilencer silence;
+    uint64_t candidates = 0;
+    uint64_t allocBase = g_allocCount.load();
+    for (auto _ : state) {
+        yolo->ClearCandidates();
+        yolo->onnx_post_processing(out.tensorPtrs, out.numEntries);
+        candidates += yolo->CandidateCount();
+    }
+    reportCounters(state, g_allocCount.load() - allocBase, candidates);
+}
+
+// 完整后处理：anchor 输出走 buffer 版本（与 YoloDetector 相同），其余走 TensorPtrs 版本
+static void BM_PostProc(benchmark::State& state, BenchCase bc)
+{
+    auto out = makeSyntheticOutput(*bc.param, bc.numObjects);
+    auto yolo = makeYolo(bc, out);
+    if (!yolo) {
+        state.SkipWithError("LayerReorder failed");
+        return;
+    }
+    CoutSilencer silence;
+    int outputLength = (int)out.buffer.size();
+    uint64_t candidates = 0;
+    uint64_t allocBase = g_allocCount.load();
+    for (auto _ : state) {
+        std::vector<BoundingBox> results;
+        if (out.kind == OutputKind::Anchor) {
+            results = yolo->PostProc(out.buffer.data(), out.shapes, dxrt::DataType::FLOAT, outputLength);
+        }
+        else {
+            results = yolo->PostProc(out.tensorPtrs);
+        }
+        candidates += yolo->CandidateCount();  // NMS 前的候选框数
+        benchmark::DoNotOptimize(results.data());
+    }
+    reportCounters(state, g_allocCount.load() - allocBase, candidates);
+}
+
+// NMS：每个目标生成 3 个互相重叠的候选框
+static void BM_Nms(benchmark::State& state, BenchCase bc)
+{
+    const YoloParam& cfg = *bc.param;
+    const int numCandidates = bc.numObjects * 3;
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> pos(0.f, (float)cfg.width - 60.f);
+    std::uniform_real_distribution<float> jitter(-4.f, 4.f);
+    std::uniform_real_distribution<float> score(0.3f, 1.f);
+    std::uniform_int_distribution<int> cls(0, std::max(0, (int)cfg.numClasses - 1));
+
+    std::vector<float> boxes(std::max(1, numCandidates) * 4);
+    std::vector<float> keypoints(std::max(1, numCandidates) * 51);
+    std::vector<std::vector<std::pair<float, int>>> sorted(cfg.numClasses);
+    for (int obj = 0; obj < bc.numObjects; obj++) {
+        float x = pos(rng), y = pos(rng);
+        int c = cls(rng);
+        for (int k = 0; k < 3; k++) {
+            int idx = obj * 3 + k;
+            boxes[idx * 4 + 0] = x + jitter(rng);
+            boxes[idx * 4 + 1] = y + jitter(rng);
+            boxes[idx * 4 + 2] = x + 50.f + jitter(rng);
+            boxes[idx * 4 + 3] = y + 50.f + jitter(rng);
+            sorted[c].emplace_back(score(rng), idx);
+        }
+    }
+    for (auto& v : sorted) {
+        std::sort(v.begin(), v.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    }
+    std::vector<std::string> classNames = cfg.classNames;
+    classNames.resize(cfg.numClasses);
+
+    uint64_t allocBase = g_allocCount.load();
+    for (auto _ : state) {
+        std::vector<BoundingBox> result;
+        Nms(cfg.numClasses, 0, classNames, sorted, boxes.data(), keypoints.data(), cfg.iouThreshold, result, 0);
+        benchmark::DoNotOptimize(result.data());
+    }
+    reportCounters(state, g_allocCount.load() - allocBase, (uint64_t)numCandidates * state.iterations());
+}
+
+static void BM_PreProc(benchmark::State& state, BenchCase bc)
+{
+    cv::Mat src(1080, 1920, CV_8UC3);
+    cv::randu(src, 0, 255);
+    cv::Mat dst(bc.param->height, bc.param->width, CV_8UC3);
+    uint64_t allocBase = g_allocCount.load();
+    for (auto _ : state) {
+        PreProc(src, dst, true, true, 114);
+        benchmark::DoNotOptimize(dst.data);
+    }
+    state.counters["allocs/frame"] = benchmark::Counter(
+        (double)(g_allocCount.load() - allocBase), benchmark::Counter::kAvgIterations);
+}
+
+// 录制张量：按录制顺序循环调用与 YoloDetector 相同的 buffer 版本 PostProc
+static void BM_RecordedPostProc(benchmark::State& state, std::string capturePath, YoloParam* param)
+{
+    dxapp::common::CaptureReader reader;
+    if (!reader.open(capturePath) || reader.size() == 0) {
+        state.SkipWithError("failed to open capture file");
+        return;
+    }
+    dxrt::Tensors tensors;
+    std::vector<std::vector<int64_t>> shapes;
+    for (const auto& desc : reader.tensors()) {
+        std::vector<int64_t> shape(desc.dims, desc.dims + desc.numDims);
+        tensors.emplace_back(desc.name, shape, static_cast<dxrt::DataType>(desc.dtype));
+        shapes.push_back(shape);
+    }
+    CoutSilencer silence;
+    Yolo yolo(*param);
+    if (!yolo.LayerReorder(tensors)) {
+        state.SkipWithError("LayerReorder failed: config does not match capture");
+        return;
+    }
+    auto dataType = static_cast<dxrt::DataType>(reader.tensors().front().dtype);
+    int outputLength = (int)(reader.header().outputSize / sizeof(float));
+
+    size_t frame = 0;
+    uint64_t candidates = 0;
+    uint64_t allocBase = g_allocCount.load();
+    for (auto _ : state) {
+        const auto& record = reader.record(frame);
+        auto results = yolo.PostProc(const_cast<uint8_t*>(record.payload), shapes, dataType, outputLength);
+        candidates += yolo.CandidateCount();
+        benchmark::DoNotOptimize(results.data());
+        frame = (frame + 1) % reader.size();
+    }
+    reportCounters(state, g_allocCount.load() - allocBase, candidates);
+}
+
+static void registerBenchmarks()
+{
+    const int densities[] = {0, 10, 100, 1000};
+    for (const auto& entry : GetYoloParamTable()) {
+        OutputKind kind = kindOf(*entry.param);
+        std::string cfgName = entry.name;
+        for (int n : densities) {
+            BenchCase bc{cfgName, entry.param, n};
+            std::string suffix = "/" + cfgName + "/" + std::to_string(n);
+            if (kind == OutputKind::Anchor) {
+                benchmark::RegisterBenchmark(("FilterWithSort" + suffix).c_str(), BM_FilterWithSort, bc);
+            }
+            if (kind != OutputKind::Onnx) {
+                benchmark::RegisterBenchmark(("RawPostProcessing" + suffix).c_str(), BM_RawPostProcessing, bc);
+            }
+            else {
+                benchmark::RegisterBenchmark(("OnnxPostProcessing" + suffix).c_str(), BM_OnnxPostProcessing, bc);
+            }
+            benchmark::RegisterBenchmark(("PostProc" + suffix).c_str(), BM_PostProc, bc);
+            benchmark::RegisterBenchmark(("Nms" + suffix).c_str(), BM_Nms, bc);
+        }
+        benchmark::RegisterBenchmark(("PreProc/" + cfgName + "/1920x1080").c_str(), BM_PreProc,
+                                     BenchCase{cfgName, entry.param, 0});
+    }
+
+    const char* capturePath = std::getenv("QTCAMDETECT_BENCH_CAPTURE");
+    const char* configName = std::getenv("QTCAMDETECT_BENCH_CONFIG");
+    if (capturePath && configName) {
+        YoloParam* param = FindYoloParam(configName);
+        if (param) {
+            benchmark::RegisterBenchmark(("RecordedPostProc/" + std::string(configName)).c_str(),
+                                         BM_RecordedPostProc, std::string(capturePath), param);
+        }
+        else {
+            std::cerr << "Unknown QTCAMDETECT_BENCH_CONFIG: " << configName << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // 后处理内部的 qDebug 日志会主导耗时，基准测试中关闭
+    QLoggingCategory::setFilterRules("*.debug=false");
+    registerBenchmarks();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/qlogging.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// 异步日志配置
+struct AsyncLoggerConfig
+{
+    QString filePath;              // 日志文件（追加写入），为空时不写文件
+    bool toStderr = true;
+    int queueCapacity = 8192;      // 队列槽位数（向上取 2 的幂），满时丢弃新消息并计数
+    int siteLimit = 20;            // 每个调用点每个窗口最多输出的 debug 条数（0 表示不限流）
+    int siteWindowMs = 1000;
+    int flushIntervalMs = 50;      // 后台线程最长等待时间（队列过半时提前唤醒）
+};
+
+// 日志统计（累计值）
+struct AsyncLoggerStats
+{
+    uint64_t written = 0;
+    uint64_t dropped = 0;          // 队列满丢弃
+    uint64_t suppressed = 0;       // 调用点限流丢弃
+};
+
+// 异步、限流的 Qt 消息处理器
+//
+// 采集回调和 NPU 回调线程里的 qDebug 不再同步格式化时间、写文件、flush 和写 stderr：
+// messageHandler() 只记录时间戳并把消息（隐式共享，不拷贝内容）放入无锁多生产者有界环形队列，
+// 后台线程批量取出，格式化后一次写入文件和 stderr，每批只 flush 一次。
+// - 队列满时直接丢弃并计数，生产者永不阻塞；
+// - debug 按调用点限流（有 QMessageLogContext 时按文件+行号，否则按消息开头的 [标签]），
+//   info（统计输出）和 warning 及以上不限流；限流表为固定大小的原子槽位，哈希冲突时线性探测相邻槽位，
+//   探测范围内的槽位都被本窗口活跃的调用点占用时才与首个槽位共享额度（近似限流）；
+// - 丢弃和限流数量由后台线程定期汇总输出一行；
+// - fatal 消息入队后同步等待写出再返回（Qt 随后中止程序）。
+// stop() 之后（或 start() 之前）的消息同步写 stderr，不会丢失。
+class AsyncLogger
+{
+public:
+    static AsyncLogger& instance();
+    ~AsyncLogger();
+
+    // 启动后台线程并安装为 Qt 消息处理器
+    void start(const AsyncLoggerConfig& config);
+    // 写出队列中剩余的消息，卸载消息处理器并停止后台线程
+    void stop();
+    // 等待当前已入队的消息写出（最多 timeoutMs）
+    void flush(int timeoutMs = 1000);
+
+    AsyncLoggerStats stats() const;
+
+    static void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg);
+
+private:
+    struct Entry
+    {
+        QtMsgType type = QtDebugMsg;
+        qint64 timestampMs = 0;
+        QString message;
+    };
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        Entry entry;
+    };
+    struct SiteBucket
+    {
+        std::atomic<uint64_t> key;
+        std::atomic<int64_t> window;
+        std::atomic<int> count;
+    };
+    static constexpr int kSiteBuckets = 1024;
+    static constexpr int kSiteProbe = 4;
+
+    AsyncLogger();
+    bool push(QtMsgType type, const QString& msg);
+    bool pop(Entry& entry);
+    bool allowSite(QtMsgType type, const QMessageLogContext& context, const QString& msg);
+    void writerLoop();
+    static QString formatLine(QtMsgType type, qint64 timestampMs, const QString& msg);
+
+    AsyncLoggerConfig m_config;
+    std::unique_ptr<Cell[]> m_cells;
+    size_t m_mask;
+    std::atomic<size_t> m_enqueuePos;
+    std::atomic<size_t> m_dequeuePos;     // 只由后台线程修改
+    SiteBucket m_sites[kSiteBuckets];
+
+    std::atomic<bool> m_running;
+    std::thread m_writer;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_flushed;
+    uint64_t m_flushRequest;              // 受 m_mutex 保护
+    uint64_t m_flushDone;
+
+    std::atomic<uint64_t> m_written;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_suppressed;
+};
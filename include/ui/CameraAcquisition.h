@@ -0,0 +1,87 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "IMVApi.h"
+
+class CameraFramePool;
+
+// 相机取帧方式
+enum class CameraAcquisitionMode
+{
+    Polling,     // IMV_GetFrame 轮询（帧在 SDK 缓冲中零拷贝传递，默认）
+    Callback     // IMV_AttachGrabbing 回调推送（帧到达即入队，无轮询等待，但每帧在回调中拷贝一次）
+};
+
+// 采集统计：SDK 流统计（IMV_GetStatisticsInfo）+ 回调队列统计
+struct CameraStreamStats
+{
+    bool sdkValid = false;
+    uint64_t sdkReceived = 0;        // SDK 正常接收的帧数
+    uint64_t sdkLost = 0;            // 丢包丢帧数
+    uint64_t sdkIncomplete = 0;      // 图像错误（不完整）帧数
+    double sdkFps = 0;
+    double bandwidthMbps = 0;
+
+    uint64_t delivered = 0;          // 回调收到的帧数
+    uint64_t overwritten = 0;        // 队列满时被新帧覆盖的帧数
+    uint64_t skipped = 0;            // 取帧时跳过的旧帧数（只取最新帧）
+    double avgQueueDelayUs = 0;      // 到达 -> 被取走的平均等待
+};
+
+// 读取 SDK 流统计（需在 IMV_StartGrabbing 之后调用）
+bool queryCameraStreamStats(IMV_HANDLE handle, CameraStreamStats& stats);
+
+// 回调采集：IMV_AttachGrabbing 注册回调，帧到达时打上时间戳放入小环形队列，
+// 取帧方直接拿最新帧，不需要轮询线程。
+// SDK 回调中的帧只在回调期间有效，因此在回调线程中用 IMV_CloneFrame 拷贝一次原始数据；
+// 队列中保存的是池帧（SDK 缓冲），只有 take() 取走的帧才由 CameraFramePool::wrap() 包装或转换（Bayer 解马赛克），
+// 被覆盖或跳过的旧帧直接归还，不做转换。
+// 每帧仍有一次拷贝，零拷贝需要轮询模式（默认）。
+// 设备关闭后注册失效，每次打开设备后需重新 attach()；attach() 必须在 IMV_StartGrabbing 之前调用。
+class CameraCallbackGrabber
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    CameraCallbackGrabber(IMV_HANDLE handle, std::shared_ptr<CameraFramePool> pool, size_t capacity = 4);
+    ~CameraCallbackGrabber();
+
+    bool attach();
+
+    // 取出最新帧（更早的帧丢弃并计数），最多等待 timeoutMs
+    bool take(cv::Mat& outFrame, int timeoutMs, Clock::time_point* arrival = nullptr);
+    void clear();
+
+    // 回调队列统计（不含 SDK 部分）
+    void fillStats(CameraStreamStats& stats) const;
+
+private:
+    struct Entry
+    {
+        IMV_Frame frame;             // CameraFramePool::clone() 得到的帧，出队时 wrap() 或 discard()
+        Clock::time_point arrival;
+    };
+
+    static void onFrame(IMV_Frame* frame, void* user);
+    void push(IMV_Frame* frame);
+
+    IMV_HANDLE m_handle;
+    std::shared_ptr<CameraFramePool> m_pool;
+    size_t m_capacity;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Entry> m_queue;
+
+    uint64_t m_delivered;
+    uint64_t m_overwritten;
+    uint64_t m_skipped;
+    uint64_t m_taken;
+    double m_queueDelaySumUs;
+};
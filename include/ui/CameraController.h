@@ -8,6 +8,13 @@
 #include "IMVApi.h"
 #include "YoloDetector.h"
 #include "VideoSource.h"
+#include "CameraFramePool.h"
+#include "CameraAcquisition.h"
+#include "CameraProfile.h"
+#include "InferenceRateController.h"
+#include "yolo/motion_gate.h"
+#include "yolo/tracker.h"
+#include <memory>
 
 struct DeviceInfo
 {
@@ -38,6 +45,18 @@ public:
     bool grabFrame();  // 在连续采集模式下获取一帧
     bool saveCurrentImage(const QString& filename);
 
+    // 取帧方式，在 connectCamera() 之前设置（回调注册在设备关闭前一直有效），默认轮询模式（IMV_GetFrame）
+    void setAcquisitionMode(CameraAcquisitionMode mode) { m_acquisitionMode = mode; }
+    CameraAcquisitionMode getAcquisitionMode() const { return m_acquisitionMode; }
+    CameraStreamStats getStreamStats() const;
+
+    // 相机端 ROI/合并/像素格式，须在已连接且停止采集时调用
+    bool applyCameraProfile(const CameraProfile& profile);
+    // 按已加载模型的输入尺寸配置（roi 为全分辨率传感器坐标，空表示全幅）
+    bool configureCameraForModel(const QRect& roi = QRect());
+    bool saveCameraProfile(const QString& path);
+    bool loadCameraProfile(const QString& path);
+
     // 获取当前图像
     cv::Mat getCurrentImage() const { return m_currentImage; }
     bool hasNewImage() const { return m_hasNewImage; }
@@ -45,10 +64,32 @@ public:
 
     // YOLO 检测相关
     bool initializeYolo(const QString& modelPath, int parameterIndex = 2);
+    // 后台加载模型（检测运行中切换模型，取帧和推理不中断），由 pollYoloModelLoad() 轮询结果
+    bool loadYoloModelAsync(const QString& modelPath, int parameterIndex = 2);
+    // 轮询后台加载结果（UI 定时器调用），新模型生效时重置速率控制和跟踪状态
+    YoloDetector::ModelLoadState pollYoloModelLoad();
     void enableYoloDetection(bool enable) { m_yoloEnabled = enable; }
     bool isYoloEnabled() const { return m_yoloEnabled; }
     std::vector<BoundingBox> getLatestDetections() const { return m_latestDetections; }
     
+    // 自适应推理速率：按延迟预算选择推理哪些帧（每帧 / 仅最新帧 / 每 N 帧）
+    void setInferenceLatencyBudget(double budgetMs);
+    InferenceRateStatus getInferenceRateStatus() const { return m_rateController.status(); }
+    
+    // 运动门控：画面静止时不提交推理，界面沿用上次检测结果
+    void enableMotionGating(bool enable);
+    bool isMotionGatingEnabled() const { return m_motionGateEnabled; }
+    void setMotionGateConfig(const MotionGateConfig& config) { m_motionGate.setConfig(config); }
+    const MotionGate& getMotionGate() const { return m_motionGate; }
+    
+    // 检测 + 跟踪：每帧输出带持久 ID 的轨迹，未推理的帧用 Kalman 外推位置
+    void enableTracking(bool enable);
+    bool isTrackingEnabled() const { return m_trackingEnabled; }
+    void setTrackerConfig(const TrackerConfig& config) { m_tracker.setConfig(config); }
+    // 当前帧的轨迹（grabFrame 后更新）
+    std::vector<TrackedObject> getCurrentTracks() const { return m_currentTracks; }
+    int getCreatedTrackCount() const { return m_tracker.createdTracks(); }
+    
     // 轮询模式：直接访问 YoloDetector
     YoloDetector* getYoloDetector() const { return m_yoloDetector; }
     
@@ -68,12 +109,20 @@ signals:
     void detectionsUpdated();
 
 private:
-    bool convertFrameToMat(IMV_Frame* frame);
+    // 接管 frame 的所有权；zeroCopy 为 false 时拷贝到自有内存（采集即将停止时使用）
+    bool convertFrameToMat(IMV_Frame* frame, bool zeroCopy = true);
     void logStatus(const QString& message);
     void processImageWithYolo(cv::Mat& image);
+    // 跟踪结果外推到 grabTime（当前显示帧的采集时刻）
+    void updateTracks(std::chrono::steady_clock::time_point grabTime);
+    // 新模型生效后重置与模型相关的状态
+    void onYoloModelActivated(const QString& modelPath);
 
 private:
     IMV_HANDLE m_deviceHandle;
+    std::shared_ptr<CameraFramePool> m_framePool;
+    CameraAcquisitionMode m_acquisitionMode;
+    std::unique_ptr<CameraCallbackGrabber> m_callbackGrabber;
     bool m_isConnected;
     bool m_isCapturing;
     cv::Mat m_currentImage;
@@ -88,6 +137,14 @@ private:
     YoloDetector* m_yoloDetector;
     bool m_yoloEnabled;
     std::vector<BoundingBox> m_latestDetections;
+    InferenceRateController m_rateController;
+    MotionGate m_motionGate;
+    bool m_motionGateEnabled;
+    MultiObjectTracker m_tracker;
+    bool m_trackingEnabled;
+    uint64_t m_trackedFrameId;            // 已送入跟踪器的最新检测帧号
+    std::vector<TrackedObject> m_currentTracks;
+    QString m_pendingModelPath;                 // 后台加载中的模型路径
     
     // 信号限流标志 - 防止Qt事件队列溢出
     QAtomicInt m_pendingDetectionSignals;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include "IMVApi.h"
+
+// 相机帧缓冲池：把 SDK 帧缓冲零拷贝包装成引用计数的 cv::Mat
+//
+// wrap() 返回的 Mat 直接指向 IMV_GetFrame 得到的缓冲，浅拷贝/ROI 共享同一引用计数，
+// 所有使用者（预处理、显示等）都释放后才通过 IMV_ReleaseFrame 把缓冲归还给 SDK。
+// 仅 Mono8/BGR8 可零拷贝，其他像素格式通过 IMV_PixelConvert 直接转换到新分配的 Mat 并立即归还缓冲。
+//
+// 使用者长时间持有帧会占用 SDK 缓冲，缓冲数量由 configureBufferCount() 按流水线深度设置。
+// 关闭设备前必须调用 detach()：等待使用者归还全部帧；超时仍被持有的帧数据指向 SDK 缓冲，
+// 此时不能关闭设备，改由缓冲池在最后一帧归还时关闭设备并销毁句柄。
+class CameraFramePool : public std::enable_shared_from_this<CameraFramePool>
+{
+public:
+    // SDK 接收队列保留的缓冲数（在流水线持有的帧之外）
+    static constexpr unsigned int kSdkReceiveBuffers = 4;
+    // 默认流水线深度：采集端当前帧 + 显示 + 预处理
+    static constexpr unsigned int kDefaultPipelineDepth = 3;
+    // 关闭设备时等待帧归还的上限
+    static constexpr int kDetachTimeoutMs = 1000;
+
+    static std::shared_ptr<CameraFramePool> create(IMV_HANDLE handle);
+
+    // 必须在 IMV_StartGrabbing 之前调用
+    bool configureBufferCount(unsigned int pipelineDepth = kDefaultPipelineDepth);
+
+    // 接管 frame 的所有权（无论成功与否，frame 都会被归还或交给返回的 Mat）
+    // 失败时返回空 Mat
+    cv::Mat wrap(IMV_Frame& frame);
+
+    // 深拷贝帧（IMV_CloneFrame，不做格式转换），用于只在回调期间有效的 IMV_AttachGrabbing 帧。
+    // 成功时 out 计入未归还帧数，之后必须交给 wrap()（转成 Mat）或 discard()（直接归还）
+    bool clone(IMV_Frame& frame, IMV_Frame& out);
+    void discard(IMV_Frame& frame) { release(frame); }
+
+    // 设备关闭前调用（已停止采集），等待帧归还最多 timeoutMs。
+    // 返回 true：全部归还，调用方照常 IMV_Close/IMV_DestroyHandle；
+    // 返回 false：仍有帧被持有，设备由缓冲池在最后一帧归还时关闭并销毁句柄，调用方不得再关闭或销毁句柄
+    bool detach(int timeoutMs = kDetachTimeoutMs);
+
+    int outstanding() const { return m_outstanding.load(std::memory_order_relaxed); }
+
+    // 判断 Mat 是否引用 SDK 缓冲（停止采集前需要用 detachFrame 转成自有内存）
+    static bool isPoolFrame(const cv::Mat& image);
+    static cv::Mat detachFrame(const cv::Mat& image);
+
+private:
+    class FrameAllocator;
+    struct FrameRef;
+
+    explicit CameraFramePool(IMV_HANDLE handle);
+    void release(IMV_Frame& frame);
+    cv::Mat convert(IMV_Frame& frame);
+    cv::Mat pixelConvert(const IMV_Frame& frame);
+
+    static const FrameAllocator& allocator();
+
+    IMV_HANDLE m_handle;
+    std::mutex m_mutex;
+    std::condition_variable m_released;
+    std::atomic<int> m_outstanding;      // 修改在 m_mutex 下进行（wrap 的递增除外）
+    bool m_closePending;                 // detach 超时，最后一帧归还时关闭设备
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QtCore/QRect>
+#include <QtCore/QString>
+#include "IMVApi.h"
+
+// 相机端采集配置：ROI、像素合并（binning）和像素格式
+// 在相机上完成裁剪/降采样，减少链路带宽（提高单个 GigE 链路可达帧率）和主机端转换量
+struct CameraProfile
+{
+    // ROI 为合并后的图像坐标；width/height 为 0 表示最大（全幅）
+    int offsetX = 0;
+    int offsetY = 0;
+    int width = 0;
+    int height = 0;
+    int binningHorizontal = 1;
+    int binningVertical = 1;
+    QString pixelFormat;       // GenICam 符号名，如 BayerRG8/Mono8/BGR8；空表示不修改
+};
+
+// 打开相机时应用的配置请求（按优先级：loadPath > 按模型输入自动配置）
+struct CameraProfileRequest
+{
+    QString loadPath;          // IMV_LoadDeviceCfg 配置文件
+    int modelWidth = 0;        // 模型输入尺寸，>0 时按模型输入和 roi 自动选择合并倍数和像素格式
+    int modelHeight = 0;
+    QRect roi;                 // 全分辨率传感器坐标，空表示全幅
+    bool preferBayer = false;  // 彩色相机优先 Bayer 8 位（省带宽，但每帧在主机端插值，不能零拷贝）
+    QString savePath;          // 应用后用 IMV_SaveDeviceCfg 保存
+
+    bool isEmpty() const { return loadPath.isEmpty() && (modelWidth <= 0 || modelHeight <= 0); }
+};
+
+// 读取相机当前配置
+CameraProfile readCameraProfile(IMV_HANDLE handle);
+
+// 根据模型输入尺寸和 ROI 计算配置：
+// - 合并倍数取不损失模型输入分辨率的最大值（letterbox 后的缩放比例仍 <= 1）
+// - 彩色相机优先 BGR8（采集帧零拷贝），不支持时用 Bayer 8 位；黑白相机使用 Mono8
+// - preferBayer 时彩色相机优先 Bayer 8 位（每像素 1 字节，BGR8 的 1/3，带宽受限时使用），由 SDK 在主机端逐帧插值
+CameraProfile buildCameraProfile(IMV_HANDLE handle, int modelWidth, int modelHeight, const QRect& roi = QRect(),
+                                 bool preferBayer = false);
+
+// 写入相机（必须在停止采集时调用），数值按相机的步进和范围对齐
+bool applyCameraProfile(IMV_HANDLE handle, const CameraProfile& profile);
+
+// 按请求配置相机（打开设备后、开始采集前调用）
+bool applyCameraProfileRequest(IMV_HANDLE handle, const CameraProfileRequest& request);
+
+// 保存/加载相机全部参数（IMV_SaveDeviceCfg/IMV_LoadDeviceCfg）
+bool saveCameraProfile(IMV_HANDLE handle, const QString& path);
+bool loadCameraProfile(IMV_HANDLE handle, const QString& path);
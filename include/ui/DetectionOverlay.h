@@ -0,0 +1,22 @@
+#pragma once
+
+#include <QtGui/QImage>
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "yolo/bbox.h"
+
+// 预览画面的检测框叠加层
+//
+// 预览帧由 PreviewStage 缩放到显示分辨率（自有内存），这里把它包装成 QImage::Format_BGR888
+// （不做 BGR→RGB 转换），检测框用 QPainter 按显示坐标画在预览帧上，标签用 LabelSpriteCache 的预渲染精灵混合。
+// 单帧开销只和视图尺寸有关，与传感器分辨率无关；采集帧不被修改，保存/快照得到的仍是原图。
+class DetectionOverlay
+{
+public:
+    // 叠加检测框（框坐标为采集帧坐标，frameSize 为采集帧尺寸）。
+    // 返回的 QImage 引用 preview 的数据，preview 释放前有效
+    static QImage render(cv::Mat& preview, const cv::Size& frameSize, const std::vector<BoundingBox>& detections);
+
+    // 在显示图像上绘制检测框，scaleX/scaleY 为显示尺寸与帧尺寸之比
+    static void drawDetections(QImage& image, const std::vector<BoundingBox>& detections, double scaleX, double scaleY);
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <QtCore/QObject>
+#include <QtCore/QRect>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QList>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QTextStream>
+#include <QtCore/QTimer>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yolo/bbox.h"
+#include "yolo/motion_gate.h"
+#include "VideoFileDecoder.h"
+#include "ImageSequenceReader.h"
+
+class VideoSourceManager;
+class YoloDetector;
+class IInferenceBackend;
+class MultiStreamPipeline;
+struct StreamStats;
+struct CameraStreamStats;
+
+// 无界面运行参数（命令行或 INI 配置文件，见 headless_main.cpp）
+struct HeadlessOptions
+{
+    QString source = "camera:0";              // camera:<index>、v4l2:<device>、视频文件路径、图片序列（目录 / .txt/.lst 列表文件）或 synthetic:...
+    QStringList streams;                       // 多路模式的视频源（非空时忽略 source），camera:all 表示全部相机
+    QList<int> streamWeights;                  // 多路调度权重，与 streams 一一对应（缺省为 1）
+    int maxInFlight = 4;                       // 多路模式同时提交到 NPU 的帧数
+    int batchSize = 1;                         // 多路模式批大小（>1 时使用向量 Run 批量提交）
+    int batchWindowUs = 2000;                  // 凑批时间窗口
+    QString acquisition = "polling";           // 相机取帧方式: polling（零拷贝）或 callback
+    bool cameraAutoProfile = false;            // 按模型输入尺寸自动选择相机合并倍数和像素格式
+    QRect cameraRoi;                           // 相机端 ROI（全分辨率传感器坐标），非空时启用自动配置
+    QString cameraProfilePath;                 // 加载相机配置文件（优先于自动配置）
+    QString cameraProfileSavePath;             // 应用配置后保存到文件
+    bool motionGate = false;                   // 画面静止时跳过推理（单路和多路模式均适用）
+    MotionGateConfig motionGateConfig;
+    QString modelPath = "./assets/models/YoloV7.dxnn";
+    int parameterIndex = 4;                    // 同 YoloDetector::initializeModel
+    int warmupRuns = 4;                        // 模型加载后的预热次数（0 表示不预热）
+    bool multiDevice = false;                  // 多设备负载均衡（devices 为空时使用全部设备）
+    QList<int> devices;                        // 参与负载均衡的 NPU 设备编号
+    QString replayPath;                        // 非空时使用回放后端代替 NPU
+    int replayLatencyUs = 10000;
+    bool loop = true;                          // 视频文件结束后从头播放
+    VideoDecoderOptions videoDecoder;          // 视频文件预取解码：队列长度、解码线程数、输出节奏
+    ImageSequenceOptions imageSequence;        // 图片序列并行解码：线程数、队列长度
+    int durationSec = 0;                       // 运行时长（0 表示不限）
+    qint64 maxFrames = 0;                      // 处理帧数上限（0 表示不限）
+    int statsIntervalMs = 5000;                // 统计输出间隔
+    int resultTimeoutMs = 2000;                // 单帧推理超时
+    QString resultsPath;                       // 检测结果输出（JSON Lines），空则不输出
+    QString recordPath;                        // 录制输出张量（.dxcap），空则不录制
+};
+
+// 无界面流水线：视频源 -> YoloDetector -> 结果输出，周期性打印吞吐和延迟
+// 不依赖 QtWidgets，可在无显示环境中用于部署、长时间稳定性测试和容量评估
+// 配置 streams 时切换为多路模式：各路共享一个推理后端（MultiStreamPipeline），按路输出统计
+class HeadlessRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HeadlessRunner(const HeadlessOptions& options, QObject* parent = nullptr);
+    ~HeadlessRunner();
+
+    bool start();
+    // 可从信号处理函数调用（只设置标志，下一次 tick 时退出）
+    void requestStop() { m_stopRequested = true; }
+
+signals:
+    void finished(int exitCode);
+
+private slots:
+    void onTick();
+    void onStatsTimer();
+
+private:
+    struct IntervalStats
+    {
+        qint64 grabbed = 0;
+        qint64 grabFailures = 0;
+        qint64 gated = 0;                  // 运动门控跳过的帧数
+        qint64 submitted = 0;
+        qint64 submitFailures = 0;         // detectAsync 提交失败的帧数
+        qint64 completed = 0;
+        qint64 timeouts = 0;
+        qint64 detections = 0;
+        double latencySumMs = 0;
+        double latencyMaxMs = 0;
+        std::vector<double> latenciesMs;   // 仅统计区间内保存，用于计算分位数
+    };
+
+    bool openSource();
+    bool initializeDetector();
+    std::unique_ptr<IInferenceBackend> createBackend();
+    bool openResultsFile();
+    bool startMultiStream();
+    void printStreamStats(const std::vector<StreamStats>& stats, double elapsedSec, const char* title);
+    void completeFrame(double latencyMs);
+    // stream >= 0 时（多路模式）输出流编号，input 非空时（图片序列）输出文件路径
+    void writeResults(uint64_t frameId, double latencyMs, const std::vector<BoundingBox>& results, int stream = -1,
+                      const QString& input = QString());
+    void printStats(const IntervalStats& stats, double elapsedSec, const char* title);
+    void printCameraStats();
+    void printCameraStats(const QString& label, const CameraStreamStats& stats);
+    // 视频文件 / 图片序列源的解码统计（解码速率与流水线帧率分开输出）、合成源的输出统计
+    void printVideoStats();
+    void printDeviceStats(const char* title);
+    void finish(int exitCode);
+
+    HeadlessOptions m_options;
+    VideoSourceManager* m_sourceManager;
+    YoloDetector* m_detector;
+    QTimer* m_tickTimer;
+    QTimer* m_statsTimer;
+
+    cv::Mat m_frame;
+    bool m_inFlight;
+    uint64_t m_inFlightFrameId;
+    QString m_inFlightInput;
+    QElapsedTimer m_inFlightTimer;
+    QElapsedTimer m_runTimer;
+    QElapsedTimer m_intervalTimer;
+
+    IntervalStats m_interval;
+    IntervalStats m_total;
+    MotionGate m_motionGate;
+    std::atomic<bool> m_stopRequested;
+    bool m_finished;
+
+    std::unique_ptr<QFile> m_resultsFile;
+    std::unique_ptr<QTextStream> m_resultsStream;
+
+    // 多路模式（结果在推理回调线程中写入，由 m_resultsMutex 保护）
+    std::unique_ptr<MultiStreamPipeline> m_pipeline;
+    std::mutex m_resultsMutex;
+    std::atomic<qint64> m_pipelineCompleted;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct ImageSequenceOptions
+{
+    int decodeThreads = 0;           // 解码线程数（0 使用全部核心）
+    int queueCapacity = 16;          // 已解码未取走的最大帧数（含乱序完成、等待按序交付的帧），不小于线程数
+    bool loop = false;               // 全部取完后从第一张重新开始
+    bool memoryMap = true;           // 内存映射读取文件，映射失败时退回整体读取
+    int imreadFlags = cv::IMREAD_COLOR;
+};
+
+// 解码统计（累计值）
+struct ImageSequenceStats
+{
+    uint64_t decoded = 0;            // 解码成功的图片数
+    uint64_t delivered = 0;          // 被取走的图片数
+    uint64_t failed = 0;             // 无法读取或解码的图片（交付时跳过）
+    uint64_t loops = 0;
+    int queued = 0;
+    double decodeFps = 0;            // 全部解码线程满负荷时的解码速率（只计解码耗时）
+};
+
+// 图片序列读取：线程池并行解码，按文件顺序交付
+// - 工作线程按序号领取文件，解码完成后放入按序号排序的缓冲；取帧方只按序号连续取出
+// - 领取序号不超过 已交付 + queueCapacity，慢文件阻塞交付时其余线程最多领先一个队列长度
+// - 不限速：取帧方有多快就交付多快（离线批量评估的最大吞吐模式）
+class ImageSequenceReader
+{
+public:
+    ImageSequenceReader(const QStringList& files, const ImageSequenceOptions& options);
+    ~ImageSequenceReader();
+
+    // 枚举目录（按文件名自然排序的图片文件）或列表文件（每行一个路径，相对路径以列表文件所在目录为基准）
+    static QStringList listFiles(const QString& path);
+    // 路径是目录或 .txt/.lst 列表文件
+    static bool isSequencePath(const QString& path);
+
+    void start();
+    void stop();
+
+    // 按文件顺序取下一张，fileIndex 为其在列表中的序号；最多等待 timeoutMs
+    // 非循环且已全部取完时立即返回 false
+    bool take(cv::Mat& outFrame, int& fileIndex, int timeoutMs);
+    bool finished() const;
+
+    int count() const { return m_files.size(); }
+    const QString& file(int index) const { return m_files[index]; }
+    ImageSequenceStats stats() const;
+
+private:
+    void workerLoop();
+    bool decodeFile(const QString& path, cv::Mat& image) const;
+
+    QStringList m_files;
+    ImageSequenceOptions m_options;
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_ready;     // 有新的解码结果
+    std::condition_variable m_space;     // 交付推进，可以继续领取
+    std::map<uint64_t, cv::Mat> m_done;  // 序号 -> 解码结果（空 Mat 表示失败）
+    uint64_t m_nextClaim;
+    uint64_t m_nextDeliver;
+    bool m_stopping;
+
+    uint64_t m_decoded;
+    uint64_t m_delivered;
+    uint64_t m_failed;
+    double m_decodeBusySec;
+};
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <dxrt/dxrt_api.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dxapp { namespace common { class CaptureReader; } }
+
+// 输出张量描述（对应 dxrt::Tensor 的元数据，不持有数据）
+struct OutputTensorDesc
+{
+    std::string name;
+    std::vector<int64_t> shape;
+    dxrt::DataType type{dxrt::DataType::FLOAT};
+    uint64_t offset{0};        // 在输出 buffer 中的字节偏移
+    uint64_t sizeInBytes{0};
+};
+
+// 推理后端抽象：YoloDetector 只依赖该接口，不再直接持有 dxrt::InferenceEngine
+class IInferenceBackend
+{
+public:
+    // 异步推理完成回调（在后端线程中调用）
+    // output: runAsync 时传入的输出 buffer；userArg: runAsync 时传入的用户参数
+    using Callback = std::function<void(void* output, void* userArg)>;
+
+    virtual ~IInferenceBackend() = default;
+
+    virtual std::string name() const = 0;
+    virtual uint64_t inputSize() const = 0;
+    virtual uint64_t outputSize() const = 0;
+    virtual const std::vector<OutputTensorDesc>& outputDescs() const = 0;
+
+    // 同步推理，结果写入 output（大小至少为 outputSize()）
+    virtual bool run(void* input, void* output) = 0;
+    // 同步批量推理（inputs/outputs 一一对应），不触发异步回调；默认逐帧调用 run()
+    virtual bool runBatch(const std::vector<void*>& inputs, const std::vector<void*>& outputs);
+    // 异步推理，立即返回 job id（失败返回 -1），完成后调用已注册的回调
+    virtual int runAsync(void* input, void* userArg, void* output) = 0;
+    virtual void setCallback(Callback callback) = 0;
+    // 预热推理（模型加载时调用，不计入统计、不影响回放顺序）；默认等同于 run()
+    virtual bool warmupRun(void* input, void* output) { return run(input, output); }
+    // 最近的单帧 NPU 推理时间（微秒），不支持时返回 0
+    virtual double npuTimeUs() const { return 0; }
+
+    // 由 outputDescs() 构造 dxrt::Tensors（供 Yolo::LayerReorder 使用）
+    dxrt::Tensors outputTensors() const;
+    std::vector<std::vector<int64_t>> outputShapes() const;
+    dxrt::DataType outputType() const;
+};
+
+// DeepX NPU 后端（dxrt::InferenceEngine 的薄封装）
+class DxrtInferenceBackend : public IInferenceBackend
+{
+public:
+    explicit DxrtInferenceBackend(const std::string& modelPath,
+                                  dxrt::InferenceOption option = dxrt::InferenceOption());
+    ~DxrtInferenceBackend() override;
+
+    std::string name() const override { return "dxrt:" + m_modelPath; }
+    uint64_t inputSize() const override { return m_inputSize; }
+    uint64_t outputSize() const override { return m_outputSize; }
+    const std::vector<OutputTensorDesc>& outputDescs() const override { return m_outputDescs; }
+
+    bool run(void* input, void* output) override;
+    // 使用 InferenceEngine::Run 的向量重载，一次提交整批，分摊每次提交的开销
+    bool runBatch(const std::vector<void*>& inputs, const std::vector<void*>& outputs) override;
+    int runAsync(void* input, void* userArg, void* output) override;
+    void setCallback(Callback callback) override;
+    double npuTimeUs() const override { return m_engine->GetNpuInferenceTime(); }
+
+    dxrt::InferenceEngine* engine() const { return m_engine.get(); }
+
+private:
+    // 透传给 DXRT 的 userArg，用于在回调中找回输出 buffer
+    struct AsyncJob
+    {
+        void* output;
+        void* userArg;
+    };
+
+    std::string m_modelPath;
+    dxrt::InferenceOption m_option;
+    std::unique_ptr<dxrt::InferenceEngine> m_engine;
+    std::vector<OutputTensorDesc> m_outputDescs;
+    uint64_t m_inputSize;
+    uint64_t m_outputSize;
+    Callback m_callback;
+
+    // runAsync 提交到回调返回之间的任务数（由 m_jobMutex 保护），析构时等待归零后再销毁引擎
+    void finishJob();
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobsDone;
+    int m_outstandingJobs;
+    bool m_closing;
+};
+
+// 多设备后端：每个 DeepX 模块一个绑定设备的 InferenceEngine（InferenceOption::devices/boundOption），
+// 每帧分发到预计最早完成的设备：(在途帧数 + 1) * 最近的 NPU 推理时间。
+// 在途帧数由本类计数；推理时间取各引擎 GetNpuInferenceTimeVector() 最近若干次的均值，
+// 在提交线程中定期刷新（不在 DXRT 回调线程中查询引擎）。
+// 完成顺序可能与提交顺序不同，需要按帧序输出的调用方自行排序（见 MultiStreamPipeline）。
+class MultiDeviceInferenceBackend : public IInferenceBackend
+{
+public:
+    struct DeviceStats
+    {
+        int deviceId{0};
+        int inFlight{0};
+        uint64_t submitted{0};
+        uint64_t completed{0};
+        double latencyUs{0};         // GetLatencyVector 最近均值（含排队）
+        double npuTimeUs{0};         // GetNpuInferenceTimeVector 最近均值
+    };
+
+    // deviceIds 为空时使用全部设备
+    MultiDeviceInferenceBackend(const std::string& modelPath, std::vector<int> deviceIds = {},
+                                uint32_t boundOption = dxrt::InferenceOption::NPU_ALL);
+    ~MultiDeviceInferenceBackend() override;
+
+    std::string name() const override;
+    uint64_t inputSize() const override { return m_devices.front()->backend->inputSize(); }
+    uint64_t outputSize() const override { return m_devices.front()->backend->outputSize(); }
+    const std::vector<OutputTensorDesc>& outputDescs() const override { return m_devices.front()->backend->outputDescs(); }
+
+    bool run(void* input, void* output) override;
+    // 每个设备各跑一次（各引擎独立分配内部 buffer）
+    bool warmupRun(void* input, void* output) override;
+    bool runBatch(const std::vector<void*>& inputs, const std::vector<void*>& outputs) override;
+    int runAsync(void* input, void* userArg, void* output) override;
+    void setCallback(Callback callback) override;
+
+    // 各设备最近 NPU 时间的均值
+    double npuTimeUs() const override;
+
+    size_t deviceCount() const { return m_devices.size(); }
+    std::vector<DeviceStats> deviceStats() const;
+
+private:
+    struct Device
+    {
+        int id{0};
+        std::unique_ptr<DxrtInferenceBackend> backend;
+        std::atomic<int> inFlight{0};
+        std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t> completed{0};
+        uint64_t refreshedAt{0};             // 上次刷新耗时统计时的 completed，由 m_refreshMutex 保护
+        std::atomic<double> latencyUs{0};
+        std::atomic<double> npuTimeUs{0};
+    };
+
+    // 透传给单设备后端的 userArg
+    struct AsyncJob
+    {
+        size_t device;
+        void* userArg;
+    };
+
+    size_t pickDevice();
+    void refreshTimings();
+
+    std::string m_modelPath;
+    std::vector<std::unique_ptr<Device>> m_devices;
+    std::mutex m_refreshMutex;
+    Callback m_callback;
+};
+
+// 回放后端：从磁盘读取录制的输出张量，按配置的延迟模拟 NPU
+// replayPath 可以是 TensorRecorder 录制的 .dxcap 文件（内存映射，不额外占用内存），
+// 也可以是目录：
+//   tensors.txt   每行一个输出张量: <name> <dtype> <dim0> <dim1> ...
+//                 dtype 为 dxrt::DataType 的整数值（FLOAT=1, UINT8=2 ...）
+//   *.bin         每个文件一帧完整的输出 buffer（即 dxrt::DataDumpBin 的输出），按文件名排序循环回放
+class ReplayInferenceBackend : public IInferenceBackend
+{
+public:
+    struct Options
+    {
+        int latencyUs{10000};        // 每次推理的模拟延迟
+        int latencyJitterUs{0};      // 延迟抖动（均匀分布 ±jitter）
+        int numWorkers{1};           // 并发推理数（模拟 NPU 核数）
+        int maxQueueDepth{64};       // 超过此队列深度时 runAsync 返回 -1
+        uint64_t inputSize{0};       // 输入大小（0 表示不校验）
+    };
+
+    ReplayInferenceBackend(const std::string& replayPath, const Options& options);
+    ~ReplayInferenceBackend() override;
+
+    std::string name() const override { return "replay:" + m_replayPath; }
+    uint64_t inputSize() const override { return m_options.inputSize; }
+    uint64_t outputSize() const override { return m_outputSize; }
+    const std::vector<OutputTensorDesc>& outputDescs() const override { return m_outputDescs; }
+
+    bool run(void* input, void* output) override;
+    // 固定输出第 0 帧，不推进回放位置
+    bool warmupRun(void* input, void* output) override;
+    int runAsync(void* input, void* userArg, void* output) override;
+    void setCallback(Callback callback) override;
+    double npuTimeUs() const override { return m_options.latencyUs; }
+
+    size_t frameCount() const { return m_frames.size(); }
+    // 第 index 帧输出数据（指向内部存储或映射区，零拷贝）
+    const uint8_t* frameData(size_t index) const { return m_frames[index]; }
+
+private:
+    struct Job
+    {
+        int jobId;
+        void* output;
+        void* userArg;
+    };
+
+    bool loadTensorDescs(const std::string& descPath);
+    bool loadFrames(const std::string& dir);
+    bool loadCapture(const std::string& capturePath);
+    void simulateLatency();
+    void copyNextFrame(void* output);
+    void workerLoop();
+
+    std::string m_replayPath;
+    Options m_options;
+    std::vector<OutputTensorDesc> m_outputDescs;
+    uint64_t m_outputSize;
+    std::vector<const uint8_t*> m_frames;
+    std::vector<std::vector<uint8_t>> m_frameStorage;                // 目录模式下的帧数据
+    std::unique_ptr<dxapp::common::CaptureReader> m_capture;        // .dxcap 模式下的映射文件
+    std::atomic<uint64_t> m_frameCursor;
+    std::atomic<int> m_nextJobId;
+
+    Callback m_callback;
+    std::mutex m_callbackMutex;
+
+    std::deque<Job> m_jobs;
+    std::mutex m_jobMutex;
+    std::condition_variable m_jobCv;
+    bool m_stopping;
+    std::vector<std::thread> m_workers;
+};
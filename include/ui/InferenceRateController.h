@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// 推理帧选择策略（按降级程度排列）
+enum class InferenceRateMode
+{
+    EveryFrame,    // 每帧推理（受在途帧数上限约束）
+    LatestOnly,    // 只在没有在途帧时提交最新帧，消除排队延迟
+    EveryNth       // 在 LatestOnly 基础上每 N 帧推理一次，进一步降低 NPU/CPU 负载
+};
+
+// 当前控制状态（供界面或日志显示）
+struct InferenceRateStatus
+{
+    InferenceRateMode mode = InferenceRateMode::EveryFrame;
+    int stride = 1;                // EveryNth 的 N
+    double latencyMs = 0;          // 提交 -> 结果可取，平滑后的均值
+    double npuTimeMs = 0;          // 后端报告的 NPU 推理时间
+    double budgetMs = 0;
+    int inFlight = 0;
+    uint64_t offered = 0;          // 送入控制器的帧数
+    uint64_t submitted = 0;        // 允许提交的帧数
+    uint64_t skipped = 0;          // 按策略跳过的帧数
+    bool degraded = false;         // 非 EveryFrame 或延迟超出预算
+    bool budgetUnattainable = false;   // 已不排队仍超预算（服务时间本身超出），降频无法改善
+};
+
+// 自适应推理速率控制：根据实测延迟和在途帧数选择推理哪些帧，使延迟保持在预算内
+// - 延迟超出预算时先降到 LatestOnly 消除排队；再往 EveryNth(2..maxStride) 降级只在仍有忙时跳帧
+//   （步长能减掉的负载）且排队延迟（延迟 - NPU 时间）超出预算时进行，否则延迟是服务时间，
+//   标记 budgetUnattainable 而不继续降频
+// - 延迟低于预算的 recoverRatio 时逐级恢复（滞回，避免在两档之间来回切换）；
+//   LatestOnly 区间内出现过忙时跳帧说明 NPU 跟不上帧率，不恢复到 EveryFrame（否则会重新排队）
+// - 每 adjustIntervalMs 最多调整一次，用区间内完成帧的平均延迟判断
+// shouldSubmit() 在取帧线程调用，update() 可在任意线程调用
+class InferenceRateController
+{
+public:
+    struct Config
+    {
+        double latencyBudgetMs = 100;
+        int maxInFlight = 1;           // 在途帧数上限（任何模式下都不超过）
+        int maxStride = 8;
+        double recoverRatio = 0.6;
+        int adjustIntervalMs = 500;
+        double smoothing = 0.3;        // 延迟指数平滑系数
+    };
+
+    InferenceRateController();
+    explicit InferenceRateController(const Config& config);
+
+    void setConfig(const Config& config);
+    Config config() const;
+    void reset();
+
+    // 每帧调用：返回该帧是否提交推理
+    bool shouldSubmit(int inFlight);
+    // 刷新测量值：completed/latencySumMs 为累计值（取差值得到区间均值），npuTimeMs <= 0 表示未知
+    // 返回 true 表示模式或 budgetUnattainable 发生了变化
+    bool update(uint64_t completed, double latencySumMs, double npuTimeMs);
+
+    InferenceRateStatus status() const;
+    static const char* modeName(InferenceRateMode mode);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // 降级等级：0 = EveryFrame，1 = LatestOnly，2.. = EveryNth(等级)
+    void applyLevel(int level);
+    int maxLevel() const { return m_config.maxStride > 1 ? m_config.maxStride : 1; }
+
+    mutable std::mutex m_mutex;
+    Config m_config;
+    InferenceRateStatus m_status;
+    int m_level;
+    uint64_t m_framesSinceSubmit;
+    uint64_t m_busySkips;              // 本调整区间内因有在途帧而跳过的帧数
+    uint64_t m_lastCompleted;
+    double m_lastLatencySumMs;
+    bool m_hasSample;
+    Clock::time_point m_lastAdjust;
+    Clock::time_point m_lastCompletion;
+};
@@ -15,6 +15,8 @@
 #include <QtCore/QElapsedTimer>
 #include "ui_MainWindow.h"
 #include "CameraController.h"
+#include "DetectionOverlay.h"
+#include "PreviewStage.h"
 #include "yolo/bbox.h"
 #include <vector>
 
@@ -52,7 +54,6 @@ private:
     
     // GraphicsView 相关
     void loadImageToGraphicsView(const QString& imagePath, int targetWidth = 300, int targetHeight = 500);
-    void drawDetectionsOnImage(cv::Mat& image, const std::vector<BoundingBox>& detections);
     QImage cvMatToQImage(const cv::Mat& mat);
 
 private:
@@ -60,14 +61,18 @@ private:
     CameraController* m_cameraController;
     QTimer* m_updateTimer;
     QPixmap m_currentImage;
+    // 显示阶段：按预览帧率缩放最新帧，与采集/推理解耦
+    PreviewStage m_previewStage;
     
     // GraphicsView 场景和元素
     QGraphicsScene* m_graphicsScene;
     QGraphicsPixmapItem* m_graphicsPixmapItem;
     
-    // FPS计算
+    // FPS计算：采集帧数、显示帧数分开统计，推理帧数取检测器的累计完成数
     QElapsedTimer m_fpsTimer;
     int m_frameCount;
+    int m_displayFrameCount;
+    uint64_t m_lastInferenceCompleted;
     double m_currentFPS;
     
     // YOLO 检测结果
@@ -77,9 +82,15 @@ private:
     bool m_yoloModelLoaded;
     QString m_currentModelPath;
     int m_currentModelIndex;
+    // 后台切换中的模型（加载完成后才替换当前模型）
+    QString m_pendingModelPath;
+    int m_pendingModelIndex;
+    QTimer* m_modelLoadTimer;
     
     // YOLO UI 控件
     QPushButton* m_loadModelButton;
     QPushButton* m_toggleYoloButton;
+    QPushButton* m_motionGateButton;
+    QPushButton* m_trackingButton;
     QLabel* m_yoloStatusLabel;
 };
\ No newline at end of file
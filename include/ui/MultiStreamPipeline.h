@@ -0,0 +1,223 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "yolo/yolo.h"
+#include "yolo/bbox.h"
+#include "yolo/motion_gate.h"
+#include "CameraAcquisition.h"
+#include "CameraProfile.h"
+#include "InferenceBackend.h"
+#include "VideoFileDecoder.h"
+#include "ImageSequenceReader.h"
+#include "SyntheticFrameGenerator.h"
+#include "V4l2Capture.h"
+
+class IVideoSource;
+
+// 单路视频流配置
+struct StreamSpec
+{
+    QString source;                // camera:<index>、v4l2:<device>、视频文件路径、图片序列（目录 / .txt/.lst 列表文件）或 synthetic:...
+    int weight = 1;                // 调度权重（各路均为 1 时即轮询）
+    CameraAcquisitionMode acquisition = CameraAcquisitionMode::Polling;
+    CameraProfileRequest profileRequest;
+    bool loop = true;              // 视频文件结束后从头播放
+    VideoDecoderOptions decoderOptions;   // 视频文件的预取解码设置（loop 以上面的字段为准）
+    ImageSequenceOptions sequenceOptions; // 图片序列的并行解码设置（loop 同上）
+    bool motionGate = false;       // 画面静止时不提交推理（沿用该路上次的检测结果）
+    MotionGateConfig motionGateConfig;
+};
+
+// 单路统计（区间或累计）
+struct StreamStats
+{
+    QString name;
+    uint64_t captured = 0;         // 取帧并完成预处理的帧数
+    uint64_t dropped = 0;          // 等待调度时被新帧替换的帧数（仅实时源）
+    uint64_t gated = 0;            // 运动门控判定静止而跳过的帧数
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t failures = 0;         // 取帧失败、推理提交失败或结果超时未返回
+    uint64_t detections = 0;
+    double waitSumMs = 0;          // 预处理完成 -> 提交推理
+    double latencySumMs = 0;       // 取到帧 -> 按帧序交付结果
+    double latencyMaxMs = 0;
+    bool ended = false;            // 视频文件已播放结束（不循环时）
+
+    void accumulate(const StreamStats& other);
+};
+
+// 多路流水线：N 路视频源共享一个推理后端（一份模型）
+// - 每路一个采集线程：取帧 + letterbox 预处理，结果放入该路的待调度槽（实时源只保留最新帧）
+// - 一个调度线程：按平滑加权轮询在有待调度帧的流之间选择，提交到共享后端
+// - 推理槽位数（maxInFlight）限制同时在 NPU 上的帧数，每个槽位有独立的输出 buffer 和 Yolo 后处理器，
+//   后端回调可以并发执行
+// - 批量模式（setBatching）：调度线程在时间窗口内从多路收集最多 batchSize 帧，
+//   由批量线程通过 IInferenceBackend::runBatch（DXRT 向量 Run）一次提交，结果按 Job 分发回各路
+class MultiStreamPipeline
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    // 检测结果回调，在推理后端回调线程（或跳过超时帧号后的调度线程）中调用；
+    // 同一路按帧号顺序调用，不同路可能并发，调用方自行加锁
+    // input 为该帧的来源标识（IVideoSource::getFrameName，图片序列为文件路径，其他源为空）
+    using ResultCallback = std::function<void(int stream, uint64_t frameId, const QString& input,
+                                              const std::vector<BoundingBox>& results, double latencyMs)>;
+
+    explicit MultiStreamPipeline(int maxInFlight = 4);
+    ~MultiStreamPipeline();
+
+    // 枚举到的全部相机，返回 camera:<index> 列表
+    static QStringList enumerateCameraSources();
+
+    // 共享推理后端和 YOLO 配置，须在 addStream() 之前调用
+    bool initialize(std::unique_ptr<IInferenceBackend> backend, const YoloParam& config);
+    // 打开视频源，返回流编号（失败返回 -1）；须在 start() 之前调用
+    int addStream(const StreamSpec& spec);
+    void setResultCallback(ResultCallback callback) { m_resultCallback = std::move(callback); }
+    // 批量提交：batchSize <= 1 为逐帧异步提交（默认）；须在 start() 之前调用
+    void setBatching(int batchSize, int windowUs);
+    int batchSize() const { return m_batchSize; }
+
+    bool start();
+    // 停止采集和调度，等待已提交的推理完成后关闭视频源
+    void stop();
+    bool isRunning() const { return m_running; }
+
+    int streamCount() const { return (int)m_streams.size(); }
+    QString streamName(int stream) const;
+    const YoloParam& config() const { return m_config; }
+    IInferenceBackend* backend() const { return m_backend.get(); }
+    // 相机流的 SDK/回调统计（非相机流返回 false）
+    bool cameraStats(int stream, CameraStreamStats& stats) const;
+    // 视频文件解码统计（相机源返回 false）
+    bool videoStats(int stream, VideoDecoderStats& stats) const;
+    // 图片序列解码统计（其他源返回 false）
+    bool imageSequenceStats(int stream, ImageSequenceStats& stats) const;
+    // 合成视频源统计（其他源返回 false）
+    bool syntheticStats(int stream, SyntheticStreamStats& stats) const;
+    // V4L2 采集统计（其他源返回 false）
+    bool v4l2Stats(int stream, V4l2CaptureStats& stats) const;
+
+    // 最新检测结果（frameId 从 1 开始，0 表示尚无结果）
+    bool getLatestResults(int stream, std::vector<BoundingBox>& results, uint64_t& frameId) const;
+
+    // 取出各流自上次调用以来的区间统计（同时累加到累计统计）
+    std::vector<StreamStats> takeIntervalStats();
+    std::vector<StreamStats> totalStats() const;
+    // 取出自上次调用以来提交的批数和帧数（批量模式）
+    void takeBatchStats(uint64_t& batches, uint64_t& frames);
+    // 所有流都已结束（只有不循环的视频文件会结束）
+    bool allEnded() const;
+
+private:
+    struct Job
+    {
+        int stream = 0;
+        uint64_t frameId = 0;
+        cv::Mat input;                    // 模型输入（letterbox 后的 RGB）
+        int originalWidth = 0;
+        int originalHeight = 0;
+        QString inputName;                // 来源标识（图片序列的文件路径）
+        Clock::time_point grabTime;
+        Clock::time_point readyTime;
+    };
+
+    // 已完成、等待按帧序交付的结果
+    struct Completed
+    {
+        bool ok = false;
+        std::vector<BoundingBox> results;
+        QString inputName;
+        Clock::time_point grabTime;
+    };
+    // 已提交的帧超过这么久仍未返回结果，跳过该帧号并计为失败
+    static constexpr int kReorderTimeoutMs = 1000;
+
+    struct Slot
+    {
+        std::vector<uint8_t> output;
+        std::unique_ptr<Yolo> yolo;       // Yolo 内部有逐帧缓冲，不能跨线程共享
+        std::unique_ptr<Job> job;
+    };
+
+    struct Stream
+    {
+        StreamSpec spec;
+        int index = 0;
+        QString name;
+        bool live = false;                // 实时源（相机、V4L2、限速的合成源）：调度跟不上时丢旧帧；文件/图片序列：等待调度
+        std::unique_ptr<IVideoSource> source;
+        std::thread worker;
+        MotionGate motionGate;            // 仅采集线程访问
+
+        // 以下由 m_mutex 保护
+        std::vector<std::unique_ptr<Job>> freeJobs;
+        std::unique_ptr<Job> ready;
+        uint64_t nextFrameId = 0;
+        int currentWeight = 0;            // 平滑加权轮询的当前值
+        StreamStats interval;
+        StreamStats total;
+        std::vector<BoundingBox> latestResults;
+        uint64_t latestFrameId = 0;
+        // 已提交、结果尚未进入重排缓冲的帧号 -> 提交时刻（提交时加入，交付时移除，两处都持有 m_mutex）
+        std::map<uint64_t, Clock::time_point> inFlight;
+
+        // 按帧序交付（由 deliverMutex 保护，回调也在该锁内调用以保证顺序）
+        // 缺失的帧号只有在提交后超时仍未返回时才跳过，迟到的结果直接丢弃；失败的帧以 ok=false 占住帧号
+        std::mutex deliverMutex;
+        std::map<uint64_t, Completed> pending;
+        uint64_t nextDeliverId = 1;
+    };
+
+    void captureLoop(Stream& stream);
+    void scheduleLoop();
+    void batchLoop();
+    // canSubmit/takeNext/pickStream 的调用方持有 m_mutex
+    bool canSubmit() const;
+    Slot* takeNext();
+    int pickStream();
+    void failSlot(Slot* slot);            // 提交失败：归还 Job 和槽位
+    void onInferenceComplete(void* output, Slot* slot);
+    void deliver(Stream& stream, uint64_t frameId, Completed completed);
+    // 从 nextDeliverId 起连续交付，跳过提交后超时未返回的帧号；调用方持有 stream.deliverMutex
+    void drainReorder(Stream& stream);
+    void checkReorderTimeouts();
+    void recycle(Stream& stream, std::unique_ptr<Job> job);
+
+    int m_maxInFlight;
+    YoloParam m_config;
+    std::unique_ptr<IInferenceBackend> m_backend;
+    std::vector<std::vector<int64_t>> m_outputShapes;
+    dxrt::DataType m_outputType;
+    std::vector<std::unique_ptr<Stream>> m_streams;
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    ResultCallback m_resultCallback;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::vector<Slot*> m_freeSlots;
+    int m_batchSize;
+    int m_batchWindowUs;
+    std::deque<std::vector<Slot*>> m_batchQueue;
+    uint64_t m_batchCount;
+    uint64_t m_batchedFrames;
+    std::atomic<bool> m_stopping;
+    bool m_batchStopping;
+    bool m_running;
+    std::thread m_scheduler;
+    std::vector<std::thread> m_batchWorkers;
+};
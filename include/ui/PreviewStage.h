@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QtCore/QSize>
+#include <opencv2/opencv.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// 预览阶段统计（累计值）
+struct PreviewStageStats
+{
+    uint64_t submitted = 0;        // 送入的采集帧
+    uint64_t rendered = 0;         // 缩放完成的预览帧
+    uint64_t superseded = 0;       // 还没缩放就被更新的帧替换（显示跟不上采集时的正常现象）
+    double scaleMs = 0;            // 最近一次缩放耗时
+};
+
+// 显示阶段：把预览和采集/推理解耦
+//
+// submit() 只替换“最新帧”引用并唤醒工作线程，不拷贝、不等待，采集和推理永远不会被显示拖慢。
+// 工作线程按预览帧率节拍取最新帧，用 INTER_AREA 缩放一次到视图尺寸（不放大，灰度帧缩放后再转 BGR），
+// 界面线程用 take() 取走已缩放好的预览帧，只在显示分辨率上叠加检测框和绘制。
+// 待处理帧引用着采集缓冲，最多占用一个（见 CameraFramePool::kDefaultPipelineDepth）。
+class PreviewStage
+{
+public:
+    PreviewStage();
+    ~PreviewStage();
+
+    void start();
+    void stop();
+
+    // 预览帧率，<= 0 表示不限速（有新帧就缩放）
+    void setPreviewFps(double fps);
+    double previewFps() const;
+    // 视图的像素尺寸（已乘 devicePixelRatio），空尺寸表示按原尺寸输出
+    void setViewSize(const QSize& size);
+
+    // 任意线程调用，不阻塞
+    void submit(const cv::Mat& frame);
+    // 取出最新的预览帧（BGR，所有权交给调用者），frameSize 为对应采集帧的尺寸；没有新预览帧时返回 false
+    bool take(cv::Mat& preview, cv::Size& frameSize);
+
+    // 丢弃待处理帧和未取走的预览帧，并等待正在缩放的帧释放（停止采集时释放采集缓冲）
+    void clear();
+
+    PreviewStageStats stats() const;
+
+    // 帧缩放到 viewSize 内的尺寸（保持 QLabel 拉伸显示的行为，不保持宽高比；帧比视图小时不放大）
+    static cv::Size displaySize(const cv::Size& frameSize, const QSize& viewSize);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void workerLoop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::condition_variable m_idle;    // 工作线程释放正在缩放的帧时通知 clear()
+    std::thread m_worker;
+    bool m_running;
+    bool m_busy;                   // 工作线程在锁外持有采集帧
+
+    cv::Mat m_pending;             // 最新的未缩放采集帧
+    cv::Mat m_ready;               // 最新的已缩放预览帧
+    uint64_t m_generation;         // clear() 后递增，丢弃清空前开始缩放的帧
+    cv::Size m_readyFrameSize;
+    QSize m_viewSize;
+    double m_previewFps;
+    Clock::time_point m_nextSlot;
+
+    PreviewStageStats m_stats;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// 合成帧的像素格式（与相机输出对应：Mono8/BGR8 零拷贝交付，Bayer 在取帧时插值为 BGR）
+enum class SyntheticPixelFormat
+{
+    Mono8,
+    BayerRG8,
+    BGR8
+};
+
+// 合成视频源配置，源字符串格式：
+//   synthetic:[WxH][@fps][,mono8|bayer|bgr8][,objects=N][,pool=N][,seed=N]
+// 例：synthetic:2448x2048@25,bayer,objects=8
+struct SyntheticSourceConfig
+{
+    int width = 1920;
+    int height = 1080;
+    double fps = 30;               // 0 表示不限速（取帧方有多快就输出多快）
+    SyntheticPixelFormat format = SyntheticPixelFormat::BGR8;
+    int objects = 4;               // 运动矩形数量
+    int poolSize = 0;              // 预渲染帧数（循环使用），0 表示按 kDefaultPoolBytes 自动选择
+    uint32_t seed = 1;             // 相同配置和种子生成的帧序列完全相同
+
+    // 自动选择帧数时池的内存上限（1080p BGR 约 10 帧，Mono8/Bayer 约 32 帧）
+    static constexpr size_t kDefaultPoolBytes = 64 * 1024 * 1024;
+    static constexpr int kMinPoolFrames = 8;
+    static constexpr int kMaxPoolFrames = 64;
+
+    static bool isSyntheticSource(const QString& source) { return source.startsWith("synthetic:"); }
+    // 解析失败时返回 false，error 为原因
+    static bool parse(const QString& source, SyntheticSourceConfig& config, QString* error = nullptr);
+    QString toString() const;
+    const char* formatName() const;
+    size_t frameBytes() const;
+    // 实际预渲染的帧数（poolSize 为 0 时按内存上限计算）
+    int effectivePoolSize() const;
+};
+
+// 合成视频源统计（累计值）
+struct SyntheticStreamStats
+{
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;          // 取帧方跟不上帧率而跳过的帧
+    int poolFrames = 0;
+    size_t poolBytes = 0;
+};
+
+// 预渲染帧池：打开时按配置一次性渲染 poolSize 帧，取帧只按帧号取池中的 Mat（生成开销可忽略）
+// - 运动矩形沿闭合的 Lissajous 轨迹运动，周期等于池长度，循环播放时没有跳变
+// - 背景带固定纹理，避免整帧纯色使缩放/运动门控的开销失真
+// 多路使用相同配置时共享同一个池，见 acquire()。池帧的内存渲染后设为只读页：
+// 取帧方拿到的是池内存的浅引用，写入会改掉所有路后续循环的帧，现在会直接触发访问异常；需要修改时先 clone()
+class SyntheticFramePool
+{
+public:
+    static std::shared_ptr<const SyntheticFramePool> acquire(const SyntheticSourceConfig& config);
+
+    explicit SyntheticFramePool(const SyntheticSourceConfig& config);
+
+    const cv::Mat& frame(uint64_t frameNumber) const { return m_frames[frameNumber % m_frames.size()]; }
+    int size() const { return (int)m_frames.size(); }
+    size_t bytes() const;
+
+private:
+    class ReadOnlyAllocator;
+
+    void render(const SyntheticSourceConfig& config);
+    static cv::Mat toBayerRG(const cv::Mat& bgr);
+    // 拷贝到按页分配的内存并设为只读，分配失败时退回普通内存
+    static cv::Mat toReadOnly(const cv::Mat& frame);
+    static const ReadOnlyAllocator& allocator();
+
+    std::vector<cv::Mat> m_frames;
+};
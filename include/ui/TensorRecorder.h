@@ -0,0 +1,64 @@
+#pragma once
+
+#include "InferenceBackend.h"
+#include <utils/capture_file.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 输出张量录制器：把每帧 NPU 输出追加写入 .dxcap 内存映射文件（格式见 utils/capture_file.hpp）
+// record() 只把数据拷贝到预分配的槽位并入队，写文件在后台线程完成；
+// 槽位用尽时丢弃该帧并计数，保证录制不会阻塞推理回调。
+class TensorRecorder
+{
+public:
+    TensorRecorder();
+    ~TensorRecorder();
+
+    bool start(const std::string& path,
+               const std::string& modelName,
+               const std::vector<OutputTensorDesc>& descs,
+               uint64_t outputSize,
+               int poolSize = 16);
+    void stop();
+    bool isRecording() const { return m_recording.load(std::memory_order_acquire); }
+
+    // 线程安全，可在推理回调线程中调用
+    bool record(uint64_t frameId, const std::string& inputRef,
+                int inputWidth, int inputHeight, const void* output);
+
+    uint64_t recordedCount() const { return m_recorded.load(); }
+    uint64_t droppedCount() const { return m_dropped.load(); }
+    const std::string& path() const { return m_path; }
+
+private:
+    struct Pending
+    {
+        int slot;
+        dxapp::common::CaptureRecordHeader header;
+    };
+
+    void writerLoop();
+
+    std::string m_path;
+    uint64_t m_outputSize;
+    dxapp::common::CaptureWriter m_writer;
+
+    std::vector<std::vector<uint8_t>> m_slots;
+    std::vector<int> m_freeSlots;
+    std::deque<Pending> m_pending;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_copyDone;
+    std::thread m_thread;
+    bool m_stopping;
+    int m_copying;                 // 已取得槽位、尚未入队的 record() 数（由 m_mutex 保护）
+
+    std::atomic<bool> m_recording;
+    std::atomic<uint64_t> m_recorded;
+    std::atomic<uint64_t> m_dropped;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QtCore/QString>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// V4L2 采集配置，源字符串格式：
+//   v4l2:<device>[,WxH][,fmt=<fourcc>][,buffers=N][,dmabuf]
+// 例：v4l2:/dev/video0,1280x720,fmt=YUYV,buffers=6
+struct V4l2CaptureOptions
+{
+    std::string device = "/dev/video0";
+    int width = 640;
+    int height = 480;
+    std::string pixelFormat = "BGR3";  // V4L2 fourcc：BGR3/GREY 零拷贝，RGB3/YUYV/UYVY/NV12 转换为 BGR
+    int bufferCount = 0;               // 0 = kDriverBuffers + kDefaultPipelineDepth
+    bool exportDmabuf = false;         // VIDIOC_EXPBUF 导出每个缓冲的 dmabuf fd
+    int timeoutMs = 1000;              // poll() 等待一帧的上限
+
+    static bool isV4l2Source(const QString& source) { return source.startsWith("v4l2:"); }
+    static bool parse(const QString& source, V4l2CaptureOptions& options, QString* error = nullptr);
+    QString toString() const;
+};
+
+// 采集统计（累计值）
+struct V4l2CaptureStats
+{
+    uint64_t captured = 0;
+    uint64_t zeroCopy = 0;             // 直接引用 mmap 缓冲交付的帧
+    uint64_t converted = 0;            // 转换到自有内存后立即归还缓冲的帧
+    uint64_t timeouts = 0;             // poll() 超时（驱动没有可用缓冲时也会超时）
+    int outstanding = 0;               // 仍被使用者持有的缓冲
+    int bufferCount = 0;
+};
+
+// V4L2 多缓冲零拷贝采集
+//
+// 申请 bufferCount 个 MMAP 缓冲并全部入队，grab() 用 poll() 等待后 DQBUF 取出驱动填好的缓冲。
+// BGR3/GREY 格式返回直接指向 mmap 缓冲的 cv::Mat（与 CameraFramePool 相同的方式挂引用计数），
+// 所有浅拷贝都释放后才 QBUF 归还驱动；其他格式转换为 BGR 后立即归还。
+// 使用者持有的帧占用驱动缓冲，缓冲全部被持有时 grab() 超时，缓冲数应覆盖流水线深度。
+//
+// close() 停止采集后，仍被持有的帧继续有效：mmap 和设备 fd 在最后一帧释放后才解除/关闭；
+// 没有被持有的帧时 close() 立即解除映射并关闭 fd。open() 失败时同样撤销已完成的步骤。
+// 仅 Linux 可用，其他平台 open() 返回 false。
+class V4l2Capture : public std::enable_shared_from_this<V4l2Capture>
+{
+public:
+    // 驱动侧保留的缓冲数（在流水线持有的帧之外）
+    static constexpr int kDriverBuffers = 3;
+    static constexpr int kDefaultPipelineDepth = 3;
+
+    static std::shared_ptr<V4l2Capture> create(const V4l2CaptureOptions& options);
+    ~V4l2Capture();
+
+    bool open(QString* error = nullptr);
+    void close();
+    bool isOpened() const { return m_streaming.load(); }
+
+    // 取一帧，超时或失败返回空 Mat
+    cv::Mat grab();
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    V4l2CaptureStats stats() const;
+
+    // 帧所在缓冲导出的 dmabuf fd（未开启 exportDmabuf 或不是零拷贝帧时返回 -1），
+    // 可交给显示或其他设备直接导入；fd 归本对象所有，不要关闭
+    static int dmabufFd(const cv::Mat& frame);
+    static bool isBufferFrame(const cv::Mat& frame);
+
+private:
+    class BufferAllocator;
+    struct BufferRef;
+
+    struct Buffer
+    {
+        void* data = nullptr;
+        size_t length = 0;
+        int dmabufFd = -1;
+    };
+
+    explicit V4l2Capture(const V4l2CaptureOptions& options);
+    bool configure(QString* error);
+    bool mapBuffers(QString* error);
+    void unmapBuffers();
+    // 解除映射、释放驱动缓冲并关闭 fd（调用方保证没有帧引用 mmap 缓冲）
+    void releaseDevice();
+    void requeue(int index);
+    cv::Mat wrap(int index, size_t bytesUsed);
+
+    static const BufferAllocator& allocator();
+
+    V4l2CaptureOptions m_options;
+    int m_fd;
+    uint32_t m_fourcc;
+    int m_width;
+    int m_height;
+    int m_bytesPerLine;
+    std::vector<Buffer> m_buffers;
+
+    std::mutex m_mutex;                // 串行化 QBUF、STREAMOFF 和 close 后的设备释放（释放帧可能在任意线程）
+    std::atomic<bool> m_streaming;
+    std::atomic<int> m_outstanding;
+    std::atomic<uint64_t> m_captured;
+    std::atomic<uint64_t> m_zeroCopy;
+    std::atomic<uint64_t> m_converted;
+    std::atomic<uint64_t> m_timeouts;
+};
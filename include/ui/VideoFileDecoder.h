@@ -0,0 +1,110 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 视频文件的输出节奏
+enum class VideoPacing
+{
+    Unpaced,     // 尽快输出（吞吐测试，按顺序逐帧交付，不丢帧）
+    RealTime     // 按文件帧率输出（模拟实时视频源，取帧方跟不上时丢弃过期帧）
+};
+
+struct VideoDecoderOptions
+{
+    int queueCapacity = 8;           // 预解码帧队列长度
+    int decodeThreads = -1;          // FFmpeg 解码线程数（-1 使用后端默认值，0 使用全部核心）
+    VideoPacing pacing = VideoPacing::Unpaced;
+    bool loop = true;                // 播放结束后从头播放
+};
+
+// 解码统计（累计值）
+struct VideoDecoderStats
+{
+    uint64_t decoded = 0;            // 解码线程输出的帧数
+    uint64_t delivered = 0;          // 被取走的帧数
+    uint64_t skipped = 0;            // 实时模式下取帧方跟不上而丢弃的过期帧
+    uint64_t starved = 0;            // 取帧时队列为空（解码跟不上）的次数
+    uint64_t loops = 0;
+    int queued = 0;
+    double decodeFps = 0;            // 解码速率（只计解码耗时，不含等待队列空位），与流水线帧率无关
+};
+
+// 预取解码：解码线程提前把帧解码到有界队列，取帧方只做出队。
+// 循环播放不在当前解码器上 seek：队列满、解码线程空闲时预先打开第二个解码器，
+// 到达文件末尾时直接切换，下一轮的首帧无需等待 seek 和关键帧定位。
+class VideoFileDecoder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    VideoFileDecoder(const std::string& path, const VideoDecoderOptions& options);
+    ~VideoFileDecoder();
+
+    // 打开文件并启动解码线程
+    bool open();
+    void close();
+    bool isOpened() const { return m_capture && m_capture->isOpened(); }
+
+    // 取下一帧，最多等待 timeoutMs；实时模式下还会等待到该帧的播放时刻
+    // 非循环播放且已全部取完时立即返回 false
+    bool take(cv::Mat& outFrame, int timeoutMs);
+    bool finished() const;
+
+    void setLoop(bool loop) { m_loop = loop; }
+    // 跳转到指定帧（重启解码线程，队列中的帧丢弃）
+    void seek(int frameIndex);
+
+    double fps() const { return m_fps; }
+    int totalFrames() const { return m_totalFrames; }
+    int position() const;                // 最近取走的帧在文件中的序号
+    VideoDecoderStats stats() const;
+
+private:
+    struct Entry
+    {
+        cv::Mat image;
+        int index;
+    };
+
+    bool openCapture(cv::VideoCapture& capture) const;
+    void start(int frameIndex);
+    void stop();
+    void decodeLoop(int frameIndex);
+
+    std::string m_path;
+    VideoDecoderOptions m_options;
+    std::atomic<bool> m_loop;
+    double m_fps;
+    int m_totalFrames;
+
+    // 解码器只在解码线程中访问（线程停止时除外）
+    std::unique_ptr<cv::VideoCapture> m_capture;
+    std::unique_ptr<cv::VideoCapture> m_standby;
+    std::thread m_thread;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<Entry> m_queue;
+    bool m_stopping;
+    bool m_endOfFile;                    // 非循环播放时解码到末尾
+    int m_position;
+    Clock::time_point m_nextDue;         // 实时模式下一帧的播放时刻
+    bool m_paceStarted;
+
+    uint64_t m_decoded;
+    uint64_t m_delivered;
+    uint64_t m_skipped;
+    uint64_t m_starved;
+    uint64_t m_loops;
+    double m_decodeBusySec;
+};
@@ -3,12 +3,26 @@
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <opencv2/opencv.hpp>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include "CameraAcquisition.h"
+#include "CameraProfile.h"
+#include "VideoFileDecoder.h"
+#include "ImageSequenceReader.h"
+#include "SyntheticFrameGenerator.h"
+#include "V4l2Capture.h"
+
+class CameraFramePool;
 
 // 视频源类型枚举
 enum class VideoSourceType
 {
-    Camera,      // 大华工业相机
-    VideoFile    // MP4/AVI 等视频文件
+    Camera,        // 大华工业相机
+    VideoFile,     // MP4/AVI 等视频文件
+    ImageSequence, // 图片目录或列表文件（离线批量评估）
+    Synthetic,     // 合成负载（无相机时的硬件选型和压力测试）
+    V4l2           // 嵌入式 Linux 板卡上的 V4L2 采集设备
 };
 
 // 视频源抽象基类
@@ -27,6 +41,8 @@ public:
     virtual bool grabFrame(cv::Mat& outFrame) = 0;
     virtual QString getSourceName() const = 0;
     virtual VideoSourceType getType() const = 0;
+    // 最近一帧的来源标识（图片序列为文件路径），其他源返回空
+    virtual QString getFrameName() const { return QString(); }
 
 signals:
     void statusChanged(const QString& message);
@@ -42,22 +58,35 @@ public:
     explicit CameraVideoSource(int deviceIndex, QObject* parent = nullptr);
     ~CameraVideoSource() override;
 
+    // 在 open() 之前设置，默认轮询模式（零拷贝）
+    void setAcquisitionMode(CameraAcquisitionMode mode) { m_acquisitionMode = mode; }
+    CameraAcquisitionMode getAcquisitionMode() const { return m_acquisitionMode; }
+    CameraStreamStats getStreamStats() const;
+
+    // 在 open() 之前设置：打开设备后、开始采集前按请求配置 ROI/合并/像素格式
+    void setProfileRequest(const CameraProfileRequest& request) { m_profileRequest = request; }
+
     bool open() override;
     void close() override;
     bool isOpened() const override { return m_isConnected; }
+    // 输出的 Mat 直接引用 SDK 缓冲（Mono8/BGR8 零拷贝），释放后归还 SDK，见 CameraFramePool
     bool grabFrame(cv::Mat& outFrame) override;
     QString getSourceName() const override;
     VideoSourceType getType() const override { return VideoSourceType::Camera; }
 
 private:
     void* m_deviceHandle;  // IMV_HANDLE
+    std::shared_ptr<CameraFramePool> m_framePool;
+    CameraAcquisitionMode m_acquisitionMode;
+    std::unique_ptr<CameraCallbackGrabber> m_callbackGrabber;
+    CameraProfileRequest m_profileRequest;
     int m_deviceIndex;
     bool m_isConnected;
     bool m_isCapturing;
     QString m_deviceName;
 };
 
-// 视频文件源
+// 视频文件源（解码在 VideoFileDecoder 的解码线程中预取）
 class VideoFileSource : public IVideoSource
 {
     Q_OBJECT
@@ -66,9 +95,14 @@ public:
     explicit VideoFileSource(const QString& filePath, QObject* parent = nullptr);
     ~VideoFileSource() override;
 
+    // 在 open() 之前设置：队列长度、解码线程数和输出节奏
+    void setDecoderOptions(const VideoDecoderOptions& options);
+    VideoDecoderStats getDecoderStats() const;
+
     bool open() override;
     void close() override;
     bool isOpened() const override;
+    // 从预解码队列取下一帧；非循环播放结束或解码超时返回 false
     bool grabFrame(cv::Mat& outFrame) override;
     QString getSourceName() const override { return m_filePath; }
     VideoSourceType getType() const override { return VideoSourceType::VideoFile; }
@@ -78,12 +112,108 @@ public:
     int getCurrentFramePos() const;
     double getFPS() const;
     void setFramePos(int pos);
-    void setLoop(bool loop) { m_loop = loop; }
+    void setLoop(bool loop);
 
 private:
+    // 取帧等待解码的上限
+    static constexpr int kGrabTimeoutMs = 2000;
+
     QString m_filePath;
-    cv::VideoCapture m_capture;
-    bool m_loop;  // 是否循环播放
+    VideoDecoderOptions m_decoderOptions;   // 含是否循环播放
+    std::unique_ptr<VideoFileDecoder> m_decoder;
+};
+
+// 图片序列源：目录（按文件名自然排序）或列表文件，线程池并行解码，按文件顺序输出
+class ImageSequenceSource : public IVideoSource
+{
+    Q_OBJECT
+
+public:
+    explicit ImageSequenceSource(const QString& path, QObject* parent = nullptr);
+    ~ImageSequenceSource() override;
+
+    // 在 open() 之前设置：解码线程数、队列长度和是否循环
+    void setSequenceOptions(const ImageSequenceOptions& options) { m_options = options; }
+    ImageSequenceStats getSequenceStats() const;
+
+    bool open() override;
+    void close() override;
+    bool isOpened() const override { return m_reader != nullptr; }
+    // 按文件顺序取下一张；无法解码的文件跳过，非循环时全部取完返回 false
+    bool grabFrame(cv::Mat& outFrame) override;
+    QString getSourceName() const override { return m_path; }
+    VideoSourceType getType() const override { return VideoSourceType::ImageSequence; }
+    QString getFrameName() const override { return m_currentFile; }
+
+    int getTotalFrames() const { return m_reader ? m_reader->count() : 0; }
+
+private:
+    // 取帧等待解码的上限
+    static constexpr int kGrabTimeoutMs = 2000;
+
+    QString m_path;
+    ImageSequenceOptions m_options;
+    std::unique_ptr<ImageSequenceReader> m_reader;
+    QString m_currentFile;
+};
+
+// 合成视频源：按配置的分辨率、像素格式和帧率从预渲染帧池输出，帧序列由配置和种子完全确定
+// - 限速时按帧率等待，取帧方跟不上时像相机一样跳过过期帧（帧号按时间推进，计为丢帧）
+// - Mono8/BGR8 直接引用池中的 Mat（只读页，写入会触发访问异常，需要修改时先 clone）；
+//   Bayer 在取帧时插值为 BGR（与相机主机端转换的开销相同）
+class SyntheticVideoSource : public IVideoSource
+{
+    Q_OBJECT
+
+public:
+    explicit SyntheticVideoSource(const SyntheticSourceConfig& config, QObject* parent = nullptr);
+    ~SyntheticVideoSource() override;
+
+    SyntheticStreamStats getStats() const;
+    const SyntheticSourceConfig& getConfig() const { return m_config; }
+
+    bool open() override;
+    void close() override;
+    bool isOpened() const override { return m_pool != nullptr; }
+    bool grabFrame(cv::Mat& outFrame) override;
+    QString getSourceName() const override { return m_config.toString(); }
+    VideoSourceType getType() const override { return VideoSourceType::Synthetic; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    SyntheticSourceConfig m_config;
+    std::shared_ptr<const SyntheticFramePool> m_pool;
+    Clock::time_point m_startTime;
+    uint64_t m_frameNumber;
+    std::atomic<uint64_t> m_delivered;
+    std::atomic<uint64_t> m_dropped;
+};
+
+// V4L2 视频源：多缓冲 mmap 采集，BGR3/GREY 零拷贝交付（帧释放后缓冲归还驱动），见 V4l2Capture
+class V4l2VideoSource : public IVideoSource
+{
+    Q_OBJECT
+
+public:
+    explicit V4l2VideoSource(const V4l2CaptureOptions& options, QObject* parent = nullptr);
+    ~V4l2VideoSource() override;
+
+    V4l2CaptureStats getStats() const;
+
+    // 重新打开前，上次打开期间取出的帧必须全部释放：仍被持有的帧让旧的 fd 保留着驱动缓冲，
+    // 新 fd 的 VIDIOC_REQBUFS 会返回 EBUSY，open() 失败
+    bool open() override;
+    void close() override;
+    bool isOpened() const override { return m_capture && m_capture->isOpened(); }
+    // 输出的 Mat 可能直接引用驱动缓冲，长时间持有会占用缓冲（缓冲全部被持有时取帧超时）
+    bool grabFrame(cv::Mat& outFrame) override;
+    QString getSourceName() const override { return m_options.toString(); }
+    VideoSourceType getType() const override { return VideoSourceType::V4l2; }
+
+private:
+    V4l2CaptureOptions m_options;
+    std::shared_ptr<V4l2Capture> m_capture;
 };
 
 // 视频源管理器
@@ -103,8 +233,12 @@ public:
     VideoSourceType getCurrentType() const;
     
     // 快捷方法
-    bool openCamera(int deviceIndex);
-    bool openVideoFile(const QString& filePath);
+    bool openCamera(int deviceIndex, CameraAcquisitionMode mode = CameraAcquisitionMode::Polling,
+                    const CameraProfileRequest& profileRequest = CameraProfileRequest());
+    bool openVideoFile(const QString& filePath, const VideoDecoderOptions& decoderOptions = VideoDecoderOptions());
+    bool openImageSequence(const QString& path, const ImageSequenceOptions& options = ImageSequenceOptions());
+    bool openSynthetic(const SyntheticSourceConfig& config);
+    bool openV4l2(const V4l2CaptureOptions& options);
     void closeSource();
     
     bool grabFrame(cv::Mat& outFrame);
@@ -13,10 +13,23 @@
 
 #include "yolo/yolo.h"
 #include "yolo/bbox.h"
+#include "InferenceBackend.h"
+#include "TensorRecorder.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 // 前向声明
 class YoloDetector;
 
+// 模型加载时的预热统计
+struct WarmupReport
+{
+    int runs = 0;
+    double coldMs = 0;      // 第一次完整处理（预处理 + 推理 + 后处理）
+    double warmMs = 0;      // 其余各次的平均
+};
+
 class YoloDetector : public QObject
 {
     Q_OBJECT
@@ -25,26 +38,78 @@ public:
     explicit YoloDetector(QObject* parent = nullptr);
     ~YoloDetector();
 
-    // 初始化模型
+    // 初始化模型（在调用线程中加载；已有模型时同样在帧边界切换，加载期间旧模型继续推理）
     bool initializeModel(const QString& modelPath, int parameterIndex = 2);
     
+    // 使用外部提供的推理后端初始化（如回放后端，无需 NPU）
+    bool initializeWithBackend(std::unique_ptr<IInferenceBackend> backend, int parameterIndex = 2);
+    
+    // 后台加载模型（热切换）：在工作线程中创建引擎、后处理器和推理槽位并完成预热，
+    // 然后在帧边界切换，旧模型的在途帧照常完成后再释放旧引擎；加载期间检测不中断
+    // 已有加载在进行时返回 false；结果由 takeModelLoadResult() 轮询
+    enum class ModelLoadState { Idle, Loading, Succeeded, Failed };
+    bool loadModelAsync(const QString& modelPath, int parameterIndex = 2);
+    // 返回后台加载状态，Succeeded / Failed 只返回一次（随后回到 Idle）
+    ModelLoadState takeModelLoadResult();
+    
+    // 当前推理后端（未初始化时为 nullptr；切换模型后旧指针失效）
+    IInferenceBackend* getBackend() const { return m_model ? m_model->backend.get() : nullptr; }
+    
     // 检查是否已初始化
     bool isInitialized() const { return m_initialized; }
     
+    // 预热设置（在 initializeModel / initializeWithBackend 之前调用）
+    // 加载后用虚拟帧跑 runs 次完整的预处理、推理和后处理（至少覆盖每个推理槽位一次），
+    // 使后端内部 buffer、预处理临时图像和后处理容器在加载阶段分配好；runs 为 0 时只预留容器
+    // inputSize: 虚拟帧尺寸（应与实际视频源一致，letterbox 缩放的中间图像按此分配），为空时使用模型输入尺寸
+    void setWarmup(int runs, const cv::Size& inputSize = cv::Size());
+    WarmupReport getWarmupReport() const { return m_warmupReport; }
+    
     // 同步推理（单线程版本 - 已弃用）
     std::vector<BoundingBox> detectSync(const cv::Mat& image);
     
     // 异步推理（多线程版本 - 推荐使用）
-    bool detectAsync(const cv::Mat& image);
+    // 每个在途帧占用一个推理槽位（独立的输入/输出 buffer），槽位用尽时返回 false，不覆盖在途帧
+    // inputRef: 输入帧引用（源名称/帧号），仅在录制输出张量时写入录制文件
+    bool detectAsync(const cv::Mat& image, const QString& inputRef = QString());
+    
+    // 异步推理统计（线程安全）
+    int getInFlightCount() const { return m_inFlight.load(); }
+    int getMaxInFlight() const { return kAsyncSlots; }
+    // 累计完成帧数和累计延迟（detectAsync 调用 -> 结果可取，含预处理、排队、推理和后处理）
+    void getAsyncTiming(uint64_t& completed, double& latencySumMs) const;
+    // 后端报告的最近 NPU 推理时间（毫秒），未知时返回 0
+    double getNpuTimeMs() const;
     
     // 获取最新检测结果（线程安全）
     std::vector<BoundingBox> getLatestResults();
     
+    // 最新结果对应的帧号（按 detectAsync 提交顺序从 1 开始，0 表示尚无结果）
+    uint64_t getLatestResultFrameId();
+    
+    // 最新结果连同帧号和该帧的提交时间（跟踪器按帧时间而不是结果到达时间更新）
+    std::vector<BoundingBox> getLatestResults(uint64_t& frameId, std::chrono::steady_clock::time_point& submitTime);
+    // 最近一次 detectAsync 分配的帧号
+    uint64_t getSubmittedFrameId() const { return m_frameCounter.load(); }
+    
     // 获取配置信息
-    YoloParam getConfig() const { return m_config; }
+    YoloParam getConfig() const { QMutexLocker locker(&m_mutex); return m_config; }
     int getImageWidth() const { return m_config.width; }
     int getImageHeight() const { return m_config.height; }
     int getNumClasses() const { return m_config.numClasses; }
+    
+    // 按参数索引取预置 YOLO 配置（与 initializeModel 的 parameterIndex 一致）
+    static bool getParameterConfig(int parameterIndex, YoloParam& config);
+    
+    // 坐标缩放（从模型输入尺寸映射回原始图像，对应 PreProc 的 letterbox）
+    static void scaleCoordinates(std::vector<BoundingBox>& boxes,
+                                 int srcWidth, int srcHeight,
+                                 int npuWidth, int npuHeight);
+    
+    // 输出张量录制（.dxcap 文件，供离线调参和回放）
+    bool startRecording(const QString& path);
+    void stopRecording();
+    bool isRecording() const { return m_recorder->isRecording(); }
 
 signals:
     // 改为无参数信号，避免Qt信号系统传递大型数据导致QRingBuffer溢出
@@ -53,6 +118,9 @@ signals:
     void errorOccurred(const QString& error);
 
 private:
+    // 校验参数索引并复制配置
+    bool loadConfig(int parameterIndex, YoloParam& config);
+    
     // 预处理图像
     cv::Mat preprocessImage(const cv::Mat& image);
     
@@ -63,38 +131,103 @@ private:
                                         int originalWidth,
                                         int originalHeight);
     
-    // 坐标缩放（从模型输入尺寸映射回原始图像）
-    void scaleCoordinates(std::vector<BoundingBox>& boxes,
-                         int srcWidth, int srcHeight,
-                         int dstWidth, int dstHeight);
-    
     // 后处理回调（静态函数，供 DXRT 调用）
     static int postProcessCallback(std::vector<std::shared_ptr<dxrt::Tensor>> outputs, void* arg);
     
-    // 后处理实现（从 buffer 进行）
-    void postProcessFromBuffer(void* outputData, int outputLength);
+    using Clock = std::chrono::steady_clock;
+    struct ModelState;
+
+    // 异步推理槽位：在途帧独占输入/输出 buffer 和帧信息，新帧不会覆盖尚未完成的推理
+    struct AsyncSlot
+    {
+        ModelState* model = nullptr;     // 所属模型（后处理按提交时的模型进行）
+        cv::Mat input;
+        std::vector<uint8_t> output;
+        uint64_t frameId = 0;
+        int originalWidth = 0;
+        int originalHeight = 0;
+        std::string inputRef;
+        Clock::time_point submitTime;
+        bool busy = false;               // 由 m_mutex 保护
+    };
+    static constexpr int kAsyncSlots = 3;
+    // 每类候选框和最终结果的预留容量（不超过模型的 numBoxes）
+    static constexpr size_t kReservedCandidates = 1024;
+    // 切换模型时等待旧模型在途帧完成的上限
+    static constexpr int kDrainTimeoutMs = 5000;
+
+    // 一个模型的全部推理资源：后端、后处理器和推理槽位，加载和切换以此为单位
+    struct ModelState
+    {
+        std::unique_ptr<IInferenceBackend> backend;
+        YoloParam config;
+        std::unique_ptr<Yolo> yolo;
+        // 输出张量 shape 和数据类型（初始化时缓存）
+        std::vector<std::vector<int64_t>> outputShapes;
+        dxrt::DataType outputType = dxrt::DataType::NONE_TYPE;
+        std::vector<std::unique_ptr<AsyncSlot>> asyncSlots;
+        WarmupReport warmupReport;
+        size_t reservedResults = 0;
+    };
+    
+    // 创建模型（读取配置、创建 DXRT 后端），失败返回 nullptr；不访问当前模型，可在工作线程调用
+    std::unique_ptr<ModelState> loadModel(const QString& modelPath, int parameterIndex);
+    // 接管后端并完成层重排序、槽位分配、预热和回调注册
+    std::unique_ptr<ModelState> buildModel(std::unique_ptr<IInferenceBackend> backend, const YoloParam& config);
+    // 预留逐帧容器并执行预热（模型生效之前调用）
+    void warmup(ModelState& model, int warmupRuns, const cv::Size& inputSize);
+    // 在帧边界切换到新模型，等待旧模型的在途帧完成后释放旧模型
+    void activateModel(std::unique_ptr<ModelState> model);
+    // 等待在途帧完成后释放模型；超时则暂存到 m_retiredModels，之后再尝试释放，绝不释放仍有在途帧的模型
+    void retireModel(std::unique_ptr<ModelState> model);
+    // 等待模型的全部槽位空闲，超时返回 false
+    bool drainModel(ModelState& model);
+    int busySlots(const ModelState& model) const;  // 调用方持有 m_mutex
+    
+    // 后处理实现（从槽位的输出 buffer 进行）；回调在其返回后释放槽位
+    void postProcessFromBuffer(AsyncSlot* slot);
+    void releaseSlot(AsyncSlot* slot);
 
 private:
-    bool m_initialized;
-    QMutex m_mutex;
+    std::atomic<bool> m_initialized;
+    mutable QMutex m_mutex;
     QMutex m_resultMutex;  // 保护检测结果的独立锁
+    QMutex m_postMutex;    // Yolo 内部有逐帧缓冲，多个回调线程的后处理串行执行
     
-    // DXRT 推理引擎
-    std::unique_ptr<dxrt::InferenceEngine> m_inferenceEngine;
+    // 当前模型（推理后端 DXRT 或回放、后处理器、推理槽位），由 m_mutex 保护切换
+    std::unique_ptr<ModelState> m_model;
+    // 等待在途帧超时的旧模型（由 m_mutex 保护）
+    std::vector<std::unique_ptr<ModelState>> m_retiredModels;
+    YoloParam m_config;              // 当前模型的配置
     
-    // YOLO 配置和处理器
-    YoloParam m_config;
-    std::unique_ptr<Yolo> m_yolo;
+    // 后台加载
+    std::thread m_loaderThread;
+    QMutex m_loadMutex;
+    ModelLoadState m_modelLoadState;  // 由 m_loadMutex 保护
     
-    // 缓冲区
+    // 缓冲区（同步推理使用；异步推理使用模型的槽位）
     cv::Mat m_preprocessedImage;
     std::vector<uint8_t> m_outputBuffer;
     std::vector<BoundingBox> m_latestResults;
     
-    // 保存输出张量（延长生命周期）
-    dxrt::Tensors m_outputTensors;
-    
     // 保存原始图像尺寸（用于坐标缩放）
     int m_currentOriginalWidth;
     int m_currentOriginalHeight;
+    
+    // 预热
+    int m_warmupRuns;
+    cv::Size m_warmupInputSize;
+    WarmupReport m_warmupReport;
+    
+    // 输出张量录制
+    std::unique_ptr<TensorRecorder> m_recorder;
+    std::atomic<const ModelState*> m_recordingModel{ nullptr };
+    std::atomic<uint64_t> m_frameCounter;
+    uint64_t m_latestResultFrameId;  // 由 m_resultMutex 保护
+    Clock::time_point m_latestResultSubmitTime;
+    
+    // 异步推理统计
+    std::atomic<int> m_inFlight;
+    std::atomic<uint64_t> m_completedCount;
+    std::atomic<uint64_t> m_latencySumUs;
 };
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace dxapp
+{
+namespace common
+{
+    // 按 Alignment 字节对齐的分配器，供后处理中需要 SIMD 流式访问的数组使用
+    template <typename T, std::size_t Alignment = 32>
+    struct AlignedAllocator
+    {
+        using value_type = T;
+
+        template <typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() noexcept = default;
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 0) return nullptr;
+            std::size_t bytes = ((n * sizeof(T) + Alignment - 1) / Alignment) * Alignment;
+#ifdef _WIN32
+            void* p = _aligned_malloc(bytes, Alignment);
+#else
+            void* p = std::aligned_alloc(Alignment, bytes);
+#endif
+            if (!p) throw std::bad_alloc();
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, std::size_t) noexcept
+        {
+#ifdef _WIN32
+            _aligned_free(p);
+#else
+            std::free(p);
+#endif
+        }
+
+        template <typename U>
+        bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+        template <typename U>
+        bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+    };
+
+    template <typename T>
+    using AlignedVector = std::vector<T, AlignedAllocator<T, 32>>;
+} // namespace common
+} // namespace dxapp
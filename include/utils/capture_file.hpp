@@ -0,0 +1,393 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dxapp
+{
+namespace common
+{
+    // ------------------------------------------------------------------------
+    // 输出张量录制文件格式 (.dxcap)
+    //
+    //   [CaptureFileHeader][CaptureTensorDesc x numTensors]
+    //   [CaptureRecordHeader][payload] ...            （追加写，每条记录按 64 字节对齐）
+    //   [CaptureIndexEntry x count][CaptureFileTrailer] （关闭时写入）
+    //
+    // 进程异常退出时没有 trailer，读取端会顺序扫描记录重建索引。
+    // ------------------------------------------------------------------------
+    constexpr uint32_t kCaptureMagic = 0x50414358;        // "XCAP"
+    constexpr uint32_t kCaptureRecordMagic = 0x4D415246;  // "FRAM"
+    constexpr uint32_t kCaptureIndexMagic = 0x58444E49;   // "INDX"
+    constexpr uint32_t kCaptureVersion = 1;
+    constexpr uint32_t kCaptureAlign = 64;
+    constexpr uint32_t kCaptureMaxDims = 8;
+
+    struct CaptureFileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t numTensors;
+        uint32_t reserved;
+        uint64_t outputSize;      // 单帧输出 buffer 的字节数
+        uint64_t dataOffset;      // 第一条记录的偏移
+        char modelName[96];
+    };
+
+    struct CaptureTensorDesc
+    {
+        char name[64];
+        int32_t dtype;            // dxrt::DataType 的整数值
+        uint32_t numDims;
+        int64_t dims[kCaptureMaxDims];
+        uint64_t offset;          // 在输出 buffer 中的偏移
+        uint64_t sizeInBytes;
+    };
+
+    struct CaptureRecordHeader
+    {
+        uint32_t magic;
+        uint32_t payloadSize;
+        uint64_t frameId;
+        uint64_t timestampUs;
+        int32_t inputWidth;       // 原始输入图像尺寸（用于离线坐标还原）
+        int32_t inputHeight;
+        char inputRef[96];        // 输入帧引用（源名称 / 文件名 / 帧号）
+    };
+    static_assert(sizeof(CaptureRecordHeader) % kCaptureAlign == 0, "record header must keep payload aligned");
+
+    struct CaptureIndexEntry
+    {
+        uint64_t frameId;
+        uint64_t offset;          // 记录头的偏移
+    };
+
+    struct CaptureFileTrailer
+    {
+        uint32_t magic;
+        uint32_t reserved;
+        uint64_t indexOffset;
+        uint64_t count;
+    };
+
+    inline uint64_t alignCapture(uint64_t value)
+    {
+        return (value + kCaptureAlign - 1) / kCaptureAlign * kCaptureAlign;
+    }
+
+    // 可增长的内存映射文件（写端按块扩容，关闭时截断到实际长度）
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool openRead(const std::string& path)
+        {
+            close();
+            m_writable = false;
+#ifdef _WIN32
+            m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(m_file, &size)) { close(); return false; }
+            m_size = static_cast<uint64_t>(size.QuadPart);
+#else
+            m_fd = ::open(path.c_str(), O_RDONLY);
+            if (m_fd < 0) return false;
+            struct stat st;
+            if (fstat(m_fd, &st) != 0) { close(); return false; }
+            m_size = static_cast<uint64_t>(st.st_size);
+#endif
+            if (m_size == 0 || !map(m_size)) { close(); return false; }
+            return true;
+        }
+
+        bool openWrite(const std::string& path, uint64_t initialSize)
+        {
+            close();
+            m_writable = true;
+#ifdef _WIN32
+            m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                 CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE) return false;
+#else
+            m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (m_fd < 0) return false;
+#endif
+            return resize(initialSize);
+        }
+
+        // 扩容：解除映射 -> 调整文件长度 -> 重新映射（调用方需重新获取 data()）
+        bool resize(uint64_t newSize)
+        {
+            unmap();
+#ifdef _WIN32
+            LARGE_INTEGER pos;
+            pos.QuadPart = static_cast<LONGLONG>(newSize);
+            if (!SetFilePointerEx(m_file, pos, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file)) return false;
+#else
+            if (ftruncate(m_fd, static_cast<off_t>(newSize)) != 0) return false;
+#endif
+            m_size = newSize;
+            return newSize == 0 || map(newSize);
+        }
+
+        void close()
+        {
+            unmap();
+#ifdef _WIN32
+            if (m_file != INVALID_HANDLE_VALUE) { CloseHandle(m_file); m_file = INVALID_HANDLE_VALUE; }
+#else
+            if (m_fd >= 0) { ::close(m_fd); m_fd = -1; }
+#endif
+            m_size = 0;
+        }
+
+        uint8_t* data() const { return m_data; }
+        uint64_t size() const { return m_size; }
+        bool isOpen() const { return m_data != nullptr; }
+
+    private:
+        bool map(uint64_t size)
+        {
+#ifdef _WIN32
+            m_mapping = CreateFileMappingA(m_file, nullptr, m_writable ? PAGE_READWRITE : PAGE_READONLY,
+                                           static_cast<DWORD>(size >> 32), static_cast<DWORD>(size & 0xFFFFFFFF), nullptr);
+            if (!m_mapping) return false;
+            m_data = static_cast<uint8_t*>(MapViewOfFile(m_mapping, m_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+#else
+            void* p = mmap(nullptr, size, m_writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, m_fd, 0);
+            m_data = (p == MAP_FAILED) ? nullptr : static_cast<uint8_t*>(p);
+#endif
+            return m_data != nullptr;
+        }
+
+        void unmap()
+        {
+#ifdef _WIN32
+            if (m_data) { UnmapViewOfFile(m_data); }
+            if (m_mapping) { CloseHandle(m_mapping); m_mapping = nullptr; }
+#else
+            if (m_data) { munmap(m_data, m_size); }
+#endif
+            m_data = nullptr;
+        }
+
+#ifdef _WIN32
+        HANDLE m_file{INVALID_HANDLE_VALUE};
+        HANDLE m_mapping{nullptr};
+#else
+        int m_fd{-1};
+#endif
+        uint8_t* m_data{nullptr};
+        uint64_t m_size{0};
+        bool m_writable{false};
+    };
+
+    // 追加写入端（非线程安全，由录制线程独占使用）
+    class CaptureWriter
+    {
+    public:
+        static constexpr uint64_t kGrowStep = 64ull << 20;
+
+        ~CaptureWriter() { close(); }
+
+        bool open(const std::string& path, const std::string& modelName,
+                  const std::vector<CaptureTensorDesc>& tensors, uint64_t outputSize)
+        {
+            close();
+            m_outputSize = outputSize;
+            uint64_t headerSize = sizeof(CaptureFileHeader) + tensors.size() * sizeof(CaptureTensorDesc);
+            m_dataOffset = alignCapture(headerSize);
+            if (!m_file.openWrite(path, m_dataOffset + kGrowStep)) return false;
+
+            CaptureFileHeader header{};
+            header.magic = kCaptureMagic;
+            header.version = kCaptureVersion;
+            header.numTensors = static_cast<uint32_t>(tensors.size());
+            header.outputSize = outputSize;
+            header.dataOffset = m_dataOffset;
+            std::strncpy(header.modelName, modelName.c_str(), sizeof(header.modelName) - 1);
+            std::memcpy(m_file.data(), &header, sizeof(header));
+            if (!tensors.empty()) {
+                std::memcpy(m_file.data() + sizeof(header), tensors.data(), tensors.size() * sizeof(CaptureTensorDesc));
+            }
+            m_cursor = m_dataOffset;
+            m_index.clear();
+            return true;
+        }
+
+        bool append(const CaptureRecordHeader& record, const void* payload)
+        {
+            if (!m_file.isOpen()) return false;
+            uint64_t recordSize = alignCapture(sizeof(CaptureRecordHeader) + record.payloadSize);
+            if (!reserve(m_cursor + recordSize)) return false;
+
+            uint8_t* dst = m_file.data() + m_cursor;
+            std::memcpy(dst + sizeof(CaptureRecordHeader), payload, record.payloadSize);
+            // 记录头最后写入，保证扫描恢复时只看到完整记录
+            std::memcpy(dst, &record, sizeof(CaptureRecordHeader));
+            m_index.push_back({record.frameId, m_cursor});
+            m_cursor += recordSize;
+            return true;
+        }
+
+        void close()
+        {
+            if (!m_file.isOpen()) return;
+            uint64_t indexBytes = m_index.size() * sizeof(CaptureIndexEntry);
+            uint64_t finalSize = m_cursor + indexBytes + sizeof(CaptureFileTrailer);
+            if (reserve(finalSize)) {
+                if (indexBytes > 0) {
+                    std::memcpy(m_file.data() + m_cursor, m_index.data(), indexBytes);
+                }
+                CaptureFileTrailer trailer{kCaptureIndexMagic, 0, m_cursor, m_index.size()};
+                std::memcpy(m_file.data() + m_cursor + indexBytes, &trailer, sizeof(trailer));
+                m_file.resize(finalSize);
+            }
+            m_file.close();
+            m_index.clear();
+        }
+
+        uint64_t recordCount() const { return m_index.size(); }
+        uint64_t bytesWritten() const { return m_cursor; }
+
+    private:
+        bool reserve(uint64_t required)
+        {
+            if (required <= m_file.size()) return true;
+            uint64_t newSize = m_file.size();
+            while (newSize < required) newSize += kGrowStep;
+            return m_file.resize(newSize);
+        }
+
+        MappedFile m_file;
+        uint64_t m_outputSize{0};
+        uint64_t m_dataOffset{0};
+        uint64_t m_cursor{0};
+        std::vector<CaptureIndexEntry> m_index;
+    };
+
+    // 只读端：整个文件映射到内存，record() 返回的指针直接指向映射区（零拷贝）
+    class CaptureReader
+    {
+    public:
+        struct Record
+        {
+            const CaptureRecordHeader* header;
+            const uint8_t* payload;
+        };
+
+        bool open(const std::string& path)
+        {
+            m_records.clear();
+            if (!m_file.openRead(path) || m_file.size() < sizeof(CaptureFileHeader)) return false;
+            std::memcpy(&m_header, m_file.data(), sizeof(m_header));
+            if (m_header.magic != kCaptureMagic || m_header.version != kCaptureVersion) return false;
+
+            // 头部字段来自文件，先对照文件大小校验再使用（损坏或截断的文件直接拒绝）
+            const uint64_t fileSize = m_file.size();
+            if (m_header.numTensors > (fileSize - sizeof(CaptureFileHeader)) / sizeof(CaptureTensorDesc)) return false;
+            const uint64_t headerSize = sizeof(CaptureFileHeader) + uint64_t(m_header.numTensors) * sizeof(CaptureTensorDesc);
+            if (m_header.dataOffset < headerSize || m_header.dataOffset > fileSize ||
+                m_header.dataOffset % kCaptureAlign != 0) {
+                return false;
+            }
+
+            const uint8_t* descBase = m_file.data() + sizeof(CaptureFileHeader);
+            m_tensors.assign(reinterpret_cast<const CaptureTensorDesc*>(descBase),
+                             reinterpret_cast<const CaptureTensorDesc*>(descBase) + m_header.numTensors);
+            for (auto& tensor : m_tensors) {
+                tensor.name[sizeof(tensor.name) - 1] = '\0';
+                if (tensor.numDims > kCaptureMaxDims || tensor.offset > m_header.outputSize ||
+                    tensor.sizeInBytes > m_header.outputSize - tensor.offset) {
+                    return false;
+                }
+            }
+
+            if (!loadIndex()) {
+                scanRecords();
+            }
+            return true;
+        }
+
+        const CaptureFileHeader& header() const { return m_header; }
+        const std::vector<CaptureTensorDesc>& tensors() const { return m_tensors; }
+        size_t size() const { return m_records.size(); }
+        const Record& record(size_t i) const { return m_records[i]; }
+        bool recovered() const { return m_recovered; }
+
+    private:
+        bool loadIndex()
+        {
+            uint64_t fileSize = m_file.size();
+            if (fileSize < m_header.dataOffset + sizeof(CaptureFileTrailer)) return false;
+            CaptureFileTrailer trailer;
+            std::memcpy(&trailer, m_file.data() + fileSize - sizeof(trailer), sizeof(trailer));
+            // 索引区在数据区之后、trailer 之前，按条目对齐；count 先按可用空间限制，避免乘法溢出
+            const uint64_t indexLimit = fileSize - sizeof(trailer);
+            if (trailer.magic != kCaptureIndexMagic ||
+                trailer.indexOffset < m_header.dataOffset || trailer.indexOffset > indexLimit ||
+                trailer.indexOffset % alignof(CaptureIndexEntry) != 0 ||
+                trailer.count > (indexLimit - trailer.indexOffset) / sizeof(CaptureIndexEntry) ||
+                trailer.indexOffset + trailer.count * sizeof(CaptureIndexEntry) != indexLimit) {
+                return false;
+            }
+            const auto* index = reinterpret_cast<const CaptureIndexEntry*>(m_file.data() + trailer.indexOffset);
+            m_records.reserve(trailer.count);
+            for (uint64_t i = 0; i < trailer.count; i++) {
+                if (!pushRecord(index[i].offset, trailer.indexOffset)) return false;
+            }
+            return true;
+        }
+
+        void scanRecords()
+        {
+            m_recovered = true;
+            m_records.clear();
+            uint64_t offset = m_header.dataOffset;
+            while (pushRecord(offset, m_file.size())) {
+                offset += alignCapture(sizeof(CaptureRecordHeader) + m_records.back().header->payloadSize);
+            }
+        }
+
+        bool pushRecord(uint64_t offset, uint64_t limit)
+        {
+            if (offset < m_header.dataOffset || offset % kCaptureAlign != 0 ||
+                offset > limit || limit - offset < sizeof(CaptureRecordHeader)) {
+                return false;
+            }
+            const auto* hdr = reinterpret_cast<const CaptureRecordHeader*>(m_file.data() + offset);
+            if (hdr->magic != kCaptureRecordMagic || hdr->payloadSize != m_header.outputSize ||
+                limit - offset - sizeof(CaptureRecordHeader) < hdr->payloadSize) {
+                return false;
+            }
+            m_records.push_back({hdr, m_file.data() + offset + sizeof(CaptureRecordHeader)});
+            return true;
+        }
+
+        MappedFile m_file;
+        CaptureFileHeader m_header{};
+        std::vector<CaptureTensorDesc> m_tensors;
+        std::vector<Record> m_records;
+        bool m_recovered{false};
+    };
+} // namespace common
+} // namespace dxapp
@@ -20,7 +20,7 @@ void DisplayBoundingBox(cv::Mat& frame,
                        std::vector<BoundingBox>& result, 
                        float OriginHeight, 
                        float OriginWidth, 
-                       std::vector<cv::Scalar> ObjectColors, 
+                       const std::vector<cv::Scalar>& ObjectColors, 
                        PostProcType type, 
                        bool ImageCenterAligned=false, 
                        float InputWidth=0.f, 
@@ -3,4 +3,4 @@
 #include <opencv2/opencv.hpp>
 
 
-void PreProc(cv::Mat& src, cv::Mat &dest, bool keepRatio=true, bool bgr2rgb=true, uint8_t padValue=0);
\ No newline at end of file
+void PreProc(const cv::Mat& src, cv::Mat &dest, bool keepRatio=true, bool bgr2rgb=true, uint8_t padValue=0);
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 标签分数的格式
+enum class LabelScoreFormat
+{
+    Percent,       // "87%"
+    Decimal        // "0.87"（小数位数见 LabelStyle::decimals）
+};
+
+// 标签样式：同一个缓存内所有标签共用
+struct LabelStyle
+{
+    int fontFace = cv::FONT_HERSHEY_SIMPLEX;
+    double fontScale = 0.5;
+    int thickness = 1;
+    std::string separator = ": ";          // 类别名与分数之间
+    LabelScoreFormat scoreFormat = LabelScoreFormat::Percent;
+    int decimals = 2;
+    int padding = 2;                       // 文字与背景边缘的距离
+    bool fillBackground = true;            // true：背景填充类别颜色；false：背景透明，只画文字
+};
+
+// 检测框标签精灵缓存
+//
+// Hershey 矢量字体的 getTextSize/putText 每次都要逐笔画光栅化，100 个框每帧就是毫秒级开销。
+// 这里按样式把“类别名+分隔符”和分数用到的字符（0-9 . %）各光栅化一次成 8 位覆盖率图（LINE_AA），
+// 画标签时只按前进宽度拼接覆盖率图，再以类别颜色/文字颜色做一次 alpha 混合，不格式化字符串、不调用 putText。
+// 覆盖率图与颜色无关，同一类别换颜色不需要重新渲染。
+//
+// 线程安全：多个绘制线程可共用一个缓存；缓存的图只读，查找时持锁，混合在锁外进行。
+class LabelSpriteCache
+{
+public:
+    // 类别名缓存上限（跟踪标签带轨迹号，名字不固定），超过时清空重建
+    static constexpr size_t kMaxNames = 512;
+
+    explicit LabelSpriteCache(const LabelStyle& style = LabelStyle());
+
+    const LabelStyle& style() const { return m_style; }
+
+    // 标签（含内边距）尺寸
+    cv::Size measure(const std::string& name, float score);
+
+    // 在检测框左上角 boxTopLeft 的上方绘制标签，超出图像顶部时画在框内。
+    // dst 为 CV_8UC3 或 CV_8UC4（第 4 通道写 255），颜色按 dst 的通道顺序给出。
+    // 返回实际绘制的区域（已裁剪到图像内，可能为空）
+    cv::Rect draw(cv::Mat& dst, const cv::Point& boxTopLeft, const std::string& name, float score,
+                  const cv::Scalar& textColor, const cv::Scalar& backgroundColor);
+
+private:
+    struct Sprite
+    {
+        cv::Mat mask;      // CV_8UC1 覆盖率，高度为 m_cellHeight
+        int advance = 0;   // 下一段的起点（不含笔画粗细的外扩）
+    };
+
+    Sprite render(const std::string& text) const;
+    Sprite nameSprite(const std::string& name);
+    // 分数文本写入 buf（不含结尾 0），返回字符数
+    int formatScore(float score, char* buf) const;
+    // 把类别名和分数的覆盖率按前进宽度拼接到 mask（调用方按 textWidth() 分配并清零）
+    void compose(const Sprite& name, const char* score, int scoreLength, cv::Mat& mask) const;
+    int textWidth(const Sprite& name, const char* score, int scoreLength) const;
+
+    LabelStyle m_style;
+    int m_cellHeight;
+    int m_baseline;                        // 文字基线在覆盖率图中的行
+    Sprite m_glyphs[128];                  // 分数字符，只渲染 0-9 . %
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Sprite> m_names;
+};
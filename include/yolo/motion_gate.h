@@ -0,0 +1,58 @@
+#pragma once
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+
+// 运动门控参数
+struct MotionGateConfig
+{
+    int analysisWidth = 320;       // 分析图宽度（按原图宽高比缩放，宽高对齐到块大小）
+    int blockThreshold = 10;       // 块内平均绝对差（灰度级）超过该值视为变化块
+    int minChangedBlocks = 2;      // 变化块数达到该值视为画面变化（过滤单块噪声）
+    double backgroundAlpha = 0.05; // 背景更新速率（每帧），缓慢吸收光照漂移
+    int refreshInterval = 30;      // 静止时每 N 帧强制推理一次（0 表示不强制）
+};
+
+// 运动门控：在降采样的亮度图上按 16x16 块计算与滑动背景的 SAD，画面静止时跳过推理
+// 用法：每帧调用 update()，返回 true 时提交推理，实际提交成功后调用 markSubmitted()；
+// 变化帧若未能提交（推理繁忙或被速率控制跳过），后续帧仍返回 true 直到提交为止
+class MotionGate
+{
+public:
+    static constexpr int kBlockSize = 16;
+
+    MotionGate();
+    explicit MotionGate(const MotionGateConfig& config);
+
+    void setConfig(const MotionGateConfig& config);
+    const MotionGateConfig& config() const { return m_config; }
+    // 清空背景（切换视频源或分辨率变化时调用）
+    void reset();
+
+    bool update(const cv::Mat& frame);
+    void markSubmitted();
+
+    int lastChangedBlocks() const { return m_lastChangedBlocks; }
+    int blockCount() const { return m_blocksX * m_blocksY; }
+    uint64_t frameCount() const { return m_frames; }
+    uint64_t changedCount() const { return m_changedFrames; }   // 检测到变化的帧数
+    uint64_t gatedCount() const { return m_gatedFrames; }       // 被跳过的帧数
+
+private:
+    // 缩放到分析尺寸并转为 8 位亮度图
+    void toLuma(const cv::Mat& frame, cv::Mat& luma) const;
+    int countChangedBlocks(const cv::Mat& luma) const;
+
+    MotionGateConfig m_config;
+    cv::Mat m_background;          // CV_8UC1，分析尺寸
+    cv::Mat m_luma;
+    cv::Size m_sourceSize;
+    int m_blocksX;
+    int m_blocksY;
+    int m_lastChangedBlocks;
+    bool m_pending;                // 有变化尚未提交推理
+    int m_framesSinceSubmit;
+    uint64_t m_frames;
+    uint64_t m_changedFrames;
+    uint64_t m_gatedFrames;
+};
@@ -18,20 +18,44 @@
 #define VDMA_CNN_IMG_HSIZE  640		//1920
 #define VDMA_CNN_IMG_VSIZE  480		//1080
 
+// fbdev 叠加层渲染（多页翻页）
+// - 每页记录上次绘制的区域（边框四条边和标签），擦除只处理这些区域，开销与框数成正比而不是与屏幕大小成正比
+// - 翻页：NextBuffer() 轮流给出不在显示中的后台页，Present() 等待垂直同步后用 FBIOPAN_DISPLAY 切换
 class FrameBuffer
 {
 public:
     FrameBuffer(std::string dev, uint32_t numBuf_);
+    ~FrameBuffer();
     void Clear(void);
+    // 先擦除 bufId 上次绘制的区域，再绘制并提交显示
+    // 构造时页数可能被显存/虚拟分辨率减少，bufId 按实际页数取模（负数忽略），见 NumBuffers()
     void DrawBoxes(int bufId, std::vector<BoundingBox> &result, std::vector<cv::Scalar> &colors, float OriginHeight, float OriginWidth);
+    // 翻页绘制：在 NextBuffer() 给出的后台页上绘制并提交，返回绘制的页号
+    int DrawBoxes(std::vector<BoundingBox> &result, std::vector<cv::Scalar> &colors, float OriginHeight, float OriginWidth);
+    // 只擦除 bufId 上次绘制的区域（result 等参数保留兼容，不再使用）
     void EraseBoxes(int bufId, std::vector<BoundingBox> &result, float OriginHeight, float OriginWidth);
+    // 下一个可绘制的后台页（只有一页时返回 0）
+    int NextBuffer(void);
+    bool Present(int bufId);
+    // 实际使用的页数（可能少于构造时请求的页数）
+    int NumBuffers() const { return (int)numBuf; }
     void Show();
     void* get_data(){return data[0];};
 private:
+    static const int kMaxBuf = 8;
+    // 把调用方的页号映射到实际页（按页数取模），负数返回 -1
+    int PageIndex(int bufId) const { return bufId < 0 ? -1 : bufId % (int)numBuf; }
+    void MarkDirty(int bufId, const cv::Rect &rect);
+    void EraseRect(int bufId, const cv::Rect &rect);
+
     int fd;
     uint32_t numBuf;
     uint32_t bpp; /* Bytes Per Pixel */
-    void *data[8];
+    void *data[kMaxBuf];
+    std::vector<cv::Rect> dirty[kMaxBuf];  /* 每页上次绘制的区域 */
+    int frontBuf;                          /* 正在显示的页 */
+    bool canFlip;                          /* 虚拟分辨率能容纳 numBuf 页且 PAN 可用 */
+    bool waitVsync;                        /* 驱动不支持 FBIO_WAITFORVSYNC 时关闭 */
     struct fb_var_screeninfo vinfo;
     struct fb_fix_screeninfo finfo;
     uint32_t xres;
@@ -39,6 +63,8 @@ private:
     long int screenSize;
 };
 
+// 单缓冲拷贝式采集（固定 640x480 RGB24），保留给旧的演示程序；
+// 新代码使用 include/ui/V4l2Capture.h（多缓冲、poll 等待、零拷贝交付）
 namespace nxp
 {
     int print_caps(int fd);
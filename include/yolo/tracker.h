@@ -0,0 +1,90 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+#include "bbox.h"
+
+// 跟踪参数（时间单位为秒，与帧率无关，检测可以只在部分帧上运行）
+struct TrackerConfig
+{
+    float highScore = 0.5f;        // 第一轮关联的检测分数下限
+    float lowScore = 0.1f;         // 低分检测只用于延续已有轨迹（ByteTrack 第二轮），不新建轨迹
+    float newTrackScore = 0.6f;    // 新建轨迹的分数下限
+    float matchIou = 0.3f;         // 第一轮最小 IoU
+    float lowMatchIou = 0.5f;      // 第二轮最小 IoU（低分检测要求更高的重合度）
+    double maxLostSec = 1.0;       // 轨迹连续未匹配超过该时间后删除
+    int minHits = 2;               // 匹配次数达到该值后轨迹才输出（过滤单帧误检）
+    bool classAware = true;        // 只在同类别之间关联
+};
+
+// 跟踪输出
+struct TrackedObject
+{
+    int trackId = 0;
+    int label = 0;
+    std::string labelname;
+    float score = 0;               // 最近一次匹配的检测分数
+    float box[4] = { 0, 0, 0, 0 }; // x1, y1, x2, y2（预测到查询时刻的位置）
+    float velocity[2] = { 0, 0 };  // 中心点速度（像素/秒）
+    int hits = 0;
+    double lastSeenSec = 0;        // 最近一次匹配检测的时间
+};
+
+// 多目标跟踪：Kalman 匀速模型（中心、宽高及其速度）+ ByteTrack 式两轮 IoU 关联
+// - update() 用一帧检测结果更新：先把轨迹预测到该帧时刻，高分检测与全部轨迹关联，
+//   剩余轨迹再与低分检测关联，未匹配的高分检测新建轨迹
+// - predict() 只做外推，不修改滤波状态，用于没有推理的帧（检测频率低于采集帧率时仍逐帧输出轨迹）
+// - IoU 代价矩阵按结构数组逐行计算（内层循环无分支，便于编译器向量化），关联用按 IoU 降序的贪心匹配
+// 非线程安全，由调用方保证在同一线程使用
+class MultiObjectTracker
+{
+public:
+    MultiObjectTracker();
+    explicit MultiObjectTracker(const TrackerConfig& config);
+
+    void setConfig(const TrackerConfig& config) { m_config = config; }
+    const TrackerConfig& config() const { return m_config; }
+    void reset();
+
+    // timestampSec：该帧检测对应的采集时间，须单调递增
+    void update(const std::vector<BoundingBox>& detections, double timestampSec);
+    // 已确认且最近一次更新时仍匹配的轨迹在 timestampSec 时刻的位置
+    std::vector<TrackedObject> predict(double timestampSec) const;
+
+    size_t trackCount() const { return m_tracks.size(); }
+    int createdTracks() const { return m_nextId - 1; }    // 累计确认过的轨迹数（用于计数）
+
+private:
+    using State = cv::Matx<float, 8, 1>;        // cx, cy, w, h, vcx, vcy, vw, vh
+    using Covariance = cv::Matx<float, 8, 8>;
+
+    struct Track
+    {
+        int id = 0;                 // 确认前为 0
+        int label = 0;
+        std::string labelname;
+        float score = 0;
+        State x;
+        Covariance P;
+        double time = 0;            // 滤波状态对应的时间
+        double lastSeen = 0;
+        int hits = 0;
+        bool matched = false;       // 最近一次 update 是否匹配
+    };
+
+    void predictTrack(Track& track, double timestampSec) const;
+    void correctTrack(Track& track, const BoundingBox& detection) const;
+    void initTrack(Track& track, const BoundingBox& detection, double timestampSec) const;
+    static void toBox(const State& x, double dt, float box[4], float velocity[2]);
+
+    // 计算 tracks[trackIndices] 与 detections[detIndices] 的 IoU 矩阵并贪心匹配，返回 (track, det) 对
+    std::vector<std::pair<int, int>> associate(const std::vector<int>& trackIndices,
+                                               const std::vector<int>& detIndices,
+                                               const std::vector<BoundingBox>& detections,
+                                               float minIou) const;
+
+    TrackerConfig m_config;
+    std::vector<Track> m_tracks;
+    int m_nextId;
+};
@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <dxrt/dxrt_api.h>
+#include <utils/aligned_allocator.hpp>
 #include "nms.h"
 
 #define sigmoid(x) (1 / (1 + std::exp(-x)))
@@ -94,6 +95,46 @@ struct YoloParam
     void Show();
 };
 
+// 按名称查找 yolo_cfg.cpp 中的预置配置（名称与变量名一致，如 "yolov7_640"），找不到返回 nullptr
+struct YoloParamEntry
+{
+    const char* name;
+    YoloParam* param;
+};
+const std::vector<YoloParamEntry>& GetYoloParamTable();
+YoloParam* FindYoloParam(const std::string& name);
+
+// 单层解码参数（由 BuildDecodePlan 预计算）
+struct YoloDecodeLayer
+{
+    int32_t firstEntry{0};    // 该层第一个 anchor 条目在 plan 中的下标（即全局 boxIdx）
+    int32_t numEntries{0};    // numGridY * numGridX * numBoxes
+    int32_t channels{0};      // 每个网格单元的通道数（YoloV7 可能带额外通道）
+    // xy 解码: (sigmoid(v * xyPreScale + xyPreBias) * xyGain + cell) * stride
+    float xyPreScale{1.0f};
+    float xyPreBias{0.0f};
+    float xyGain{2.0f};
+};
+
+// 扁平化的 anchor-based 解码表：每个 (gY, gX, box) 一个条目，按 boxIdx 顺序排列
+// 在 LayerReorder 时构建一次，FilterWithSort 内层循环只做连续访存和算术
+struct YoloDecodePlan
+{
+    std::vector<YoloDecodeLayer> layers;
+    std::vector<std::vector<int64_t>> shapes;            // 构建时使用的 output shape（用于校验）
+    dxapp::common::AlignedVector<int32_t> dataOffset;    // 条目数据在输出 buffer 中的 float 偏移
+    dxapp::common::AlignedVector<float> cellX;           // 已折入 -0.5 偏移的网格 x 坐标
+    dxapp::common::AlignedVector<float> cellY;
+    dxapp::common::AlignedVector<float> strideX;
+    dxapp::common::AlignedVector<float> strideY;
+    dxapp::common::AlignedVector<float> anchorW;         // anchorWidth * 4，已折入 (2*sigmoid)^2 的系数
+    dxapp::common::AlignedVector<float> anchorH;
+
+    bool empty() const { return dataOffset.empty(); }
+    size_t size() const { return dataOffset.size(); }
+    void clear();
+};
+
 class Yolo
 {
 private:
@@ -110,6 +151,10 @@ private:
     bool is_onnx_output = false;
     std::vector<int32_t> onnxOutputIdx={};
 
+    // anchor-based 解码表
+    YoloDecodePlan decodePlan;
+    bool BuildDecodePlan(const std::vector<std::vector<int64_t>> &output_shape);
+
 public:
     // Constructors/Destructor
     Yolo();
@@ -130,6 +175,15 @@ public:
     // FilterWithSort variants
     void FilterWithSort(void* outputs, std::vector<std::vector<int64_t>> output_shape, dxrt::DataType data_type);
 
+    const YoloDecodePlan& GetDecodePlan() const { return decodePlan; }
+
+    // 清空上一帧的候选框（单独调用 FilterWithSort / raw_post_processing / onnx_post_processing 前使用）
+    void ClearCandidates();
+    // 预留每类候选和最终结果的容量（模型加载时调用，避免前几帧在后处理中逐步扩容）
+    void ReserveCandidates(size_t perClass, size_t results);
+    // 当前候选框总数（NMS 前）
+    size_t CandidateCount() const;
+
     // Utility functions
     void ShowResult(void) {
         std::cout << "  Detected " << std::dec << Result.size() << " boxes." << std::endl;
@@ -0,0 +1,318 @@
+#include "AsyncLogger.h"
+#include <QDateTime>
+#include <QFile>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+AsyncLogger& AsyncLogger::instance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+    : m_mask(0)
+    , m_enqueuePos(0)
+    , m_dequeuePos(0)
+    , m_running(false)
+    , m_flushRequest(0)
+    , m_flushDone(0)
+    , m_written(0)
+    , m_dropped(0)
+    , m_suppressed(0)
+{
+    for (SiteBucket& bucket : m_sites) {
+        bucket.key.store(0, std::memory_order_relaxed);
+        bucket.window.store(0, std::memory_order_relaxed);
+        bucket.count.store(0, std::memory_order_relaxed);
+    }
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stop();
+}
+
+void AsyncLogger::start(const AsyncLoggerConfig& config)
+{
+    stop();
+    m_config = config;
+
+    size_t capacity = 64;
+    while (capacity < (size_t)std::max(config.queueCapacity, 1)) {
+        capacity <<= 1;
+    }
+    m_cells.reset(new Cell[capacity]);
+    for (size_t i = 0; i < capacity; i++) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_mask = capacity - 1;
+    m_enqueuePos.store(0, std::memory_order_relaxed);
+    m_dequeuePos.store(0, std::memory_order_relaxed);
+
+    m_running.store(true, std::memory_order_release);
+    m_writer = std::thread(&AsyncLogger::writerLoop, this);
+    qInstallMessageHandler(&AsyncLogger::messageHandler);
+}
+
+void AsyncLogger::stop()
+{
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+    qInstallMessageHandler(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running.store(false, std::memory_order_release);
+    }
+    m_wake.notify_all();
+    m_writer.join();
+
+    // 卸载处理器之前已进入 messageHandler 的消息可能在后台线程退出后才入队，这里同步写出
+    Entry entry;
+    while (pop(entry)) {
+        fputs(formatLine(entry.type, entry.timestampMs, entry.message).toLocal8Bit().constData(), stderr);
+    }
+}
+
+void AsyncLogger::flush(int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_running.load(std::memory_order_acquire)) {
+        return;
+    }
+    const uint64_t target = ++m_flushRequest;
+    m_wake.notify_one();
+    m_flushed.wait_for(lock, std::chrono::milliseconds(timeoutMs), [&] {
+        return m_flushDone >= target || !m_running.load(std::memory_order_acquire);
+    });
+}
+
+AsyncLoggerStats AsyncLogger::stats() const
+{
+    AsyncLoggerStats stats;
+    stats.written = m_written.load(std::memory_order_relaxed);
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.suppressed = m_suppressed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void AsyncLogger::messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+    AsyncLogger& logger = instance();
+    if (!logger.m_running.load(std::memory_order_acquire)) {
+        fputs(formatLine(type, QDateTime::currentMSecsSinceEpoch(), msg).toLocal8Bit().constData(), stderr);
+        return;
+    }
+    if (!logger.allowSite(type, context, msg)) {
+        return;
+    }
+    if (!logger.push(type, msg)) {
+        // 队列满：fatal 消息不能丢，同步写出，其他消息只计数
+        if (type == QtFatalMsg) {
+            fputs(formatLine(type, QDateTime::currentMSecsSinceEpoch(), msg).toLocal8Bit().constData(), stderr);
+        }
+        return;
+    }
+    if (type == QtFatalMsg) {
+        logger.flush();
+    }
+}
+
+bool AsyncLogger::push(QtMsgType type, const QString& msg)
+{
+    // 有界 MPMC 环形队列（每个槽位带序号，生产者用 CAS 抢占写位置），这里只有一个消费者
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &m_cells[pos & m_mask];
+        const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        else if (diff < 0) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->entry.type = type;
+    cell->entry.timestampMs = QDateTime::currentMSecsSinceEpoch();
+    cell->entry.message = msg;     // 隐式共享，只增加引用计数
+    cell->sequence.store(pos + 1, std::memory_order_release);
+
+    // 队列过半时提前唤醒后台线程（只在越过一半的那一条通知，不加锁）
+    if (pos - m_dequeuePos.load(std::memory_order_relaxed) == (m_mask + 1) / 2) {
+        m_wake.notify_one();
+    }
+    return true;
+}
+
+bool AsyncLogger::pop(Entry& entry)
+{
+    const size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+    Cell& cell = m_cells[pos & m_mask];
+    const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if ((intptr_t)sequence - (intptr_t)(pos + 1) < 0) {
+        return false;
+    }
+    entry = std::move(cell.entry);
+    cell.entry.message = QString();
+    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+    m_dequeuePos.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+bool AsyncLogger::allowSite(QtMsgType type, const QMessageLogContext& context, const QString& msg)
+{
+    if (m_config.siteLimit <= 0 || type != QtDebugMsg) {
+        return true;
+    }
+
+    // 调用点：有文件名时按文件+行号；发布版没有上下文，按消息开头的 [标签]（最多 48 个字符）
+    uint64_t key = 1469598103934665603ull;
+    if (context.file) {
+        key ^= (uint64_t)(uintptr_t)context.file;
+        key *= 1099511628211ull;
+        key ^= (uint64_t)context.line;
+        key *= 1099511628211ull;
+    }
+    else {
+        const QChar* chars = msg.constData();
+        const int length = std::min<int>(msg.size(), 48);
+        for (int i = 0; i < length; i++) {
+            key ^= chars[i].unicode();
+            key *= 1099511628211ull;
+            if (i > 0 && chars[i] == QLatin1Char(']')) {
+                break;
+            }
+        }
+    }
+    key |= 1;
+
+    const int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    const int64_t window = nowMs / std::max(m_config.siteWindowMs, 1);
+
+    // 线性探测：找到本调用点的槽位，或占用空槽/本窗口内未使用的槽位；
+    // 探测范围内都被本窗口活跃的其他调用点占用时，与首个槽位共享额度（不重置对方的计数）
+    const size_t home = (size_t)(key >> 7);
+    SiteBucket* bucket = &m_sites[home & (kSiteBuckets - 1)];
+    for (int i = 0; i < kSiteProbe; i++) {
+        SiteBucket& candidate = m_sites[(home + i) & (kSiteBuckets - 1)];
+        uint64_t owner = candidate.key.load(std::memory_order_relaxed);
+        if (owner == key) {
+            bucket = &candidate;
+            break;
+        }
+        if ((owner == 0 || candidate.window.load(std::memory_order_relaxed) != window)
+            && candidate.key.compare_exchange_strong(owner, key, std::memory_order_relaxed)) {
+            candidate.window.store(window - 1, std::memory_order_relaxed);   // 下面按新窗口重置计数
+            bucket = &candidate;
+            break;
+        }
+    }
+    int64_t bucketWindow = bucket->window.load(std::memory_order_relaxed);
+    if (bucketWindow != window && bucket->window.compare_exchange_strong(bucketWindow, window, std::memory_order_relaxed)) {
+        // 新窗口重新计数（并发时可能多放行几条，限流是近似的）
+        bucket->count.store(0, std::memory_order_relaxed);
+    }
+    if (bucket->count.fetch_add(1, std::memory_order_relaxed) >= m_config.siteLimit) {
+        m_suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+QString AsyncLogger::formatLine(QtMsgType type, qint64 timestampMs, const QString& msg)
+{
+    const char* level = "DEBUG";
+    switch (type) {
+    case QtDebugMsg:    level = "DEBUG"; break;
+    case QtInfoMsg:     level = "INFO"; break;
+    case QtWarningMsg:  level = "WARNING"; break;
+    case QtCriticalMsg: level = "CRITICAL"; break;
+    case QtFatalMsg:    level = "FATAL"; break;
+    }
+    return QString("%1 [%2] %3\n")
+        .arg(QDateTime::fromMSecsSinceEpoch(timestampMs).toString("yyyy-MM-dd hh:mm:ss.zzz"))
+        .arg(level)
+        .arg(msg);
+}
+
+void AsyncLogger::writerLoop()
+{
+    QFile file(m_config.filePath);
+    bool fileOpen = !m_config.filePath.isEmpty()
+        && file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append);
+
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point lastReport = Clock::now();
+    uint64_t reportedDropped = 0;
+    uint64_t reportedSuppressed = 0;
+
+    for (;;) {
+        uint64_t request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait_for(lock, std::chrono::milliseconds(m_config.flushIntervalMs), [&] {
+                return !m_running.load(std::memory_order_relaxed) || m_flushRequest != m_flushDone
+                    || m_enqueuePos.load(std::memory_order_relaxed) - m_dequeuePos.load(std::memory_order_relaxed) > m_mask / 2;
+            });
+            request = m_flushRequest;
+        }
+        const bool running = m_running.load(std::memory_order_acquire);
+
+        // 一批消息拼成一个缓冲，文件和 stderr 各写一次
+        QString batch;
+        uint64_t count = 0;
+        Entry entry;
+        while (pop(entry)) {
+            batch += formatLine(entry.type, entry.timestampMs, entry.message);
+            count++;
+        }
+
+        // 丢弃/限流汇总：每秒最多一行，没有新增时不输出
+        Clock::time_point now = Clock::now();
+        if (now - lastReport >= std::chrono::seconds(1) || !running) {
+            const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+            const uint64_t suppressed = m_suppressed.load(std::memory_order_relaxed);
+            if (dropped != reportedDropped || suppressed != reportedSuppressed) {
+                batch += formatLine(QtWarningMsg, QDateTime::currentMSecsSinceEpoch(),
+                    QString("[LOG] 队列满丢弃 %1 条, 限流 %2 条 (累计 %3 / %4)")
+                        .arg(dropped - reportedDropped).arg(suppressed - reportedSuppressed)
+                        .arg(dropped).arg(suppressed));
+                reportedDropped = dropped;
+                reportedSuppressed = suppressed;
+            }
+            lastReport = now;
+        }
+
+        if (!batch.isEmpty()) {
+            if (fileOpen) {
+                file.write(batch.toUtf8());
+                file.flush();
+            }
+            if (m_config.toStderr) {
+                QByteArray bytes = batch.toLocal8Bit();
+                fwrite(bytes.constData(), 1, bytes.size(), stderr);
+            }
+            m_written.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_flushDone = request;
+        }
+        m_flushed.notify_all();
+        if (!running) {
+            break;
+        }
+    }
+}
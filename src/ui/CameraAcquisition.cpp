@@ -0,0 +1,162 @@
+#include "CameraAcquisition.h"
+#include "CameraFramePool.h"
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+
+bool queryCameraStreamStats(IMV_HANDLE handle, CameraStreamStats& stats)
+{
+    if (!handle) {
+        return false;
+    }
+    IMV_StreamStatisticsInfo info;
+    memset(&info, 0, sizeof(info));
+    if (IMV_GetStatisticsInfo(handle, &info) != IMV_OK) {
+        return false;
+    }
+
+    switch (info.nCameraType) {
+    case typeGigeCamera:
+        stats.sdkReceived = info.gigeStatisticsInfo.imageReceived;
+        stats.sdkLost = info.gigeStatisticsInfo.lostPacketBlock;
+        stats.sdkIncomplete = info.gigeStatisticsInfo.imageError;
+        stats.sdkFps = info.gigeStatisticsInfo.fps;
+        stats.bandwidthMbps = info.gigeStatisticsInfo.bandwidth;
+        break;
+    case typeU3vCamera:
+        stats.sdkReceived = info.u3vStatisticsInfo.imageReceived;
+        stats.sdkLost = info.u3vStatisticsInfo.lostPacketBlock;
+        stats.sdkIncomplete = info.u3vStatisticsInfo.imageError;
+        stats.sdkFps = info.u3vStatisticsInfo.fps;
+        stats.bandwidthMbps = info.u3vStatisticsInfo.bandwidth;
+        break;
+    case typePCIeCamera:
+        stats.sdkReceived = info.pcieStatisticsInfo.imageReceived;
+        stats.sdkLost = info.pcieStatisticsInfo.lostPacketBlock;
+        stats.sdkIncomplete = info.pcieStatisticsInfo.imageError;
+        stats.sdkFps = info.pcieStatisticsInfo.fps;
+        stats.bandwidthMbps = info.pcieStatisticsInfo.bandwidth;
+        break;
+    default:
+        return false;
+    }
+    stats.sdkValid = true;
+    return true;
+}
+
+CameraCallbackGrabber::CameraCallbackGrabber(IMV_HANDLE handle, std::shared_ptr<CameraFramePool> pool, size_t capacity)
+    : m_handle(handle)
+    , m_pool(std::move(pool))
+    , m_capacity(std::max<size_t>(capacity, 1))
+    , m_delivered(0)
+    , m_overwritten(0)
+    , m_skipped(0)
+    , m_taken(0)
+    , m_queueDelaySumUs(0)
+{
+}
+
+CameraCallbackGrabber::~CameraCallbackGrabber()
+{
+    clear();
+}
+
+bool CameraCallbackGrabber::attach()
+{
+    int ret = IMV_AttachGrabbing(m_handle, &CameraCallbackGrabber::onFrame, this);
+    if (ret != IMV_OK) {
+        qWarning() << "[CAMERA CALLBACK] 注册帧回调失败，错误码:" << ret;
+        return false;
+    }
+    qDebug() << "[CAMERA CALLBACK] 已注册帧回调，队列容量:" << m_capacity;
+    return true;
+}
+
+void CameraCallbackGrabber::onFrame(IMV_Frame* frame, void* user)
+{
+    if (frame && user) {
+        static_cast<CameraCallbackGrabber*>(user)->push(frame);
+    }
+}
+
+void CameraCallbackGrabber::push(IMV_Frame* frame)
+{
+    // 到达时刻在拷贝之前记录，队列等待时间才包含回调内的拷贝耗时
+    Clock::time_point arrival = Clock::now();
+    Entry entry;
+    if (!m_pool->clone(*frame, entry.frame)) {
+        return;
+    }
+    entry.arrival = arrival;
+
+    Entry overwritten;
+    bool hasOverwritten = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_queue.size() >= m_capacity) {
+            overwritten = m_queue.front();
+            hasOverwritten = true;
+            m_queue.pop_front();
+            m_overwritten++;
+        }
+        m_queue.push_back(entry);
+        m_delivered++;
+    }
+    m_cv.notify_one();
+    if (hasOverwritten) {
+        m_pool->discard(overwritten.frame);
+    }
+}
+
+bool CameraCallbackGrabber::take(cv::Mat& outFrame, int timeoutMs, Clock::time_point* arrival)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_queue.empty() && timeoutMs > 0) {
+        m_cv.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return !m_queue.empty(); });
+    }
+    if (m_queue.empty()) {
+        return false;
+    }
+
+    // 只取最新帧：积压说明下游慢于采集，丢弃旧帧使采集到推理的延迟最低
+    m_skipped += m_queue.size() - 1;
+    std::deque<Entry> entries;
+    entries.swap(m_queue);
+    Entry entry = entries.back();
+    entries.pop_back();
+
+    m_taken++;
+    m_queueDelaySumUs += std::chrono::duration<double, std::micro>(Clock::now() - entry.arrival).count();
+    lock.unlock();
+
+    // 跳过的旧帧直接归还，只有取走的帧包装成 Mat（Mono8/BGR8 零拷贝，其他格式在这里转换）
+    for (Entry& skipped : entries) {
+        m_pool->discard(skipped.frame);
+    }
+    outFrame = m_pool->wrap(entry.frame);
+    if (arrival) {
+        *arrival = entry.arrival;
+    }
+    return !outFrame.empty();
+}
+
+void CameraCallbackGrabber::clear()
+{
+    std::deque<Entry> entries;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        entries.swap(m_queue);
+    }
+    for (Entry& entry : entries) {
+        m_pool->discard(entry.frame);
+    }
+}
+
+void CameraCallbackGrabber::fillStats(CameraStreamStats& stats) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    stats.delivered = m_delivered;
+    stats.overwritten = m_overwritten;
+    stats.skipped = m_skipped;
+    stats.avgQueueDelayUs = m_taken > 0 ? m_queueDelaySumUs / m_taken : 0;
+}
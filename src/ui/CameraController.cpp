@@ -8,12 +8,16 @@
 CameraController::CameraController(QObject *parent) 
     : QObject(parent)
     , m_deviceHandle(nullptr)
+    , m_acquisitionMode(CameraAcquisitionMode::Polling)
     , m_isConnected(false)
     , m_isCapturing(false)
     , m_hasNewImage(false)
     , m_videoSourceManager(nullptr)
     , m_yoloDetector(nullptr)
     , m_yoloEnabled(false)
+    , m_motionGateEnabled(false)
+    , m_trackingEnabled(false)
+    , m_trackedFrameId(0)
     , m_pendingDetectionSignals(0)  // 初始化信号计数器
 {
     m_yoloDetector = new YoloDetector(this);
@@ -104,6 +108,16 @@ bool CameraController::connectCamera(int deviceIndex)
         m_deviceHandle = nullptr;
         return false;
     } // 关闭触发模式
+    m_framePool = CameraFramePool::create(m_deviceHandle);
+    if (m_acquisitionMode == CameraAcquisitionMode::Callback)
+    { // 回调模式必须在开始采集前注册，注册失败时退回轮询
+        m_callbackGrabber = std::make_unique<CameraCallbackGrabber>(m_deviceHandle, m_framePool);
+        if (!m_callbackGrabber->attach())
+        {
+            logStatus("注册帧回调失败，改用轮询取帧");
+            m_callbackGrabber.reset();
+        }
+    }
     ret = IMV_SetEnumFeatureSymbol(m_deviceHandle, "TriggerMode", "Off");
     if (ret != IMV_OK)
     {
@@ -122,16 +136,26 @@ void CameraController::disconnectCamera()
     if (m_isCapturing)
     {
         stopCapture();
+    }
+    m_currentImage.release();
+    m_hasNewImage = false;
+    m_callbackGrabber.reset();
+    bool closeNow = true;
+    if (m_framePool)
+    { // 等待下游归还 SDK 缓冲中的帧；超时时设备由缓冲池在最后一帧归还后关闭
+        closeNow = m_framePool->detach();
+        m_framePool.reset();
     } // 关闭相机
     if (m_deviceHandle)
     {
-        IMV_Close(m_deviceHandle);
-        IMV_DestroyHandle(m_deviceHandle);
+        if (closeNow)
+        {
+            IMV_Close(m_deviceHandle);
+            IMV_DestroyHandle(m_deviceHandle);
+        }
         m_deviceHandle = nullptr;
     }
     m_isConnected = false;
-    m_currentImage.release();
-    m_hasNewImage = false;
     logStatus("相机已断开连接");
 }
 bool CameraController::startCapture()
@@ -141,6 +165,7 @@ bool CameraController::startCapture()
         logStatus("相机未连接");
         return false;
     }
+    m_framePool->configureBufferCount(); // SDK 缓冲数量按流水线深度设置，须在开始采集前
     int ret = IMV_StartGrabbing(m_deviceHandle);
     if (ret != IMV_OK)
     {
@@ -157,6 +182,8 @@ bool CameraController::stopCapture()
     {
         return true;
     }
+    // 停止采集后 SDK 缓冲不再可靠，当前帧转为自有内存
+    m_currentImage = CameraFramePool::detachFrame(m_currentImage);
     int ret = IMV_StopGrabbing(m_deviceHandle);
     if (ret != IMV_OK)
     {
@@ -164,6 +191,10 @@ bool CameraController::stopCapture()
         return false;
     }
     m_isCapturing = false;
+    if (m_callbackGrabber)
+    {
+        m_callbackGrabber->clear();
+    }
     logStatus("停止采集");
     return true;
 }
@@ -187,9 +218,18 @@ bool CameraController::snapImage()
         }
     }
     
-    // 获取一帧
+    // 获取一帧（回调模式从回调队列取最新帧）
     IMV_Frame frame;
-    int ret = IMV_GetFrame(m_deviceHandle, &frame, 2000); // 增加超时时间到2秒
+    cv::Mat callbackImage;
+    int ret;
+    if (m_callbackGrabber)
+    {
+        ret = m_callbackGrabber->take(callbackImage, 2000) ? IMV_OK : IMV_TIMEOUT;
+    }
+    else
+    {
+        ret = IMV_GetFrame(m_deviceHandle, &frame, 2000); // 增加超时时间到2秒
+    }
     
     // 如果之前没有在采集，现在停止
     if (!wasCapturing && m_isCapturing == false)
@@ -203,10 +243,16 @@ bool CameraController::snapImage()
         return false;
     }
     
-    bool success = convertFrameToMat(&frame);
-    
-    // 释放帧
-    IMV_ReleaseFrame(m_deviceHandle, &frame);
+    // 临时启动的采集已经停止，此时不能继续引用 SDK 缓冲
+    bool success = true;
+    if (m_callbackGrabber)
+    {
+        m_currentImage = callbackImage;
+    }
+    else
+    {
+        success = convertFrameToMat(&frame, wasCapturing);
+    }
     
     if (success)
     {
@@ -242,17 +288,19 @@ bool CameraController::grabFrame()
         cv::Mat frame;
         if (m_videoSourceManager->grabFrame(frame))
         {
+            std::chrono::steady_clock::time_point grabTime = std::chrono::steady_clock::now();
             if (grabCounter == 1 || grabCounter % 30 == 0) {
                 qDebug() << "[CameraController::grabFrame] 成功抓取帧，尺寸:" << frame.cols << "x" << frame.rows;
             }
             
-            m_currentImage = frame.clone();
+            m_currentImage = frame;  // frame 每次新建，直接接管，无需拷贝
             m_hasNewImage = true;
             
             if (m_yoloEnabled && m_yoloDetector && m_yoloDetector->isInitialized())
             {
                 processImageWithYolo(m_currentImage);
             }
+            updateTracks(grabTime);
             
             emit imageUpdated();
             return true;
@@ -265,23 +313,38 @@ bool CameraController::grabFrame()
     }
     
     // 使用相机
-    IMV_Frame frame;
-    int ret = IMV_GetFrame(m_deviceHandle, &frame, 100); // 100ms超时
-    
-    if (ret != IMV_OK)
+    bool success = false;
+    std::chrono::steady_clock::time_point grabTime;
+    if (m_callbackGrabber)
     {
-        // 超时不记录错误，这在连续采集中是正常的
-        if (ret != -119) // -119 是超时错误
+        // 回调模式：帧到达时已入队，队列为空说明还没有新帧，不阻塞界面线程
+        cv::Mat frame;
+        if (!m_callbackGrabber->take(frame, 0, &grabTime))
         {
-            logStatus(QString("获取帧失败，错误码: %1").arg(ret));
+            return false;
         }
-        return false;
+        m_currentImage = frame;
+        success = true;
+    }
+    else
+    {
+        IMV_Frame frame;
+        int ret = IMV_GetFrame(m_deviceHandle, &frame, 100); // 100ms超时
+        
+        if (ret != IMV_OK)
+        {
+            // 超时不记录错误，这在连续采集中是正常的
+            if (ret != -119) // -119 是超时错误
+            {
+                logStatus(QString("获取帧失败，错误码: %1").arg(ret));
+            }
+            return false;
+        }
+        grabTime = std::chrono::steady_clock::now();
+        
+        // 帧的所有权交给 m_framePool，m_currentImage 释放后自动归还 SDK
+        success = convertFrameToMat(&frame);
     }
-    
-    bool success = convertFrameToMat(&frame);
-    
-    // 释放帧
-    IMV_ReleaseFrame(m_deviceHandle, &frame);
     
     if (success)
     {
@@ -290,6 +353,7 @@ bool CameraController::grabFrame()
         {
             processImageWithYolo(m_currentImage);
         }
+        updateTracks(grabTime);
         
         m_hasNewImage = true;
         emit imageUpdated();
@@ -298,6 +362,68 @@ bool CameraController::grabFrame()
     return success;
 }
 
+CameraStreamStats CameraController::getStreamStats() const
+{
+    CameraStreamStats stats;
+    if (m_isCapturing && m_deviceHandle)
+    {
+        queryCameraStreamStats(m_deviceHandle, stats);
+    }
+    if (m_callbackGrabber)
+    {
+        m_callbackGrabber->fillStats(stats);
+    }
+    return stats;
+}
+bool CameraController::applyCameraProfile(const CameraProfile &profile)
+{
+    if (!m_isConnected || m_isCapturing)
+    {
+        logStatus("请先连接相机并停止采集");
+        return false;
+    }
+    bool ok = ::applyCameraProfile(m_deviceHandle, profile);
+    logStatus(ok ? "相机配置已应用" : "相机配置未完全生效");
+    return ok;
+}
+bool CameraController::configureCameraForModel(const QRect &roi)
+{
+    if (!m_yoloDetector || m_yoloDetector->getImageWidth() <= 0 || m_yoloDetector->getImageHeight() <= 0)
+    {
+        logStatus("YOLO 模型未加载，无法按模型输入配置相机");
+        return false;
+    }
+    if (!m_isConnected || m_isCapturing)
+    {
+        logStatus("请先连接相机并停止采集");
+        return false;
+    }
+    CameraProfile profile = buildCameraProfile(m_deviceHandle, m_yoloDetector->getImageWidth(),
+                                               m_yoloDetector->getImageHeight(), roi);
+    return applyCameraProfile(profile);
+}
+bool CameraController::saveCameraProfile(const QString &path)
+{
+    if (!m_isConnected)
+    {
+        logStatus("相机未连接");
+        return false;
+    }
+    bool ok = ::saveCameraProfile(m_deviceHandle, path);
+    logStatus(ok ? QString("相机配置已保存: %1").arg(path) : QString("保存相机配置失败: %1").arg(path));
+    return ok;
+}
+bool CameraController::loadCameraProfile(const QString &path)
+{
+    if (!m_isConnected || m_isCapturing)
+    {
+        logStatus("请先连接相机并停止采集");
+        return false;
+    }
+    bool ok = ::loadCameraProfile(m_deviceHandle, path);
+    logStatus(ok ? QString("相机配置已加载: %1").arg(path) : QString("加载相机配置失败: %1").arg(path));
+    return ok;
+}
 bool CameraController::saveCurrentImage(const QString &filename)
 {
     if (m_currentImage.empty())
@@ -334,75 +460,27 @@ DeviceInfo CameraController::getDeviceInfo(int index) const
     }
     return DeviceInfo();
 }
-bool CameraController::convertFrameToMat(IMV_Frame *frame)
+bool CameraController::convertFrameToMat(IMV_Frame *frame, bool zeroCopy)
 {
-    if (!frame || !frame->pData)
+    if (!frame)
     {
         logStatus("无效的帧数据");
         return false;
     }
-    cv::Mat srcImage;
-    unsigned char *pDstData = nullptr;
     try
-    {
-        if (frame->frameInfo.pixelFormat == gvspPixelMono8)
-        { // 单色8位
-            srcImage = cv::Mat(frame->frameInfo.height, frame->frameInfo.width, CV_8UC1, frame->pData);
-        }
-        else if (frame->frameInfo.pixelFormat == gvspPixelBGR8)
-        { // BGR8位
-            srcImage = cv::Mat(frame->frameInfo.height, frame->frameInfo.width, CV_8UC3, frame->pData);
-        }
-        else
-        { // 其他格式转换为BGR8
-            pDstData = new unsigned char[frame->frameInfo.width * frame->frameInfo.height * 3];
-            IMV_PixelConvertParam stPixelConvertParam = {0};
-            stPixelConvertParam.nWidth = frame->frameInfo.width;
-            stPixelConvertParam.nHeight = frame->frameInfo.height;
-            stPixelConvertParam.ePixelFormat = frame->frameInfo.pixelFormat;
-            stPixelConvertParam.pSrcData = frame->pData;
-            stPixelConvertParam.nSrcDataLen = frame->frameInfo.size;
-            stPixelConvertParam.nPaddingX = frame->frameInfo.paddingX;
-            stPixelConvertParam.nPaddingY = frame->frameInfo.paddingY;
-            stPixelConvertParam.eBayerDemosaic = demosaicNearestNeighbor;
-            stPixelConvertParam.eDstPixelFormat = gvspPixelBGR8;
-            stPixelConvertParam.pDstBuf = pDstData;
-            stPixelConvertParam.nDstBufSize = frame->frameInfo.width * frame->frameInfo.height * 3;
-            int nRet = IMV_PixelConvert(m_deviceHandle, &stPixelConvertParam);
-            if (nRet != IMV_OK)
-            {
-                logStatus(QString("像素格式转换失败，错误码: %1").arg(nRet));
-                delete[] pDstData;
-                return false;
-            }
-            srcImage = cv::Mat(frame->frameInfo.height, frame->frameInfo.width, CV_8UC3, pDstData);
-        }
-        if (srcImage.empty())
+    { // Mono8/BGR8 直接引用 SDK 缓冲，其他格式由 SDK 转换为 BGR8 后立即归还缓冲
+        cv::Mat image = m_framePool->wrap(*frame);
+        if (image.empty())
         {
-            logStatus("创建Mat失败");
-            if (pDstData)
-                delete[] pDstData;
+            logStatus("无效的帧数据");
             return false;
-        } // 复制图像数据
-        m_currentImage = srcImage.clone();
-        if (pDstData)
-        {
-            delete[] pDstData;
         }
+        m_currentImage = zeroCopy ? image : CameraFramePool::detachFrame(image);
         return true;
     }
     catch (const cv::Exception &e)
     {
         logStatus(QString("OpenCV异常: %1").arg(e.what()));
-        if (pDstData)
-            delete[] pDstData;
-        return false;
-    }
-    catch (...)
-    {
-        logStatus("未知异常");
-        if (pDstData)
-            delete[] pDstData;
         return false;
     }
 }
@@ -417,7 +495,7 @@ bool CameraController::initializeYolo(const QString& modelPath, int parameterInd
     
     bool success = m_yoloDetector->initializeModel(modelPath, parameterIndex);
     if (success) {
-        logStatus(QString("YOLO 模型加载成功: %1").arg(modelPath));
+        onYoloModelActivated(modelPath);
     } else {
         logStatus("YOLO 模型加载失败");
     }
@@ -425,6 +503,57 @@ bool CameraController::initializeYolo(const QString& modelPath, int parameterInd
     return success;
 }
 
+bool CameraController::loadYoloModelAsync(const QString& modelPath, int parameterIndex)
+{
+    if (!m_yoloDetector) {
+        logStatus("YOLO 检测器未创建");
+        return false;
+    }
+    if (!m_yoloDetector->loadModelAsync(modelPath, parameterIndex)) {
+        logStatus("已有模型正在加载");
+        return false;
+    }
+    m_pendingModelPath = modelPath;
+    logStatus(QString("后台加载 YOLO 模型: %1").arg(modelPath));
+    return true;
+}
+
+YoloDetector::ModelLoadState CameraController::pollYoloModelLoad()
+{
+    if (!m_yoloDetector) {
+        return YoloDetector::ModelLoadState::Idle;
+    }
+    YoloDetector::ModelLoadState state = m_yoloDetector->takeModelLoadResult();
+    if (state == YoloDetector::ModelLoadState::Succeeded) {
+        onYoloModelActivated(m_pendingModelPath);
+    }
+    else if (state == YoloDetector::ModelLoadState::Failed) {
+        logStatus(QString("YOLO 模型加载失败，继续使用当前模型: %1").arg(m_pendingModelPath));
+    }
+    return state;
+}
+
+void CameraController::onYoloModelActivated(const QString& modelPath)
+{
+    // 在途帧上限取检测器的推理槽位数，统计从新模型重新开始
+    InferenceRateController::Config rateConfig = m_rateController.config();
+    rateConfig.maxInFlight = m_yoloDetector->getMaxInFlight();
+    m_rateController.setConfig(rateConfig);
+    m_rateController.reset();
+    // 类别定义可能随模型变化，轨迹从新模型的结果重新建立
+    m_tracker.reset();
+    m_trackedFrameId = m_yoloDetector->getLatestResultFrameId();
+    m_currentTracks.clear();
+    logStatus(QString("YOLO 模型加载成功: %1").arg(modelPath));
+    WarmupReport warmup = m_yoloDetector->getWarmupReport();
+    if (warmup.runs > 0) {
+        logStatus(QString("模型预热 %1 次: 首次 %2 ms, 预热后 %3 ms")
+                  .arg(warmup.runs)
+                  .arg(warmup.coldMs, 0, 'f', 1)
+                  .arg(warmup.warmMs, 0, 'f', 1));
+    }
+}
+
 void CameraController::processImageWithYolo(cv::Mat& image)
 {
     static int totalFrames = 0;
@@ -445,6 +574,39 @@ void CameraController::processImageWithYolo(cv::Mat& image)
         return;
     }
     
+    // 画面静止时不推理，界面继续显示上次的检测结果（静止期间按 refreshInterval 定期刷新）
+    if (m_motionGateEnabled && !m_motionGate.update(image)) {
+        return;
+    }
+    
+    // 按实测延迟决定本帧是否推理；未提交的帧仍正常显示（叠加最近一次的检测结果）
+    uint64_t completed = 0;
+    double latencySumMs = 0;
+    m_yoloDetector->getAsyncTiming(completed, latencySumMs);
+    if (m_rateController.update(completed, latencySumMs, m_yoloDetector->getNpuTimeMs())) {
+        InferenceRateStatus rate = m_rateController.status();
+        QString modeText = rate.mode == InferenceRateMode::EveryFrame ? QString("每帧推理")
+            : rate.mode == InferenceRateMode::LatestOnly ? QString("仅推理最新帧")
+            : QString("每 %1 帧推理一次").arg(rate.stride);
+        if (rate.budgetUnattainable) {
+            logStatus(QString("延迟预算无法达到：%1时延迟 %2 ms（NPU %3 ms）仍超出预算 %4 ms，降频无法改善")
+                      .arg(modeText)
+                      .arg(rate.latencyMs, 0, 'f', 1)
+                      .arg(rate.npuTimeMs, 0, 'f', 1)
+                      .arg(rate.budgetMs, 0, 'f', 0));
+        }
+        else {
+            logStatus(QString("推理速率调整为%1（延迟 %2 ms，NPU %3 ms，预算 %4 ms）")
+                      .arg(modeText)
+                      .arg(rate.latencyMs, 0, 'f', 1)
+                      .arg(rate.npuTimeMs, 0, 'f', 1)
+                      .arg(rate.budgetMs, 0, 'f', 0));
+        }
+    }
+    if (!m_rateController.shouldSubmit(m_yoloDetector->getInFlightCount())) {
+        return;
+    }
+    
     processedFrames++;
     
     // 只在第一帧和每30帧打印详细日志，减少输出
@@ -462,6 +624,9 @@ void CameraController::processImageWithYolo(cv::Mat& image)
         }
         
         bool success = m_yoloDetector->detectAsync(image);
+        if (success && m_motionGateEnabled) {
+            m_motionGate.markSubmitted();
+        }
         
         if (verboseLog) {
             if (success) {
@@ -481,6 +646,56 @@ void CameraController::processImageWithYolo(cv::Mat& image)
         m_latestDetections.clear();
     }
 }
+void CameraController::enableMotionGating(bool enable)
+{
+    if (enable && !m_motionGateEnabled) {
+        m_motionGate.reset();
+    }
+    m_motionGateEnabled = enable;
+    qDebug() << "[CAMERA] 运动门控:" << (enable ? "启用" : "关闭");
+}
+
+void CameraController::enableTracking(bool enable)
+{
+    if (enable && !m_trackingEnabled) {
+        m_tracker.reset();
+        m_trackedFrameId = m_yoloDetector ? m_yoloDetector->getLatestResultFrameId() : 0;
+        m_currentTracks.clear();
+    }
+    m_trackingEnabled = enable;
+    qDebug() << "[CAMERA] 目标跟踪:" << (enable ? "启用" : "关闭");
+}
+
+void CameraController::updateTracks(std::chrono::steady_clock::time_point grabTime)
+{
+    if (!m_trackingEnabled || !m_yoloEnabled || !m_yoloDetector || !m_yoloDetector->isInitialized()) {
+        m_currentTracks.clear();
+        return;
+    }
+
+    // 新的检测结果按其帧的提交时间更新跟踪器；结果晚于采集到达，当前帧位置由外推得到。
+    // 外推到所显示帧的采集时刻而不是现在，否则处理和排队的耗时会让框跑到画面前面
+    auto toSeconds = [](std::chrono::steady_clock::time_point time) {
+        return std::chrono::duration<double>(time.time_since_epoch()).count();
+    };
+    uint64_t frameId = 0;
+    std::chrono::steady_clock::time_point submitTime;
+    std::vector<BoundingBox> detections = m_yoloDetector->getLatestResults(frameId, submitTime);
+    if (frameId > m_trackedFrameId) {
+        m_tracker.update(detections, toSeconds(submitTime));
+        m_trackedFrameId = frameId;
+    }
+    m_currentTracks = m_tracker.predict(toSeconds(grabTime));
+}
+
+void CameraController::setInferenceLatencyBudget(double budgetMs)
+{
+    InferenceRateController::Config rateConfig = m_rateController.config();
+    rateConfig.latencyBudgetMs = budgetMs;
+    m_rateController.setConfig(rateConfig);
+    qDebug() << "[CAMERA] 推理延迟预算:" << budgetMs << "ms";
+}
+
 void CameraController::logStatus(const QString &message)
 {
     qDebug() << message;
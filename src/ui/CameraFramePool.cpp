@@ -0,0 +1,215 @@
+#include "CameraFramePool.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+
+// 帧缓冲的持有者，挂在 UMatData::userdata 上，最后一个 Mat 释放时销毁
+struct CameraFramePool::FrameRef
+{
+    std::shared_ptr<CameraFramePool> pool;
+    IMV_Frame frame;
+};
+
+// 只负责 SDK 帧的释放；引用计数由 cv::Mat 自身的 UMatData 维护
+// Mat::create 需要重新分配时交给标准分配器，新内存与 SDK 无关
+class CameraFramePool::FrameAllocator : public cv::MatAllocator
+{
+public:
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(data, accessFlags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* u) const override
+    {
+        if (!u) {
+            return;
+        }
+        auto* ref = static_cast<FrameRef*>(u->userdata);
+        if (ref) {
+            ref->pool->release(ref->frame);
+            delete ref;
+        }
+        delete u;
+    }
+};
+
+const CameraFramePool::FrameAllocator& CameraFramePool::allocator()
+{
+    static FrameAllocator instance;
+    return instance;
+}
+
+std::shared_ptr<CameraFramePool> CameraFramePool::create(IMV_HANDLE handle)
+{
+    return std::shared_ptr<CameraFramePool>(new CameraFramePool(handle));
+}
+
+CameraFramePool::CameraFramePool(IMV_HANDLE handle)
+    : m_handle(handle)
+    , m_outstanding(0)
+    , m_closePending(false)
+{
+}
+
+bool CameraFramePool::configureBufferCount(unsigned int pipelineDepth)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_handle) {
+        return false;
+    }
+    unsigned int count = pipelineDepth + kSdkReceiveBuffers;
+    int ret = IMV_SetBufferCount(m_handle, count);
+    if (ret != IMV_OK) {
+        qWarning() << "[FRAME POOL] 设置 SDK 缓冲数量失败，错误码:" << ret << "(请求" << count << ")";
+        return false;
+    }
+    qDebug() << "[FRAME POOL] SDK 缓冲数量:" << count << "(流水线深度" << pipelineDepth << ")";
+    return true;
+}
+
+cv::Mat CameraFramePool::wrap(IMV_Frame& frame)
+{
+    m_outstanding.fetch_add(1, std::memory_order_relaxed);
+    if (!frame.pData) {
+        release(frame);
+        return cv::Mat();
+    }
+
+    int type = -1;
+    if (frame.frameInfo.pixelFormat == gvspPixelMono8) {
+        type = CV_8UC1;
+    }
+    else if (frame.frameInfo.pixelFormat == gvspPixelBGR8) {
+        type = CV_8UC3;
+    }
+    if (type < 0) {
+        return convert(frame);
+    }
+
+    int width = (int)frame.frameInfo.width;
+    int height = (int)frame.frameInfo.height;
+    size_t step = (size_t)(width + frame.frameInfo.paddingX) * CV_ELEM_SIZE(type);
+    cv::Mat image(height, width, type, frame.pData, step);
+
+    // 给外部数据挂上引用计数：refcount 归零时 FrameAllocator::deallocate 归还 SDK 缓冲
+    auto* ref = new FrameRef{ shared_from_this(), frame };
+    auto* u = new cv::UMatData(&allocator());
+    u->data = u->origdata = frame.pData;
+    u->size = step * height;
+    u->refcount = 1;
+    u->userdata = ref;
+    image.u = u;
+    return image;
+}
+
+cv::Mat CameraFramePool::convert(IMV_Frame& frame)
+{
+    // 其他格式（Bayer/RGB8 等）由 SDK 直接转换到自有内存，转换完立即归还缓冲
+    cv::Mat image = pixelConvert(frame);
+    release(frame);
+    return image;
+}
+
+bool CameraFramePool::clone(IMV_Frame& frame, IMV_Frame& out)
+{
+    if (!frame.pData) {
+        return false;
+    }
+    // 只拷贝原始数据（Bayer 为单通道），格式转换推迟到 wrap()，只对真正被取走的帧进行
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_handle) {
+        return false;
+    }
+    int ret = IMV_CloneFrame(m_handle, &frame, &out);
+    if (ret != IMV_OK) {
+        qWarning() << "[FRAME POOL] 克隆帧失败，错误码:" << ret;
+        return false;
+    }
+    m_outstanding.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+cv::Mat CameraFramePool::pixelConvert(const IMV_Frame& frame)
+{
+    cv::Mat image((int)frame.frameInfo.height, (int)frame.frameInfo.width, CV_8UC3);
+    IMV_PixelConvertParam param = { 0 };
+    param.nWidth = frame.frameInfo.width;
+    param.nHeight = frame.frameInfo.height;
+    param.ePixelFormat = frame.frameInfo.pixelFormat;
+    param.pSrcData = frame.pData;
+    param.nSrcDataLen = frame.frameInfo.size;
+    param.nPaddingX = frame.frameInfo.paddingX;
+    param.nPaddingY = frame.frameInfo.paddingY;
+    param.eBayerDemosaic = demosaicNearestNeighbor;
+    param.eDstPixelFormat = gvspPixelBGR8;
+    param.pDstBuf = image.data;
+    param.nDstBufSize = (unsigned int)(image.total() * image.elemSize());
+
+    int ret;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ret = m_handle ? IMV_PixelConvert(m_handle, &param) : IMV_INVALID_HANDLE;
+    }
+    if (ret != IMV_OK) {
+        qWarning() << "[FRAME POOL] 像素格式转换失败，错误码:" << ret << "格式:" << frame.frameInfo.pixelFormat;
+        return cv::Mat();
+    }
+    return image;
+}
+
+void CameraFramePool::release(IMV_Frame& frame)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_handle) {
+        IMV_ReleaseFrame(m_handle, &frame);
+    }
+    if (m_outstanding.fetch_sub(1, std::memory_order_relaxed) != 1) {
+        return;
+    }
+    m_released.notify_all();
+    if (m_closePending) {
+        // detach 超时后最后一帧已归还，缓冲不再被引用，此时才关闭设备
+        IMV_Close(m_handle);
+        IMV_DestroyHandle(m_handle);
+        m_handle = nullptr;
+        m_closePending = false;
+        qInfo() << "[FRAME POOL] 延迟关闭的设备已关闭（全部帧已归还）";
+    }
+}
+
+bool CameraFramePool::detach(int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_handle) {
+        return true;
+    }
+    m_released.wait_for(lock, std::chrono::milliseconds(std::max(timeoutMs, 0)), [this] {
+        return m_outstanding.load(std::memory_order_relaxed) == 0;
+    });
+    int remaining = m_outstanding.load(std::memory_order_relaxed);
+    if (remaining > 0) {
+        // 这些帧的数据仍指向 SDK 缓冲，IMV_Close 会释放它们；保留句柄，最后一帧归还时再关闭
+        qWarning() << "[FRAME POOL] 等待" << timeoutMs << "ms 后仍有" << remaining << "帧未归还，延迟关闭设备";
+        m_closePending = true;
+        return false;
+    }
+    m_handle = nullptr;
+    return true;
+}
+
+bool CameraFramePool::isPoolFrame(const cv::Mat& image)
+{
+    return image.u && image.u->currAllocator == &allocator();
+}
+
+cv::Mat CameraFramePool::detachFrame(const cv::Mat& image)
+{
+    return isPoolFrame(image) ? image.clone() : image;
+}
@@ -0,0 +1,237 @@
+#include "CameraProfile.h"
+#include <QDebug>
+#include <QStringList>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+int64_t getIntFeature(IMV_HANDLE handle, const char* name, int64_t defaultValue)
+{
+    int64_t value = 0;
+    if (!IMV_FeatureIsReadable(handle, name) || IMV_GetIntFeatureValue(handle, name, &value) != IMV_OK) {
+        return defaultValue;
+    }
+    return value;
+}
+
+int64_t getIntFeatureMax(IMV_HANDLE handle, const char* name, int64_t defaultValue)
+{
+    int64_t value = 0;
+    if (!IMV_FeatureIsAvailable(handle, name) || IMV_GetIntFeatureMax(handle, name, &value) != IMV_OK) {
+        return defaultValue;
+    }
+    return value;
+}
+
+// 按相机给出的范围和步进对齐后写入（GenICam 的 Width/OffsetX 等通常有 4/8/16 的步进）
+bool setIntFeatureAligned(IMV_HANDLE handle, const char* name, int64_t value)
+{
+    if (!IMV_FeatureIsWriteable(handle, name)) {
+        qWarning() << "[CAMERA PROFILE]" << name << "不可写";
+        return false;
+    }
+    int64_t minValue = 0, maxValue = 0, inc = 1;
+    IMV_GetIntFeatureMin(handle, name, &minValue);
+    IMV_GetIntFeatureMax(handle, name, &maxValue);
+    IMV_GetIntFeatureInc(handle, name, &inc);
+    if (inc <= 0) {
+        inc = 1;
+    }
+    value = std::max(minValue, std::min(value, maxValue));
+    value = minValue + (value - minValue) / inc * inc;
+
+    int ret = IMV_SetIntFeatureValue(handle, name, value);
+    if (ret != IMV_OK) {
+        qWarning() << "[CAMERA PROFILE] 设置" << name << "=" << value << "失败，错误码:" << ret;
+        return false;
+    }
+    return true;
+}
+
+QStringList getEnumSymbols(IMV_HANDLE handle, const char* name)
+{
+    QStringList symbols;
+    unsigned int count = 0;
+    if (!IMV_FeatureIsAvailable(handle, name) || IMV_GetEnumFeatureEntryNum(handle, name, &count) != IMV_OK || count == 0) {
+        return symbols;
+    }
+    std::vector<IMV_EnumEntryInfo> entries(count);
+    IMV_EnumEntryList list;
+    list.nEnumEntryBufferSize = (unsigned int)(sizeof(IMV_EnumEntryInfo) * count);
+    list.pEnumEntryInfo = entries.data();
+    if (IMV_GetEnumFeatureEntrys(handle, name, &list) != IMV_OK) {
+        return symbols;
+    }
+    for (const auto& entry : entries) {
+        symbols.append(QString::fromLatin1(entry.name));
+    }
+    return symbols;
+}
+
+} // namespace
+
+CameraProfile readCameraProfile(IMV_HANDLE handle)
+{
+    CameraProfile profile;
+    profile.offsetX = (int)getIntFeature(handle, "OffsetX", 0);
+    profile.offsetY = (int)getIntFeature(handle, "OffsetY", 0);
+    profile.width = (int)getIntFeature(handle, "Width", 0);
+    profile.height = (int)getIntFeature(handle, "Height", 0);
+    profile.binningHorizontal = (int)getIntFeature(handle, "BinningHorizontal", 1);
+    profile.binningVertical = (int)getIntFeature(handle, "BinningVertical", 1);
+
+    IMV_String symbol;
+    memset(&symbol, 0, sizeof(symbol));
+    if (IMV_GetEnumFeatureSymbol(handle, "PixelFormat", &symbol) == IMV_OK) {
+        profile.pixelFormat = QString::fromLatin1(symbol.str);
+    }
+    return profile;
+}
+
+CameraProfile buildCameraProfile(IMV_HANDLE handle, int modelWidth, int modelHeight, const QRect& roi, bool preferBayer)
+{
+    CameraProfile current = readCameraProfile(handle);
+
+    // 全分辨率传感器尺寸：优先 SensorWidth/SensorHeight，否则用 WidthMax 乘以当前合并倍数还原
+    int64_t sensorWidth = getIntFeature(handle, "SensorWidth", 0);
+    int64_t sensorHeight = getIntFeature(handle, "SensorHeight", 0);
+    if (sensorWidth <= 0 || sensorHeight <= 0) {
+        sensorWidth = getIntFeature(handle, "WidthMax", getIntFeatureMax(handle, "Width", current.width) + current.offsetX)
+            * std::max(current.binningHorizontal, 1);
+        sensorHeight = getIntFeature(handle, "HeightMax", getIntFeatureMax(handle, "Height", current.height) + current.offsetY)
+            * std::max(current.binningVertical, 1);
+    }
+    QRect sensorRect(0, 0, (int)sensorWidth, (int)sensorHeight);
+    QRect area = roi.isEmpty() ? sensorRect : roi.intersected(sensorRect);
+    if (area.isEmpty()) {
+        qWarning() << "[CAMERA PROFILE] ROI 超出传感器范围，改用全幅:" << roi << sensorRect;
+        area = sensorRect;
+    }
+
+    // letterbox 的缩放比例是 min(模型/图像)，合并倍数不超过其倒数时模型输入分辨率不受影响
+    int binning = 1;
+    if (modelWidth > 0 && modelHeight > 0
+        && IMV_FeatureIsWriteable(handle, "BinningHorizontal") && IMV_FeatureIsWriteable(handle, "BinningVertical")) {
+        double maxBinning = std::max((double)area.width() / modelWidth, (double)area.height() / modelHeight);
+        int64_t binningLimit = std::min(getIntFeatureMax(handle, "BinningHorizontal", 1),
+                                        getIntFeatureMax(handle, "BinningVertical", 1));
+        for (int candidate : { 4, 2 }) {
+            if (candidate <= maxBinning && candidate <= binningLimit) {
+                binning = candidate;
+                break;
+            }
+        }
+    }
+
+    CameraProfile profile;
+    profile.binningHorizontal = binning;
+    profile.binningVertical = binning;
+    profile.offsetX = area.x() / binning;
+    profile.offsetY = area.y() / binning;
+    profile.width = area.width() / binning;
+    profile.height = area.height() / binning;
+
+    // BGR8/Mono8 可被 CameraFramePool 零拷贝包装；Bayer 8 位每像素 1 字节，但要由 SDK 在主机端逐帧插值
+    QStringList formats = getEnumSymbols(handle, "PixelFormat");
+    const QStringList bayer = { "BayerRG8", "BayerGB8", "BayerGR8", "BayerBG8" };
+    QStringList candidates = preferBayer ? bayer + QStringList{ "BGR8" } : QStringList{ "BGR8" } + bayer;
+    candidates << "Mono8";
+    for (const QString& format : candidates) {
+        if (formats.contains(format)) {
+            profile.pixelFormat = format;
+            break;
+        }
+    }
+
+    qDebug() << "[CAMERA PROFILE] 模型输入" << modelWidth << "x" << modelHeight
+             << ", 传感器" << sensorWidth << "x" << sensorHeight << ", ROI" << area
+             << "-> 合并" << binning << ", 输出" << profile.width << "x" << profile.height
+             << ", 像素格式" << (profile.pixelFormat.isEmpty() ? current.pixelFormat : profile.pixelFormat);
+    return profile;
+}
+
+bool applyCameraProfile(IMV_HANDLE handle, const CameraProfile& profile)
+{
+    bool ok = true;
+
+    // 先把偏移清零，否则增大宽高时会超出范围；合并倍数会改变宽高范围，需在宽高之前设置
+    if (IMV_FeatureIsWriteable(handle, "OffsetX")) {
+        ok &= setIntFeatureAligned(handle, "OffsetX", 0);
+    }
+    if (IMV_FeatureIsWriteable(handle, "OffsetY")) {
+        ok &= setIntFeatureAligned(handle, "OffsetY", 0);
+    }
+    if (IMV_FeatureIsAvailable(handle, "BinningHorizontal")) {
+        ok &= setIntFeatureAligned(handle, "BinningHorizontal", profile.binningHorizontal);
+    }
+    if (IMV_FeatureIsAvailable(handle, "BinningVertical")) {
+        ok &= setIntFeatureAligned(handle, "BinningVertical", profile.binningVertical);
+    }
+    if (!profile.pixelFormat.isEmpty()) {
+        int ret = IMV_SetEnumFeatureSymbol(handle, "PixelFormat", profile.pixelFormat.toLatin1().constData());
+        if (ret != IMV_OK) {
+            qWarning() << "[CAMERA PROFILE] 设置 PixelFormat =" << profile.pixelFormat << "失败，错误码:" << ret;
+            ok = false;
+        }
+    }
+    ok &= setIntFeatureAligned(handle, "Width", profile.width > 0 ? profile.width : INT64_MAX);
+    ok &= setIntFeatureAligned(handle, "Height", profile.height > 0 ? profile.height : INT64_MAX);
+    if (profile.offsetX > 0) {
+        ok &= setIntFeatureAligned(handle, "OffsetX", profile.offsetX);
+    }
+    if (profile.offsetY > 0) {
+        ok &= setIntFeatureAligned(handle, "OffsetY", profile.offsetY);
+    }
+
+    CameraProfile applied = readCameraProfile(handle);
+    qInfo() << "[CAMERA PROFILE] 当前配置:" << applied.width << "x" << applied.height
+            << "@" << applied.offsetX << "," << applied.offsetY
+            << ", 合并" << applied.binningHorizontal << "x" << applied.binningVertical
+            << "," << applied.pixelFormat;
+    return ok;
+}
+
+bool applyCameraProfileRequest(IMV_HANDLE handle, const CameraProfileRequest& request)
+{
+    bool ok = true;
+    if (!request.loadPath.isEmpty()) {
+        ok = loadCameraProfile(handle, request.loadPath);
+    }
+    else if (request.modelWidth > 0 && request.modelHeight > 0) {
+        ok = applyCameraProfile(handle, buildCameraProfile(handle, request.modelWidth, request.modelHeight, request.roi,
+                                                           request.preferBayer));
+    }
+    if (ok && !request.savePath.isEmpty()) {
+        ok = saveCameraProfile(handle, request.savePath);
+    }
+    return ok;
+}
+
+bool saveCameraProfile(IMV_HANDLE handle, const QString& path)
+{
+    int ret = IMV_SaveDeviceCfg(handle, path.toLocal8Bit().constData());
+    if (ret != IMV_OK) {
+        qWarning() << "[CAMERA PROFILE] 保存相机配置失败:" << path << ", 错误码:" << ret;
+        return false;
+    }
+    qInfo() << "[CAMERA PROFILE] 相机配置已保存:" << path;
+    return true;
+}
+
+bool loadCameraProfile(IMV_HANDLE handle, const QString& path)
+{
+    IMV_ErrorList errors;
+    memset(&errors, 0, sizeof(errors));
+    int ret = IMV_LoadDeviceCfg(handle, path.toLocal8Bit().constData(), &errors);
+    if (ret != IMV_OK) {
+        qWarning() << "[CAMERA PROFILE] 加载相机配置失败:" << path << ", 错误码:" << ret;
+        for (unsigned int i = 0; i < errors.nParamCnt && i < IMV_MAX_ERROR_LIST_NUM; i++) {
+            qWarning() << "[CAMERA PROFILE]   加载失败的属性:" << errors.paramNameList[i].str;
+        }
+        return false;
+    }
+    qInfo() << "[CAMERA PROFILE] 相机配置已加载:" << path;
+    return true;
+}
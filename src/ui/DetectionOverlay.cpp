@@ -0,0 +1,102 @@
+#include "DetectionOverlay.h"
+#include <QPainter>
+#include "yolo/label_cache.h"
+#include <algorithm>
+#include <string>
+
+namespace
+{
+    // COCO dataset class names
+    const std::vector<std::string>& classNames()
+    {
+        static const std::vector<std::string> names = {
+            "person", "bicycle", "car", "motorcycle", "airplane", "bus", "train", "truck", "boat",
+            "traffic light", "fire hydrant", "stop sign", "parking meter", "bench", "bird", "cat",
+            "dog", "horse", "sheep", "cow", "elephant", "bear", "zebra", "giraffe", "backpack",
+            "umbrella", "handbag", "tie", "suitcase", "frisbee", "skis", "snowboard", "sports ball",
+            "kite", "baseball bat", "baseball glove", "skateboard", "surfboard", "tennis racket",
+            "bottle", "wine glass", "cup", "fork", "knife", "spoon", "bowl", "banana", "apple",
+            "sandwich", "orange", "broccoli", "carrot", "hot dog", "pizza", "donut", "cake", "chair",
+            "couch", "potted plant", "bed", "dining table", "toilet", "tv", "laptop", "mouse",
+            "remote", "keyboard", "cell phone", "microwave", "oven", "toaster", "sink",
+            "refrigerator", "book", "clock", "vase", "scissors", "teddy bear", "hair drier",
+            "toothbrush"
+        };
+        return names;
+    }
+
+    // 标签：类别颜色背景、白色文字，"person: 87%"
+    LabelSpriteCache& labelCache()
+    {
+        static LabelSpriteCache cache([] {
+            LabelStyle style;
+            style.fontScale = 0.5;
+            style.separator = ": ";
+            style.scoreFormat = LabelScoreFormat::Percent;
+            return style;
+        }());
+        return cache;
+    }
+
+    // 不同类别的颜色（与原 OpenCV 绘制时的 BGR 颜色一致）
+    const QColor kColors[] = {
+        QColor(0, 0, 255),      // 蓝色
+        QColor(0, 255, 0),      // 绿色
+        QColor(255, 0, 0),      // 红色
+        QColor(0, 255, 255),    // 青色
+        QColor(255, 0, 255),    // 品红
+        QColor(255, 255, 0),    // 黄色
+    };
+}
+
+QImage DetectionOverlay::render(cv::Mat& preview, const cv::Size& frameSize, const std::vector<BoundingBox>& detections)
+{
+    if (preview.empty() || preview.type() != CV_8UC3 || frameSize.width <= 0 || frameSize.height <= 0) {
+        return QImage();
+    }
+    QImage image(preview.data, preview.cols, preview.rows, static_cast<int>(preview.step), QImage::Format_BGR888);
+    drawDetections(image, detections, (double)preview.cols / frameSize.width, (double)preview.rows / frameSize.height);
+    return image;
+}
+
+void DetectionOverlay::drawDetections(QImage& image, const std::vector<BoundingBox>& detections, double scaleX, double scaleY)
+{
+    if (detections.empty() || image.isNull()) {
+        return;
+    }
+
+    // 标签精灵直接混合到像素上，只支持 BGR888 和 32 位格式（内存顺序都是 B G R [A]）
+    cv::Mat pixels;
+    if (image.format() == QImage::Format_BGR888) {
+        pixels = cv::Mat(image.height(), image.width(), CV_8UC3, image.bits(), image.bytesPerLine());
+    }
+    else if (image.depth() == 32) {
+        pixels = cv::Mat(image.height(), image.width(), CV_8UC4, image.bits(), image.bytesPerLine());
+    }
+
+    QPainter painter(&image);
+    painter.setBrush(Qt::NoBrush);
+    for (const auto& box : detections)
+    {
+        // BoundingBox结构: box[0]=x1, box[1]=y1, box[2]=x2, box[3]=y2（采集帧坐标）
+        QRectF rect(QPointF(box.box[0] * scaleX, box.box[1] * scaleY),
+                    QPointF(box.box[2] * scaleX, box.box[3] * scaleY));
+        painter.setPen(QPen(kColors[std::abs(box.label) % (sizeof(kColors) / sizeof(kColors[0]))], 2));
+        painter.drawRect(rect);
+    }
+    painter.end();
+
+    if (pixels.empty()) {
+        return;
+    }
+    for (const auto& box : detections)
+    {
+        const QColor& color = kColors[std::abs(box.label) % (sizeof(kColors) / sizeof(kColors[0]))];
+        static const std::string kUnknown("Object");
+        const std::string& className = !box.labelname.empty() ? box.labelname
+            : box.label >= 0 && box.label < static_cast<int>(classNames().size()) ? classNames()[box.label]
+            : kUnknown;
+        labelCache().draw(pixels, cv::Point((int)(box.box[0] * scaleX), (int)(box.box[1] * scaleY)), className, box.score,
+                          cv::Scalar(255, 255, 255), cv::Scalar(color.blue(), color.green(), color.red()));
+    }
+}
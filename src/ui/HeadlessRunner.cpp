@@ -0,0 +1,683 @@
+#include "HeadlessRunner.h"
+#include "VideoSource.h"
+#include "YoloDetector.h"
+#include "InferenceBackend.h"
+#include "MultiStreamPipeline.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <algorithm>
+
+HeadlessRunner::HeadlessRunner(const HeadlessOptions& options, QObject* parent)
+    : QObject(parent)
+    , m_options(options)
+    , m_sourceManager(new VideoSourceManager(this))
+    , m_detector(new YoloDetector(this))
+    , m_tickTimer(new QTimer(this))
+    , m_statsTimer(new QTimer(this))
+    , m_inFlight(false)
+    , m_inFlightFrameId(0)
+    , m_stopRequested(false)
+    , m_finished(false)
+    , m_pipelineCompleted(0)
+{
+    // 等待推理结果时以 1ms 轮询（与 MainWindow 一样使用轮询模式，不依赖跨线程信号）
+    m_tickTimer->setTimerType(Qt::PreciseTimer);
+    m_tickTimer->setInterval(1);
+    connect(m_tickTimer, &QTimer::timeout, this, &HeadlessRunner::onTick);
+    connect(m_statsTimer, &QTimer::timeout, this, &HeadlessRunner::onStatsTimer);
+    m_motionGate.setConfig(m_options.motionGateConfig);
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    m_tickTimer->stop();
+    m_statsTimer->stop();
+    if (m_pipeline) {
+        m_pipeline->stop();
+    }
+    if (m_detector->isRecording()) {
+        m_detector->stopRecording();
+    }
+    m_sourceManager->closeSource();
+}
+
+bool HeadlessRunner::start()
+{
+    if (!m_options.streams.isEmpty()) {
+        return startMultiStream();
+    }
+
+    // 先加载模型：相机自动配置需要模型输入尺寸
+    if (!initializeDetector() || !openSource()) {
+        return false;
+    }
+
+    if (!openResultsFile()) {
+        return false;
+    }
+
+    if (!m_options.recordPath.isEmpty() && !m_detector->startRecording(m_options.recordPath)) {
+        return false;
+    }
+
+    m_runTimer.start();
+    m_intervalTimer.start();
+    m_tickTimer->start();
+    if (m_options.statsIntervalMs > 0) {
+        m_statsTimer->start(m_options.statsIntervalMs);
+    }
+    qInfo() << "[HEADLESS] 开始运行: source =" << m_options.source
+            << ", 时长" << m_options.durationSec << "s, 帧数上限" << m_options.maxFrames;
+    return true;
+}
+
+bool HeadlessRunner::openResultsFile()
+{
+    if (m_options.resultsPath.isEmpty()) {
+        return true;
+    }
+    m_resultsFile = std::make_unique<QFile>(m_options.resultsPath);
+    if (!m_resultsFile->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qCritical() << "[HEADLESS] 无法创建结果文件:" << m_options.resultsPath;
+        return false;
+    }
+    m_resultsStream = std::make_unique<QTextStream>(m_resultsFile.get());
+    return true;
+}
+
+bool HeadlessRunner::startMultiStream()
+{
+    YoloParam config;
+    if (!YoloDetector::getParameterConfig(m_options.parameterIndex, config)) {
+        qCritical() << "[HEADLESS] 无效的参数索引:" << m_options.parameterIndex;
+        return false;
+    }
+    auto backend = createBackend();
+    if (!backend) {
+        return false;
+    }
+    if (!m_options.recordPath.isEmpty()) {
+        qWarning() << "[HEADLESS] 多路模式不支持录制输出张量，忽略 --record";
+    }
+
+    m_pipeline = std::make_unique<MultiStreamPipeline>(m_options.maxInFlight);
+    if (!m_pipeline->initialize(std::move(backend), config)) {
+        return false;
+    }
+    m_pipeline->setBatching(m_options.batchSize, m_options.batchWindowUs);
+
+    QStringList sources;
+    QList<int> weights;
+    for (int i = 0; i < m_options.streams.size(); i++) {
+        int weight = i < m_options.streamWeights.size() ? m_options.streamWeights[i] : 1;
+        QStringList expanded = m_options.streams[i] == "camera:all"
+            ? MultiStreamPipeline::enumerateCameraSources() : QStringList{ m_options.streams[i] };
+        for (const QString& source : expanded) {
+            sources.append(source);
+            weights.append(weight);
+        }
+    }
+    for (int i = 0; i < sources.size(); i++) {
+        StreamSpec spec;
+        spec.source = sources[i];
+        spec.weight = weights[i];
+        spec.loop = m_options.loop;
+        spec.decoderOptions = m_options.videoDecoder;
+        spec.sequenceOptions = m_options.imageSequence;
+        spec.acquisition = m_options.acquisition == "callback"
+            ? CameraAcquisitionMode::Callback : CameraAcquisitionMode::Polling;
+        spec.profileRequest.loadPath = m_options.cameraProfilePath;
+        spec.profileRequest.roi = m_options.cameraRoi;
+        spec.motionGate = m_options.motionGate;
+        spec.motionGateConfig = m_options.motionGateConfig;
+        if (m_options.cameraAutoProfile || !m_options.cameraRoi.isEmpty()) {
+            spec.profileRequest.modelWidth = config.width;
+            spec.profileRequest.modelHeight = config.height;
+        }
+        if (m_pipeline->addStream(spec) < 0) {
+            return false;
+        }
+    }
+    if (m_pipeline->streamCount() == 0) {
+        qCritical() << "[HEADLESS] 没有可用的视频源";
+        return false;
+    }
+
+    if (!openResultsFile()) {
+        return false;
+    }
+    m_pipeline->setResultCallback(
+        [this](int stream, uint64_t frameId, const QString& input, const std::vector<BoundingBox>& results,
+               double latencyMs)
+        {
+            m_pipelineCompleted++;
+            if (m_resultsStream) {
+                std::lock_guard<std::mutex> lock(m_resultsMutex);
+                writeResults(frameId, latencyMs, results, stream, input);
+            }
+        });
+    if (!m_pipeline->start()) {
+        return false;
+    }
+
+    // 多路模式下推理由流水线线程驱动，定时器只检查退出条件
+    m_runTimer.start();
+    m_intervalTimer.start();
+    m_tickTimer->setInterval(50);
+    m_tickTimer->start();
+    if (m_options.statsIntervalMs > 0) {
+        m_statsTimer->start(m_options.statsIntervalMs);
+    }
+    qInfo() << "[HEADLESS] 开始运行（多路）:" << m_pipeline->streamCount() << "路"
+            << ", 时长" << m_options.durationSec << "s, 帧数上限" << m_options.maxFrames;
+    return true;
+}
+
+bool HeadlessRunner::openSource()
+{
+    bool ok = false;
+    if (m_options.source.startsWith("camera:")) {
+        int deviceIndex = m_options.source.mid(7).toInt();
+        CameraAcquisitionMode mode = m_options.acquisition == "callback"
+            ? CameraAcquisitionMode::Callback : CameraAcquisitionMode::Polling;
+        CameraProfileRequest profileRequest;
+        profileRequest.loadPath = m_options.cameraProfilePath;
+        profileRequest.savePath = m_options.cameraProfileSavePath;
+        profileRequest.roi = m_options.cameraRoi;
+        if (m_options.cameraAutoProfile || !m_options.cameraRoi.isEmpty()) {
+            profileRequest.modelWidth = m_detector->getImageWidth();
+            profileRequest.modelHeight = m_detector->getImageHeight();
+        }
+        ok = m_sourceManager->openCamera(deviceIndex, mode, profileRequest);
+    }
+    else if (V4l2CaptureOptions::isV4l2Source(m_options.source)) {
+        V4l2CaptureOptions v4l2Options;
+        QString error;
+        if (!V4l2CaptureOptions::parse(m_options.source, v4l2Options, &error)) {
+            qCritical() << "[HEADLESS] V4L2 源参数错误:" << error;
+            return false;
+        }
+        ok = m_sourceManager->openV4l2(v4l2Options);
+    }
+    else if (SyntheticSourceConfig::isSyntheticSource(m_options.source)) {
+        SyntheticSourceConfig config;
+        QString error;
+        if (!SyntheticSourceConfig::parse(m_options.source, config, &error)) {
+            qCritical() << "[HEADLESS] 合成视频源参数错误:" << error;
+            return false;
+        }
+        ok = m_sourceManager->openSynthetic(config);
+    }
+    else if (ImageSequenceReader::isSequencePath(m_options.source)) {
+        ImageSequenceOptions sequenceOptions = m_options.imageSequence;
+        sequenceOptions.loop = m_options.loop;
+        ok = m_sourceManager->openImageSequence(m_options.source, sequenceOptions);
+    }
+    else {
+        ok = m_sourceManager->openVideoFile(m_options.source, m_options.videoDecoder);
+        auto* fileSource = qobject_cast<VideoFileSource*>(m_sourceManager->getCurrentSource());
+        if (ok && fileSource) {
+            fileSource->setLoop(m_options.loop);
+        }
+    }
+    if (!ok) {
+        qCritical() << "[HEADLESS] 无法打开视频源:" << m_options.source;
+    }
+    return ok;
+}
+
+bool HeadlessRunner::initializeDetector()
+{
+    m_detector->setWarmup(m_options.warmupRuns);
+    if (m_options.replayPath.isEmpty() && !m_options.multiDevice) {
+        return m_detector->initializeModel(m_options.modelPath, m_options.parameterIndex);
+    }
+
+    auto backend = createBackend();
+    return backend && m_detector->initializeWithBackend(std::move(backend), m_options.parameterIndex);
+}
+
+std::unique_ptr<IInferenceBackend> HeadlessRunner::createBackend()
+{
+    try {
+        if (!m_options.replayPath.isEmpty()) {
+            ReplayInferenceBackend::Options replayOptions;
+            replayOptions.latencyUs = m_options.replayLatencyUs;
+            return std::make_unique<ReplayInferenceBackend>(m_options.replayPath.toStdString(), replayOptions);
+        }
+        if (m_options.multiDevice) {
+            std::vector<int> devices(m_options.devices.begin(), m_options.devices.end());
+            return std::make_unique<MultiDeviceInferenceBackend>(m_options.modelPath.toStdString(), devices);
+        }
+        return std::make_unique<DxrtInferenceBackend>(m_options.modelPath.toStdString());
+    }
+    catch (const std::exception& e) {
+        qCritical() << "[HEADLESS] 推理后端创建失败:" << e.what();
+        return nullptr;
+    }
+}
+
+void HeadlessRunner::onTick()
+{
+    if (m_finished) {
+        return;
+    }
+    if (m_stopRequested) {
+        finish(0);
+        return;
+    }
+    if (m_options.durationSec > 0 && m_runTimer.elapsed() >= m_options.durationSec * 1000LL) {
+        finish(0);
+        return;
+    }
+    if (m_pipeline) {
+        if (m_options.maxFrames > 0 && m_pipelineCompleted >= m_options.maxFrames) {
+            finish(0);
+        }
+        else if (m_pipeline->allEnded()) {
+            qInfo() << "[HEADLESS] 所有视频文件播放结束";
+            finish(0);
+        }
+        return;
+    }
+
+    // 单路模式同一时间只有一帧在推理：等上一帧的结果可取后再取下一帧，测得的延迟不含排队
+    if (m_inFlight) {
+        if (m_detector->getLatestResultFrameId() >= m_inFlightFrameId) {
+            completeFrame(m_inFlightTimer.nsecsElapsed() / 1e6);
+        }
+        else if (m_inFlightTimer.elapsed() > m_options.resultTimeoutMs) {
+            qWarning() << "[HEADLESS] 帧" << m_inFlightFrameId << "推理超时";
+            m_interval.timeouts++;
+            m_total.timeouts++;
+            m_inFlight = false;
+        }
+        else {
+            return;
+        }
+    }
+
+    if (m_options.maxFrames > 0 && m_total.submitted >= m_options.maxFrames) {
+        if (!m_inFlight) {
+            finish(0);
+        }
+        return;
+    }
+
+    if (!m_sourceManager->grabFrame(m_frame) || m_frame.empty()) {
+        m_interval.grabFailures++;
+        m_total.grabFailures++;
+        auto* source = m_sourceManager->getCurrentSource();
+        bool finite = source && (source->getType() == VideoSourceType::VideoFile
+                                 || source->getType() == VideoSourceType::ImageSequence);
+        if (finite && !m_options.loop) {
+            qInfo() << "[HEADLESS]" << (source->getType() == VideoSourceType::ImageSequence ? "图片序列处理完毕" : "视频文件播放结束");
+            finish(0);
+        }
+        return;
+    }
+    m_interval.grabbed++;
+    m_total.grabbed++;
+
+    // 静止帧不推理（不计入 submitted/completed，结果文件中也不输出）
+    if (m_options.motionGate && !m_motionGate.update(m_frame)) {
+        m_interval.gated++;
+        m_total.gated++;
+        return;
+    }
+
+    // 图片序列以文件路径标识输入，其他源以 源#帧序号 标识
+    m_inFlightInput = m_sourceManager->getCurrentSource()->getFrameName();
+    QString inputRef = m_inFlightInput.isEmpty()
+        ? QString("%1#%2").arg(m_options.source).arg(m_total.grabbed) : m_inFlightInput;
+    m_inFlightTimer.start();
+    if (!m_detector->detectAsync(m_frame, inputRef)) {
+        m_interval.submitFailures++;
+        m_total.submitFailures++;
+        return;
+    }
+    m_inFlightFrameId = m_detector->getSubmittedFrameId();
+    m_inFlight = true;
+    if (m_options.motionGate) {
+        m_motionGate.markSubmitted();
+    }
+    m_interval.submitted++;
+    m_total.submitted++;
+}
+
+void HeadlessRunner::completeFrame(double latencyMs)
+{
+    m_inFlight = false;
+    auto results = m_detector->getLatestResults();
+
+    for (IntervalStats* stats : {&m_interval, &m_total}) {
+        stats->completed++;
+        stats->detections += (qint64)results.size();
+        stats->latencySumMs += latencyMs;
+        stats->latencyMaxMs = std::max(stats->latencyMaxMs, latencyMs);
+    }
+    m_interval.latenciesMs.push_back(latencyMs);
+    if (m_resultsStream) {
+        writeResults(m_inFlightFrameId, latencyMs, results, -1, m_inFlightInput);
+    }
+}
+
+void HeadlessRunner::writeResults(uint64_t frameId, double latencyMs, const std::vector<BoundingBox>& results, int stream,
+                                  const QString& input)
+{
+    QTextStream& out = *m_resultsStream;
+    out << "{";
+    if (stream >= 0) {
+        out << "\"stream\":" << stream << ",";
+    }
+    if (!input.isEmpty()) {
+        QString escaped = input;
+        escaped.replace('\\', "\\\\").replace('"', "\\\"");
+        out << "\"file\":\"" << escaped << "\",";
+    }
+    out << "\"frame\":" << frameId
+        << ",\"latency_ms\":" << QString::number(latencyMs, 'f', 3)
+        << ",\"detections\":[";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& box = results[i];
+        if (i > 0) {
+            out << ",";
+        }
+        out << "{\"label\":" << box.label
+            << ",\"name\":\"" << QString::fromStdString(box.labelname) << "\""
+            << ",\"score\":" << QString::number(box.score, 'f', 4)
+            << ",\"box\":[" << QString::number(box.box[0], 'f', 1) << "," << QString::number(box.box[1], 'f', 1)
+            << "," << QString::number(box.box[2], 'f', 1) << "," << QString::number(box.box[3], 'f', 1) << "]}";
+    }
+    out << "]}\n";
+}
+
+void HeadlessRunner::onStatsTimer()
+{
+    double elapsedSec = m_intervalTimer.nsecsElapsed() / 1e9;
+    m_intervalTimer.restart();
+    if (m_pipeline) {
+        printStreamStats(m_pipeline->takeIntervalStats(), elapsedSec, "interval");
+        if (m_pipeline->batchSize() > 1) {
+            uint64_t batches = 0, frames = 0;
+            m_pipeline->takeBatchStats(batches, frames);
+            qInfo().noquote() << QString("[HEADLESS STATS] interval %1s batches=%2 avg_batch=%3")
+                .arg(elapsedSec, 0, 'f', 1)
+                .arg(batches)
+                .arg(batches > 0 ? (double)frames / batches : 0, 0, 'f', 2);
+        }
+        printDeviceStats("interval");
+        printCameraStats();
+        printVideoStats();
+        return;
+    }
+    printStats(m_interval, elapsedSec, "interval");
+    printDeviceStats("interval");
+    printCameraStats();
+    printVideoStats();
+    m_interval = IntervalStats();
+}
+
+void HeadlessRunner::printCameraStats()
+{
+    // 多路模式逐路输出，单路模式输出当前相机源
+    std::vector<std::pair<QString, CameraStreamStats>> cameras;
+    if (m_pipeline) {
+        for (int i = 0; i < m_pipeline->streamCount(); i++) {
+            CameraStreamStats stats;
+            if (m_pipeline->cameraStats(i, stats)) {
+                cameras.emplace_back(QString("camera[%1]").arg(i), stats);
+            }
+        }
+    }
+    else if (auto* camera = qobject_cast<CameraVideoSource*>(m_sourceManager->getCurrentSource())) {
+        cameras.emplace_back(QString("camera"), camera->getStreamStats());
+    }
+    for (const auto& [label, stats] : cameras) {
+        printCameraStats(label, stats);
+    }
+
+    // V4L2：outstanding 接近缓冲数说明使用者持有帧过久，驱动无缓冲可填（表现为 timeouts 增加）
+    std::vector<std::pair<QString, V4l2CaptureStats>> v4l2Devices;
+    if (m_pipeline) {
+        for (int i = 0; i < m_pipeline->streamCount(); i++) {
+            V4l2CaptureStats stats;
+            if (m_pipeline->v4l2Stats(i, stats)) {
+                v4l2Devices.emplace_back(QString("v4l2[%1]").arg(i), stats);
+            }
+        }
+    }
+    else if (auto* v4l2 = qobject_cast<V4l2VideoSource*>(m_sourceManager->getCurrentSource())) {
+        v4l2Devices.emplace_back(QString("v4l2"), v4l2->getStats());
+    }
+    for (const auto& [label, stats] : v4l2Devices) {
+        qInfo().noquote() << QString("[HEADLESS STATS] %1: captured=%2 zero_copy=%3 converted=%4 timeouts=%5 "
+                                     "outstanding=%6/%7")
+            .arg(label)
+            .arg(stats.captured)
+            .arg(stats.zeroCopy)
+            .arg(stats.converted)
+            .arg(stats.timeouts)
+            .arg(stats.outstanding)
+            .arg(stats.bufferCount);
+    }
+}
+
+void HeadlessRunner::printVideoStats()
+{
+    // decode_fps 只计解码耗时，用于判断瓶颈在解码还是推理；与流水线 fps 分开输出
+    std::vector<std::pair<QString, VideoDecoderStats>> videos;
+    if (m_pipeline) {
+        for (int i = 0; i < m_pipeline->streamCount(); i++) {
+            VideoDecoderStats stats;
+            if (m_pipeline->videoStats(i, stats)) {
+                videos.emplace_back(QString("video[%1]").arg(i), stats);
+            }
+        }
+    }
+    else if (auto* file = qobject_cast<VideoFileSource*>(m_sourceManager->getCurrentSource())) {
+        videos.emplace_back(QString("video"), file->getDecoderStats());
+    }
+
+    for (const auto& [label, stats] : videos) {
+        qInfo().noquote() << QString("[HEADLESS STATS] %1: decode_fps=%2 decoded=%3 delivered=%4 skipped=%5 "
+                                     "starved=%6 loops=%7 queued=%8")
+            .arg(label)
+            .arg(stats.decodeFps, 0, 'f', 1)
+            .arg(stats.decoded)
+            .arg(stats.delivered)
+            .arg(stats.skipped)
+            .arg(stats.starved)
+            .arg(stats.loops)
+            .arg(stats.queued);
+    }
+
+    std::vector<std::pair<QString, ImageSequenceStats>> sequences;
+    if (m_pipeline) {
+        for (int i = 0; i < m_pipeline->streamCount(); i++) {
+            ImageSequenceStats stats;
+            if (m_pipeline->imageSequenceStats(i, stats)) {
+                sequences.emplace_back(QString("images[%1]").arg(i), stats);
+            }
+        }
+    }
+    else if (auto* sequence = qobject_cast<ImageSequenceSource*>(m_sourceManager->getCurrentSource())) {
+        sequences.emplace_back(QString("images"), sequence->getSequenceStats());
+    }
+    for (const auto& [label, stats] : sequences) {
+        qInfo().noquote() << QString("[HEADLESS STATS] %1: decode_fps=%2 decoded=%3 delivered=%4 failed=%5 "
+                                     "loops=%6 queued=%7")
+            .arg(label)
+            .arg(stats.decodeFps, 0, 'f', 1)
+            .arg(stats.decoded)
+            .arg(stats.delivered)
+            .arg(stats.failed)
+            .arg(stats.loops)
+            .arg(stats.queued);
+    }
+
+    // 合成源：dropped 为取帧方跟不上配置帧率而跳过的帧
+    std::vector<std::pair<QString, SyntheticStreamStats>> synthetics;
+    if (m_pipeline) {
+        for (int i = 0; i < m_pipeline->streamCount(); i++) {
+            SyntheticStreamStats stats;
+            if (m_pipeline->syntheticStats(i, stats)) {
+                synthetics.emplace_back(QString("synthetic[%1]").arg(i), stats);
+            }
+        }
+    }
+    else if (auto* synthetic = qobject_cast<SyntheticVideoSource*>(m_sourceManager->getCurrentSource())) {
+        synthetics.emplace_back(QString("synthetic"), synthetic->getStats());
+    }
+    for (const auto& [label, stats] : synthetics) {
+        qInfo().noquote() << QString("[HEADLESS STATS] %1: delivered=%2 dropped=%3 pool_frames=%4 pool_mb=%5")
+            .arg(label)
+            .arg(stats.delivered)
+            .arg(stats.dropped)
+            .arg(stats.poolFrames)
+            .arg(stats.poolBytes / (1024.0 * 1024.0), 0, 'f', 1);
+    }
+}
+
+void HeadlessRunner::printDeviceStats(const char* title)
+{
+    // 只有多设备后端有逐设备统计；submitted/completed 为累计值
+    IInferenceBackend* backend = m_pipeline ? m_pipeline->backend() : m_detector->getBackend();
+    auto* multiDevice = dynamic_cast<MultiDeviceInferenceBackend*>(backend);
+    if (!multiDevice) {
+        return;
+    }
+    for (const auto& device : multiDevice->deviceStats()) {
+        qInfo().noquote() << QString("[HEADLESS STATS] %1 device %2: in_flight=%3 submitted=%4 completed=%5 "
+                                     "latency_us=%6 npu_us=%7")
+            .arg(title)
+            .arg(device.deviceId)
+            .arg(device.inFlight)
+            .arg(device.submitted)
+            .arg(device.completed)
+            .arg(device.latencyUs, 0, 'f', 0)
+            .arg(device.npuTimeUs, 0, 'f', 0);
+    }
+}
+
+void HeadlessRunner::printCameraStats(const QString& label, const CameraStreamStats& stats)
+{
+    qInfo().noquote() << QString("[HEADLESS STATS] %1: sdk_fps=%2 received=%3 lost=%4 incomplete=%5 "
+                                 "delivered=%6 overwritten=%7 skipped=%8 queue_delay_us=%9")
+        .arg(label)
+        .arg(stats.sdkFps, 0, 'f', 1)
+        .arg(stats.sdkReceived)
+        .arg(stats.sdkLost)
+        .arg(stats.sdkIncomplete)
+        .arg(stats.delivered)
+        .arg(stats.overwritten)
+        .arg(stats.skipped)
+        .arg(stats.avgQueueDelayUs, 0, 'f', 1);
+}
+
+void HeadlessRunner::printStats(const IntervalStats& stats, double elapsedSec, const char* title)
+{
+    // 总计不保存逐帧延迟（长时间运行时内存不增长），只输出均值和最大值
+    QString p50 = "-", p95 = "-";
+    if (!stats.latenciesMs.empty()) {
+        std::vector<double> sorted = stats.latenciesMs;
+        std::sort(sorted.begin(), sorted.end());
+        p50 = QString::number(sorted[sorted.size() / 2], 'f', 2);
+        p95 = QString::number(sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)], 'f', 2);
+    }
+    double avg = stats.completed > 0 ? stats.latencySumMs / stats.completed : 0;
+    double fps = elapsedSec > 0 ? stats.completed / elapsedSec : 0;
+    double detPerFrame = stats.completed > 0 ? (double)stats.detections / stats.completed : 0;
+
+    qInfo().noquote() << QString("[HEADLESS STATS] %1 %2s: grabbed=%3 submitted=%4 completed=%5 "
+                                 "grab_fail=%6 timeout=%7 fps=%8 latency_ms avg=%9 p50=%10 p95=%11 max=%12 det/frame=%13 "
+                                 "gated=%14 submit_fail=%15")
+        .arg(title)
+        .arg(elapsedSec, 0, 'f', 1)
+        .arg(stats.grabbed)
+        .arg(stats.submitted)
+        .arg(stats.completed)
+        .arg(stats.grabFailures)
+        .arg(stats.timeouts)
+        .arg(fps, 0, 'f', 1)
+        .arg(avg, 0, 'f', 2)
+        .arg(p50)
+        .arg(p95)
+        .arg(stats.latencyMaxMs, 0, 'f', 2)
+        .arg(detPerFrame, 0, 'f', 2)
+        .arg(stats.gated)
+        .arg(stats.submitFailures);
+}
+
+void HeadlessRunner::printStreamStats(const std::vector<StreamStats>& stats, double elapsedSec, const char* title)
+{
+    uint64_t completed = 0;
+    for (size_t i = 0; i < stats.size(); i++) {
+        const StreamStats& s = stats[i];
+        double fps = elapsedSec > 0 ? s.completed / elapsedSec : 0;
+        double avgLatency = s.completed > 0 ? s.latencySumMs / s.completed : 0;
+        double avgWait = s.submitted > 0 ? s.waitSumMs / s.submitted : 0;
+        double detPerFrame = s.completed > 0 ? (double)s.detections / s.completed : 0;
+        qInfo().noquote() << QString("[HEADLESS STATS] %1 %2s stream %3 (%4): captured=%5 dropped=%6 submitted=%7 "
+                                     "completed=%8 fail=%9 fps=%10 wait_ms=%11 latency_ms avg=%12 max=%13 det/frame=%14 "
+                                     "gated=%15%16")
+            .arg(title)
+            .arg(elapsedSec, 0, 'f', 1)
+            .arg(i)
+            .arg(s.name)
+            .arg(s.captured)
+            .arg(s.dropped)
+            .arg(s.submitted)
+            .arg(s.completed)
+            .arg(s.failures)
+            .arg(fps, 0, 'f', 1)
+            .arg(avgWait, 0, 'f', 2)
+            .arg(avgLatency, 0, 'f', 2)
+            .arg(s.latencyMaxMs, 0, 'f', 2)
+            .arg(detPerFrame, 0, 'f', 2)
+            .arg(s.gated)
+            .arg(s.ended ? " (ended)" : "");
+        completed += s.completed;
+    }
+    qInfo().noquote() << QString("[HEADLESS STATS] %1 %2s all %3 streams: completed=%4 fps=%5")
+        .arg(title)
+        .arg(elapsedSec, 0, 'f', 1)
+        .arg(stats.size())
+        .arg(completed)
+        .arg(elapsedSec > 0 ? completed / elapsedSec : 0, 0, 'f', 1);
+}
+
+void HeadlessRunner::finish(int exitCode)
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_tickTimer->stop();
+    m_statsTimer->stop();
+
+    if (m_detector->isRecording()) {
+        m_detector->stopRecording();
+    }
+    if (m_pipeline) {
+        // 先停止流水线（等待推理回调结束），之后才能安全地刷新结果文件
+        m_pipeline->stop();
+        if (m_resultsStream) {
+            m_resultsStream->flush();
+        }
+        printStreamStats(m_pipeline->totalStats(), m_runTimer.nsecsElapsed() / 1e9, "total");
+        printDeviceStats("total");
+        printCameraStats();
+        printVideoStats();
+        emit finished(exitCode);
+        return;
+    }
+    if (m_resultsStream) {
+        m_resultsStream->flush();
+    }
+    printStats(m_total, m_runTimer.nsecsElapsed() / 1e9, "total");
+    printDeviceStats("total");
+    printCameraStats();
+    printVideoStats();
+    emit finished(exitCode);
+}
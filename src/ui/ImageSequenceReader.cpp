@@ -0,0 +1,234 @@
+#include "ImageSequenceReader.h"
+#include <QCollator>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+
+ImageSequenceReader::ImageSequenceReader(const QStringList& files, const ImageSequenceOptions& options)
+    : m_files(files)
+    , m_options(options)
+    , m_nextClaim(0)
+    , m_nextDeliver(0)
+    , m_stopping(false)
+    , m_decoded(0)
+    , m_delivered(0)
+    , m_failed(0)
+    , m_decodeBusySec(0)
+{
+    if (m_options.decodeThreads <= 0) {
+        m_options.decodeThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    m_options.queueCapacity = std::max(m_options.queueCapacity, m_options.decodeThreads);
+}
+
+ImageSequenceReader::~ImageSequenceReader()
+{
+    stop();
+}
+
+bool ImageSequenceReader::isSequencePath(const QString& path)
+{
+    QFileInfo info(path);
+    if (info.isDir()) {
+        return true;
+    }
+    QString suffix = info.suffix().toLower();
+    return suffix == "txt" || suffix == "lst";
+}
+
+QStringList ImageSequenceReader::listFiles(const QString& path)
+{
+    QStringList files;
+    QFileInfo info(path);
+    if (info.isDir()) {
+        QDir dir(path);
+        QStringList names = dir.entryList({ "*.bmp", "*.png", "*.jpg", "*.jpeg", "*.tif", "*.tiff" },
+                                          QDir::Files | QDir::Readable);
+        // 自然排序：img_2 排在 img_10 之前
+        QCollator collator;
+        collator.setNumericMode(true);
+        std::sort(names.begin(), names.end(), collator);
+        for (const QString& name : names) {
+            files.append(dir.absoluteFilePath(name));
+        }
+        return files;
+    }
+
+    QFile list(path);
+    if (!list.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "[ImageSequence] 无法读取列表文件:" << path;
+        return files;
+    }
+    QDir base = info.absoluteDir();
+    QTextStream in(&list);
+    while (!in.atEnd()) {
+        QString line = in.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        files.append(QDir::cleanPath(base.absoluteFilePath(line)));
+    }
+    return files;
+}
+
+void ImageSequenceReader::start()
+{
+    stop();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done.clear();
+        m_nextClaim = 0;
+        m_nextDeliver = 0;
+        m_stopping = false;
+    }
+    if (m_files.isEmpty()) {
+        return;
+    }
+    int threads = m_options.loop ? m_options.decodeThreads : std::min(m_options.decodeThreads, count());
+    for (int i = 0; i < threads; i++) {
+        m_workers.emplace_back(&ImageSequenceReader::workerLoop, this);
+    }
+    qDebug() << "[ImageSequence]" << count() << "张图片, 解码线程:" << threads
+             << ", 队列:" << m_options.queueCapacity << ", 内存映射:" << m_options.memoryMap;
+}
+
+void ImageSequenceReader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_space.notify_all();
+    m_ready.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+bool ImageSequenceReader::decodeFile(const QString& path, cv::Mat& image) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const qint64 size = file.size();
+    if (size <= 0 || size > INT_MAX) {
+        return false;
+    }
+    // 映射后由 imdecode 直接读取页缓存，省去一次读入用户缓冲的拷贝
+    uchar* data = m_options.memoryMap ? file.map(0, size) : nullptr;
+    if (data) {
+        image = cv::imdecode(cv::Mat(1, (int)size, CV_8UC1, data), m_options.imreadFlags);
+        file.unmap(data);
+    }
+    else {
+        QByteArray bytes = file.readAll();
+        image = cv::imdecode(cv::Mat(1, (int)bytes.size(), CV_8UC1, bytes.data()), m_options.imreadFlags);
+    }
+    return !image.empty();
+}
+
+void ImageSequenceReader::workerLoop()
+{
+    const uint64_t total = (uint64_t)count();
+    for (;;) {
+        uint64_t sequence;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_space.wait(lock, [&] {
+                return m_stopping || m_nextClaim < m_nextDeliver + (uint64_t)m_options.queueCapacity;
+            });
+            if (m_stopping || (!m_options.loop && m_nextClaim >= total)) {
+                return;
+            }
+            sequence = m_nextClaim++;
+        }
+
+        const QString& path = m_files[(int)(sequence % total)];
+        auto start = std::chrono::steady_clock::now();
+        cv::Mat image;
+        bool ok = decodeFile(path, image);
+        double decodeSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (!ok) {
+            qWarning() << "[ImageSequence] 无法解码图片:" << path;
+            image.release();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done.emplace(sequence, std::move(image));
+            m_decodeBusySec += decodeSec;
+            if (ok) {
+                m_decoded++;
+            }
+            else {
+                m_failed++;
+            }
+        }
+        m_ready.notify_all();
+    }
+}
+
+bool ImageSequenceReader::take(cv::Mat& outFrame, int& fileIndex, int timeoutMs)
+{
+    const uint64_t total = (uint64_t)count();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (bool first = true;; first = false) {
+        // 跳过解码失败的文件时不经过等待，也要按截止时间返回，否则整个序列都失败时会一直循环；
+        // 首轮不检查，timeoutMs 为 0 时仍能取走已就绪的帧
+        if (!first && std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        if (total == 0 || (!m_options.loop && m_nextDeliver >= total)) {
+            return false;
+        }
+        auto it = m_done.find(m_nextDeliver);
+        if (it == m_done.end()) {
+            if (!m_ready.wait_until(lock, deadline, [&] { return m_stopping || m_done.count(m_nextDeliver) > 0; })
+                || m_stopping) {
+                return false;
+            }
+            continue;
+        }
+
+        cv::Mat image = std::move(it->second);
+        m_done.erase(it);
+        uint64_t sequence = m_nextDeliver++;
+        m_space.notify_all();
+        // 解码失败的文件已在解码时告警，交付时跳过
+        if (image.empty()) {
+            continue;
+        }
+        m_delivered++;
+        fileIndex = (int)(sequence % total);
+        lock.unlock();
+        outFrame = std::move(image);
+        return true;
+    }
+}
+
+bool ImageSequenceReader::finished() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_options.loop && m_nextDeliver >= (uint64_t)count();
+}
+
+ImageSequenceStats ImageSequenceReader::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ImageSequenceStats stats;
+    stats.decoded = m_decoded;
+    stats.delivered = m_delivered;
+    stats.failed = m_failed;
+    stats.loops = m_files.isEmpty() ? 0 : m_nextDeliver / (uint64_t)count();
+    stats.queued = (int)m_done.size();
+    stats.decodeFps = m_decodeBusySec > 0 ? (m_decoded + m_failed) * m_workers.size() / m_decodeBusySec : 0;
+    return stats;
+}
@@ -0,0 +1,674 @@
+#include "InferenceBackend.h"
+#include <dxrt/device_info_status.h>
+#include <utils/capture_file.hpp>
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <sstream>
+
+// ============================================================================
+// IInferenceBackend 公共实现
+// ============================================================================
+
+dxrt::Tensors IInferenceBackend::outputTensors() const
+{
+    dxrt::Tensors tensors;
+    for (const auto& desc : outputDescs()) {
+        tensors.emplace_back(desc.name, desc.shape, desc.type);
+    }
+    return tensors;
+}
+
+std::vector<std::vector<int64_t>> IInferenceBackend::outputShapes() const
+{
+    std::vector<std::vector<int64_t>> shapes;
+    for (const auto& desc : outputDescs()) {
+        shapes.push_back(desc.shape);
+    }
+    return shapes;
+}
+
+bool IInferenceBackend::runBatch(const std::vector<void*>& inputs, const std::vector<void*>& outputs)
+{
+    if (inputs.size() != outputs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        if (!run(inputs[i], outputs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+dxrt::DataType IInferenceBackend::outputType() const
+{
+    const auto& descs = outputDescs();
+    return descs.empty() ? dxrt::DataType::NONE_TYPE : descs.front().type;
+}
+
+// ============================================================================
+// DxrtInferenceBackend 实现
+// ============================================================================
+
+DxrtInferenceBackend::DxrtInferenceBackend(const std::string& modelPath, dxrt::InferenceOption option)
+    : m_modelPath(modelPath)
+    , m_option(option)
+    , m_inputSize(0)
+    , m_outputSize(0)
+    , m_outstandingJobs(0)
+    , m_closing(false)
+{
+    // 构造失败时异常直接抛给调用方（YoloDetector::initializeModel 中统一处理）
+    m_engine = std::make_unique<dxrt::InferenceEngine>(m_modelPath, m_option);
+    m_inputSize = m_engine->GetInputSize();
+    m_outputSize = m_engine->GetOutputSize();
+
+    uint64_t offset = 0;
+    auto outputs = m_engine->GetOutputs();
+    for (auto& tensor : outputs) {
+        OutputTensorDesc desc;
+        desc.name = tensor.name();
+        desc.shape = tensor.shape();
+        desc.type = tensor.type();
+        desc.offset = offset;
+        desc.sizeInBytes = tensor.size_in_bytes();
+        offset += desc.sizeInBytes;
+        m_outputDescs.push_back(desc);
+    }
+    qDebug() << "[DXRT BACKEND] 模型已加载:" << QString::fromStdString(m_modelPath)
+             << ", 输入" << m_inputSize << "bytes, 输出" << m_outputSize << "bytes";
+}
+
+DxrtInferenceBackend::~DxrtInferenceBackend()
+{
+    // 在途任务在提交时计数、在回调返回后才减去，计数为 0 时不会再有回调使用 this 和 m_callback。
+    // 释放仍被 DXRT 使用的输出 buffer 和回调对象比阻塞更糟，因此超时只告警、继续等待
+    {
+        std::unique_lock<std::mutex> lock(m_jobMutex);
+        m_closing = true;
+        while (!m_jobsDone.wait_for(lock, std::chrono::seconds(5), [this] { return m_outstandingJobs == 0; })) {
+            qWarning() << "[DXRT BACKEND] 等待在途推理完成，剩余" << m_outstandingJobs << "个";
+        }
+    }
+    m_engine.reset();
+}
+
+bool DxrtInferenceBackend::run(void* input, void* output)
+{
+    try {
+        dxrt::TensorPtrs outputs = m_engine->Run(input, nullptr, output);
+        if (outputs.empty()) {
+            qWarning() << "[DXRT BACKEND] 同步推理没有返回输出";
+            return false;
+        }
+        return true;
+    }
+    catch (const std::exception& e) {
+        qWarning() << "[DXRT BACKEND] 同步推理失败:" << e.what();
+        return false;
+    }
+}
+
+bool DxrtInferenceBackend::runBatch(const std::vector<void*>& inputs, const std::vector<void*>& outputs)
+{
+    if (inputs.empty() || inputs.size() != outputs.size()) {
+        return false;
+    }
+    // 不传 userArgs：即使 DXRT 内部经由异步路径完成，回调收到的 arg 为空，不会被当作 runAsync 的任务处理
+    try {
+        std::vector<dxrt::TensorPtrs> results = m_engine->Run(inputs, outputs);
+        if (results.size() != inputs.size()) {
+            qWarning() << "[DXRT BACKEND] 批量推理返回" << results.size() << "帧输出，提交" << inputs.size() << "帧";
+            return false;
+        }
+        return true;
+    }
+    catch (const std::exception& e) {
+        qWarning() << "[DXRT BACKEND] 批量推理失败:" << e.what();
+        return false;
+    }
+}
+
+int DxrtInferenceBackend::runAsync(void* input, void* userArg, void* output)
+{
+    // 提交前计入在途任务：析构时等待的是已提交的任务，而不是已进入回调的任务
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        if (m_closing) {
+            return -1;
+        }
+        m_outstandingJobs++;
+    }
+    auto* job = new AsyncJob{output, userArg};
+    int jobId = -1;
+    try {
+        jobId = m_engine->RunAsync(input, job, output);
+    }
+    catch (...) {
+        delete job;
+        finishJob();
+        throw;
+    }
+    if (jobId < 0) {
+        delete job;
+        finishJob();
+    }
+    return jobId;
+}
+
+void DxrtInferenceBackend::finishJob()
+{
+    std::lock_guard<std::mutex> lock(m_jobMutex);
+    if (--m_outstandingJobs == 0) {
+        m_jobsDone.notify_all();
+    }
+}
+
+void DxrtInferenceBackend::setCallback(Callback callback)
+{
+    m_callback = std::move(callback);
+    m_engine->RegisterCallback(
+        [this](dxrt::TensorPtrs& outputs, void* arg) -> int
+        {
+            // arg 为空的是 runBatch 的任务，不计入在途任务
+            std::unique_ptr<AsyncJob> job(static_cast<AsyncJob*>(arg));
+            if (!job) {
+                return 0;
+            }
+            if (m_callback) {
+                m_callback(job->output, job->userArg);
+            }
+            job.reset();
+            finishJob();
+            return 0;
+        });
+}
+
+// ============================================================================
+// MultiDeviceInferenceBackend 实现
+// ============================================================================
+
+namespace {
+
+// 耗时统计：每完成这么多帧刷新一次，取最近这么多次的均值
+constexpr uint64_t kTimingRefreshInterval = 16;
+constexpr size_t kTimingWindow = 8;
+
+template <typename T>
+double recentMean(const std::vector<T>& values)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    size_t count = std::min(values.size(), kTimingWindow);
+    double sum = 0;
+    for (size_t i = values.size() - count; i < values.size(); i++) {
+        sum += values[i];
+    }
+    return sum / count;
+}
+
+} // namespace
+
+MultiDeviceInferenceBackend::MultiDeviceInferenceBackend(const std::string& modelPath, std::vector<int> deviceIds,
+                                                         uint32_t boundOption)
+    : m_modelPath(modelPath)
+{
+    if (deviceIds.empty()) {
+        int count = dxrt::DeviceStatus::GetDeviceCount();
+        for (int i = 0; i < count; i++) {
+            deviceIds.push_back(i);
+        }
+    }
+    if (deviceIds.empty()) {
+        throw std::runtime_error("未找到 NPU 设备");
+    }
+
+    // 构造失败时异常直接抛给调用方（已创建的引擎随 m_devices 释放）
+    for (int id : deviceIds) {
+        dxrt::InferenceOption option;
+        option.devices = { id };
+        option.boundOption = boundOption;
+        auto device = std::make_unique<Device>();
+        device->id = id;
+        device->backend = std::make_unique<DxrtInferenceBackend>(modelPath, option);
+        m_devices.push_back(std::move(device));
+    }
+    qInfo() << "[MULTI DEVICE] 模型已加载到" << m_devices.size() << "个设备:" << QString::fromStdString(name());
+}
+
+MultiDeviceInferenceBackend::~MultiDeviceInferenceBackend()
+{
+    m_devices.clear();
+}
+
+std::string MultiDeviceInferenceBackend::name() const
+{
+    std::string ids;
+    for (const auto& device : m_devices) {
+        ids += (ids.empty() ? "" : ",") + std::to_string(device->id);
+    }
+    return "dxrt[" + ids + "]:" + m_modelPath;
+}
+
+void MultiDeviceInferenceBackend::refreshTimings()
+{
+    std::unique_lock<std::mutex> lock(m_refreshMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+    for (auto& device : m_devices) {
+        uint64_t completed = device->completed.load();
+        if (completed - device->refreshedAt < kTimingRefreshInterval) {
+            continue;
+        }
+        device->refreshedAt = completed;
+        dxrt::InferenceEngine* engine = device->backend->engine();
+        device->latencyUs = recentMean(engine->GetLatencyVector());
+        device->npuTimeUs = recentMean(engine->GetNpuInferenceTimeVector());
+    }
+}
+
+size_t MultiDeviceInferenceBackend::pickDevice()
+{
+    refreshTimings();
+
+    // 预计完成时间 = (在途帧数 + 1) * 单帧 NPU 时间；尚无统计的设备按 1 计，先按在途帧数分配
+    size_t best = 0;
+    double bestCost = 0;
+    for (size_t i = 0; i < m_devices.size(); i++) {
+        const Device& device = *m_devices[i];
+        double npuTime = device.npuTimeUs.load();
+        double cost = (device.inFlight.load() + 1) * (npuTime > 0 ? npuTime : 1.0);
+        if (i == 0 || cost < bestCost) {
+            best = i;
+            bestCost = cost;
+        }
+    }
+    return best;
+}
+
+bool MultiDeviceInferenceBackend::run(void* input, void* output)
+{
+    Device& device = *m_devices[pickDevice()];
+    device.inFlight++;
+    device.submitted++;
+    bool ok = false;
+    try {
+        ok = device.backend->run(input, output);
+    }
+    catch (...) {
+        device.inFlight--;
+        throw;
+    }
+    device.inFlight--;
+    device.completed++;
+    return ok;
+}
+
+bool MultiDeviceInferenceBackend::warmupRun(void* input, void* output)
+{
+    bool ok = true;
+    for (auto& device : m_devices) {
+        ok = device->backend->warmupRun(input, output) && ok;
+    }
+    return ok;
+}
+
+bool MultiDeviceInferenceBackend::runBatch(const std::vector<void*>& inputs, const std::vector<void*>& outputs)
+{
+    // 整批交给同一设备（向量 Run 是单引擎调用）
+    Device& device = *m_devices[pickDevice()];
+    int count = (int)inputs.size();
+    device.inFlight += count;
+    device.submitted += count;
+    bool ok = false;
+    try {
+        ok = device.backend->runBatch(inputs, outputs);
+    }
+    catch (...) {
+        device.inFlight -= count;
+        throw;
+    }
+    device.inFlight -= count;
+    device.completed += count;
+    return ok;
+}
+
+int MultiDeviceInferenceBackend::runAsync(void* input, void* userArg, void* output)
+{
+    size_t index = pickDevice();
+    Device& device = *m_devices[index];
+    auto* job = new AsyncJob{ index, userArg };
+    device.inFlight++;
+    device.submitted++;
+    int jobId = -1;
+    try {
+        jobId = device.backend->runAsync(input, job, output);
+    }
+    catch (...) {
+        device.inFlight--;
+        delete job;
+        throw;
+    }
+    if (jobId < 0) {
+        device.inFlight--;
+        delete job;
+    }
+    return jobId;
+}
+
+void MultiDeviceInferenceBackend::setCallback(Callback callback)
+{
+    m_callback = std::move(callback);
+    for (auto& device : m_devices) {
+        device->backend->setCallback(
+            [this](void* output, void* arg)
+            {
+                std::unique_ptr<AsyncJob> job(static_cast<AsyncJob*>(arg));
+                if (!job) {
+                    return;
+                }
+                Device& owner = *m_devices[job->device];
+                owner.inFlight--;
+                owner.completed++;
+                if (m_callback) {
+                    m_callback(output, job->userArg);
+                }
+            });
+    }
+}
+
+double MultiDeviceInferenceBackend::npuTimeUs() const
+{
+    double sum = 0;
+    int count = 0;
+    for (const auto& device : m_devices) {
+        double npuTime = device->npuTimeUs.load();
+        if (npuTime > 0) {
+            sum += npuTime;
+            count++;
+        }
+    }
+    return count > 0 ? sum / count : 0;
+}
+
+std::vector<MultiDeviceInferenceBackend::DeviceStats> MultiDeviceInferenceBackend::deviceStats() const
+{
+    std::vector<DeviceStats> stats;
+    for (const auto& device : m_devices) {
+        DeviceStats item;
+        item.deviceId = device->id;
+        item.inFlight = device->inFlight.load();
+        item.submitted = device->submitted.load();
+        item.completed = device->completed.load();
+        item.latencyUs = device->latencyUs.load();
+        item.npuTimeUs = device->npuTimeUs.load();
+        stats.push_back(item);
+    }
+    return stats;
+}
+
+// ============================================================================
+// ReplayInferenceBackend 实现
+// ============================================================================
+
+ReplayInferenceBackend::ReplayInferenceBackend(const std::string& replayPath, const Options& options)
+    : m_replayPath(replayPath)
+    , m_options(options)
+    , m_outputSize(0)
+    , m_frameCursor(0)
+    , m_nextJobId(0)
+    , m_stopping(false)
+{
+    namespace fs = std::filesystem;
+    if (fs::is_regular_file(m_replayPath)) {
+        if (!loadCapture(m_replayPath)) {
+            throw std::runtime_error("Failed to load capture file: " + m_replayPath);
+        }
+    }
+    else if (fs::is_directory(m_replayPath)) {
+        if (!loadTensorDescs((fs::path(m_replayPath) / "tensors.txt").string())) {
+            throw std::runtime_error("Failed to load tensors.txt from " + m_replayPath);
+        }
+        if (!loadFrames(m_replayPath)) {
+            throw std::runtime_error("No valid *.bin frames in " + m_replayPath);
+        }
+    }
+    else {
+        throw std::runtime_error("Replay path does not exist: " + m_replayPath);
+    }
+
+    int numWorkers = std::max(1, m_options.numWorkers);
+    for (int i = 0; i < numWorkers; i++) {
+        m_workers.emplace_back(&ReplayInferenceBackend::workerLoop, this);
+    }
+    qDebug() << "[REPLAY BACKEND] 已加载" << m_frames.size() << "帧, 输出" << m_outputSize
+             << "bytes, 延迟" << m_options.latencyUs << "us, 并发" << numWorkers;
+}
+
+ReplayInferenceBackend::~ReplayInferenceBackend()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        m_stopping = true;
+    }
+    m_jobCv.notify_all();
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+static uint32_t elementSize(dxrt::DataType type)
+{
+    switch (type) {
+    case dxrt::DataType::UINT8:
+    case dxrt::DataType::INT8:
+        return 1;
+    case dxrt::DataType::UINT16:
+    case dxrt::DataType::INT16:
+        return 2;
+    case dxrt::DataType::INT64:
+    case dxrt::DataType::UINT64:
+        return 8;
+    case dxrt::DataType::BBOX:
+        return sizeof(dxrt::DeviceBoundingBox_t);
+    default:
+        return 4;
+    }
+}
+
+bool ReplayInferenceBackend::loadTensorDescs(const std::string& descPath)
+{
+    std::ifstream file(descPath);
+    if (!file.is_open()) {
+        qWarning() << "[REPLAY BACKEND] 无法打开" << QString::fromStdString(descPath);
+        return false;
+    }
+
+    std::string line;
+    uint64_t offset = 0;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream iss(line);
+        OutputTensorDesc desc;
+        int type = 0;
+        if (!(iss >> desc.name >> type)) {
+            continue;
+        }
+        desc.type = static_cast<dxrt::DataType>(type);
+        int64_t dim;
+        uint64_t numElements = 1;
+        while (iss >> dim) {
+            desc.shape.push_back(dim);
+            numElements *= static_cast<uint64_t>(dim);
+        }
+        desc.offset = offset;
+        desc.sizeInBytes = numElements * elementSize(desc.type);
+        offset += desc.sizeInBytes;
+        m_outputDescs.push_back(desc);
+    }
+    m_outputSize = offset;
+    return !m_outputDescs.empty();
+}
+
+bool ReplayInferenceBackend::loadFrames(const std::string& dir)
+{
+    namespace fs = std::filesystem;
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".bin") {
+            files.push_back(entry.path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto& path : files) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        uint64_t size = static_cast<uint64_t>(file.tellg());
+        if (size < m_outputSize) {
+            qWarning() << "[REPLAY BACKEND] 跳过" << QString::fromStdString(path.string())
+                       << ": 大小" << size << "<" << m_outputSize;
+            continue;
+        }
+        std::vector<uint8_t> frame(m_outputSize);
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(frame.data()), m_outputSize);
+        m_frameStorage.push_back(std::move(frame));
+    }
+    for (const auto& frame : m_frameStorage) {
+        m_frames.push_back(frame.data());
+    }
+    return !m_frames.empty();
+}
+
+bool ReplayInferenceBackend::loadCapture(const std::string& capturePath)
+{
+    m_capture = std::make_unique<dxapp::common::CaptureReader>();
+    if (!m_capture->open(capturePath)) {
+        qWarning() << "[REPLAY BACKEND] 无效的录制文件:" << QString::fromStdString(capturePath);
+        return false;
+    }
+    if (m_capture->recovered()) {
+        qWarning() << "[REPLAY BACKEND] 录制文件缺少索引（可能未正常关闭），已扫描恢复"
+                   << m_capture->size() << "帧";
+    }
+
+    for (const auto& tensor : m_capture->tensors()) {
+        OutputTensorDesc desc;
+        desc.name = tensor.name;
+        desc.type = static_cast<dxrt::DataType>(tensor.dtype);
+        desc.shape.assign(tensor.dims, tensor.dims + tensor.numDims);
+        desc.offset = tensor.offset;
+        desc.sizeInBytes = tensor.sizeInBytes;
+        m_outputDescs.push_back(desc);
+    }
+    m_outputSize = m_capture->header().outputSize;
+
+    for (size_t i = 0; i < m_capture->size(); i++) {
+        m_frames.push_back(m_capture->record(i).payload);
+    }
+    return !m_outputDescs.empty() && !m_frames.empty();
+}
+
+void ReplayInferenceBackend::simulateLatency()
+{
+    int latencyUs = m_options.latencyUs;
+    if (m_options.latencyJitterUs > 0) {
+        thread_local std::mt19937 rng(std::random_device{}());
+        std::uniform_int_distribution<int> jitter(-m_options.latencyJitterUs, m_options.latencyJitterUs);
+        latencyUs += jitter(rng);
+    }
+    if (latencyUs > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(latencyUs));
+    }
+}
+
+void ReplayInferenceBackend::copyNextFrame(void* output)
+{
+    uint64_t index = m_frameCursor.fetch_add(1) % m_frames.size();
+    std::memcpy(output, m_frames[index], m_outputSize);
+}
+
+bool ReplayInferenceBackend::run(void* input, void* output)
+{
+    (void)input;
+    if (!output) {
+        return false;
+    }
+    simulateLatency();
+    copyNextFrame(output);
+    return true;
+}
+
+bool ReplayInferenceBackend::warmupRun(void* input, void* output)
+{
+    (void)input;
+    if (!output) {
+        return false;
+    }
+    std::memcpy(output, m_frames[0], m_outputSize);
+    return true;
+}
+
+int ReplayInferenceBackend::runAsync(void* input, void* userArg, void* output)
+{
+    (void)input;
+    if (!output) {
+        return -1;
+    }
+    int jobId = m_nextJobId.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(m_jobMutex);
+        if ((int)m_jobs.size() >= m_options.maxQueueDepth) {
+            return -1;
+        }
+        m_jobs.push_back(Job{jobId, output, userArg});
+    }
+    m_jobCv.notify_one();
+    return jobId;
+}
+
+void ReplayInferenceBackend::setCallback(Callback callback)
+{
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_callback = std::move(callback);
+}
+
+void ReplayInferenceBackend::workerLoop()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_jobMutex);
+            m_jobCv.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping && m_jobs.empty()) {
+                return;
+            }
+            job = m_jobs.front();
+            m_jobs.pop_front();
+        }
+
+        simulateLatency();
+        copyNextFrame(job.output);
+
+        Callback callback;
+        {
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            callback = m_callback;
+        }
+        if (callback) {
+            callback(job.output, job.userArg);
+        }
+    }
+}
@@ -0,0 +1,184 @@
+#include "InferenceRateController.h"
+#include <algorithm>
+
+InferenceRateController::InferenceRateController()
+{
+    reset();
+}
+
+InferenceRateController::InferenceRateController(const Config& config)
+    : m_config(config)
+{
+    reset();
+}
+
+void InferenceRateController::setConfig(const Config& config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+    m_status.budgetMs = m_config.latencyBudgetMs;
+    applyLevel(std::min(m_level, maxLevel()));
+}
+
+InferenceRateController::Config InferenceRateController::config() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_config;
+}
+
+void InferenceRateController::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_status = InferenceRateStatus();
+    m_status.budgetMs = m_config.latencyBudgetMs;
+    m_level = 0;
+    m_framesSinceSubmit = 0;
+    m_busySkips = 0;
+    m_lastCompleted = 0;
+    m_lastLatencySumMs = 0;
+    m_hasSample = false;
+    m_lastAdjust = Clock::now();
+    m_lastCompletion = m_lastAdjust;
+}
+
+bool InferenceRateController::shouldSubmit(int inFlight)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_status.offered++;
+    m_status.inFlight = inFlight;
+    m_framesSinceSubmit++;
+
+    bool submit = false;
+    switch (m_status.mode) {
+    case InferenceRateMode::EveryFrame:
+        submit = inFlight < std::max(m_config.maxInFlight, 1);
+        break;
+    case InferenceRateMode::LatestOnly:
+        submit = inFlight == 0;
+        break;
+    case InferenceRateMode::EveryNth:
+        // 按距上次提交的帧数计，忙时顺延到下一帧，不会因为恰好错过第 N 帧而多等一个周期
+        submit = inFlight == 0 && m_framesSinceSubmit >= (uint64_t)m_status.stride;
+        break;
+    }
+
+    if (submit) {
+        m_status.submitted++;
+        m_framesSinceSubmit = 0;
+    }
+    else {
+        m_status.skipped++;
+        if (inFlight > 0) {
+            m_busySkips++;
+        }
+    }
+    return submit;
+}
+
+bool InferenceRateController::update(uint64_t completed, double latencySumMs, double npuTimeMs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Clock::time_point now = Clock::now();
+    if (npuTimeMs > 0) {
+        m_status.npuTimeMs = npuTimeMs;
+    }
+    if (completed < m_lastCompleted) {
+        // 检测器重新初始化，累计值清零
+        m_lastCompleted = 0;
+        m_lastLatencySumMs = 0;
+    }
+    if (completed > m_lastCompleted) {
+        m_lastCompletion = now;
+    }
+
+    if (now - m_lastAdjust < std::chrono::milliseconds(m_config.adjustIntervalMs)) {
+        return false;
+    }
+
+    uint64_t count = completed - m_lastCompleted;
+    double intervalMean = count > 0 ? (latencySumMs - m_lastLatencySumMs) / count : 0;
+    m_lastCompleted = completed;
+    m_lastLatencySumMs = latencySumMs;
+    m_lastAdjust = now;
+    uint64_t busySkips = m_busySkips;
+    m_busySkips = 0;
+
+    if (count > 0) {
+        m_status.latencyMs = m_hasSample
+            ? m_status.latencyMs + m_config.smoothing * (intervalMean - m_status.latencyMs)
+            : intervalMean;
+        m_hasSample = true;
+    }
+    else if (m_status.inFlight > 0) {
+        // 有在途帧但长时间没有完成，按已等待的时间计（NPU 卡住或严重过载）
+        double stalledMs = std::chrono::duration<double, std::milli>(now - m_lastCompletion).count();
+        if (stalledMs > m_config.latencyBudgetMs) {
+            m_status.latencyMs = std::max(m_status.latencyMs, stalledMs);
+            m_hasSample = true;
+        }
+    }
+    if (!m_hasSample) {
+        return false;
+    }
+
+    // 排队延迟 = 总延迟 - NPU 推理时间（未知时按总延迟计）
+    double queueMs = std::max(m_status.latencyMs - std::max(m_status.npuTimeMs, 0.0), 0.0);
+    int level = m_level;
+    bool unattainable = false;
+    if (m_status.latencyMs > m_config.latencyBudgetMs) {
+        if (m_level == 0) {
+            level = 1;
+        }
+        else if (busySkips > 0 && queueMs > m_config.latencyBudgetMs && m_level < maxLevel()) {
+            // 仍有帧因 NPU 忙而跳过，加大步长能减轻负载
+            level = m_level + 1;
+        }
+        else {
+            // LatestOnly 以上已不排队，剩下的是服务时间，继续降频也降不下来
+            unattainable = true;
+        }
+    }
+    else if (m_status.latencyMs < m_config.latencyBudgetMs * m_config.recoverRatio
+             && !(m_level == 1 && busySkips > 0 && m_config.maxInFlight > 1)) {
+        level = std::max(m_level - 1, 0);
+    }
+
+    bool changed = level != m_level || unattainable != m_status.budgetUnattainable;
+    m_status.budgetUnattainable = unattainable;
+    applyLevel(level);
+    return changed;
+}
+
+void InferenceRateController::applyLevel(int level)
+{
+    m_level = level;
+    if (level <= 0) {
+        m_status.mode = InferenceRateMode::EveryFrame;
+        m_status.stride = 1;
+    }
+    else if (level == 1) {
+        m_status.mode = InferenceRateMode::LatestOnly;
+        m_status.stride = 1;
+    }
+    else {
+        m_status.mode = InferenceRateMode::EveryNth;
+        m_status.stride = level;
+    }
+    m_status.degraded = m_level > 0 || (m_hasSample && m_status.latencyMs > m_config.latencyBudgetMs);
+}
+
+InferenceRateStatus InferenceRateController::status() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_status;
+}
+
+const char* InferenceRateController::modeName(InferenceRateMode mode)
+{
+    switch (mode) {
+    case InferenceRateMode::EveryFrame: return "every-frame";
+    case InferenceRateMode::LatestOnly: return "latest-only";
+    case InferenceRateMode::EveryNth:   return "every-nth";
+    }
+    return "unknown";
+}
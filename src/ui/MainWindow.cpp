@@ -9,7 +9,8 @@
 #include <QDir>
 #include <QFile>
 #include <QTextStream>
-MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_cameraController(new CameraController(this)), m_updateTimer(new QTimer(this)), m_graphicsScene(nullptr), m_graphicsPixmapItem(nullptr), m_frameCount(0), m_currentFPS(0.0), m_yoloModelLoaded(false), m_currentModelIndex(2)
+#include <QScreen>
+MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_cameraController(new CameraController(this)), m_updateTimer(new QTimer(this)), m_graphicsScene(nullptr), m_graphicsPixmapItem(nullptr), m_frameCount(0), m_displayFrameCount(0), m_lastInferenceCompleted(0), m_currentFPS(0.0), m_yoloModelLoaded(false), m_currentModelIndex(2), m_pendingModelIndex(2)
 {
     qDebug() << "########## MainWindow 构造函数第一行 ##########";
     
@@ -71,6 +72,15 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_cameraControlle
     // 初始化FPS计时器
     m_fpsTimer.start();
     
+    // 显示阶段：默认跟随显示器刷新率，环境变量 QTCAMDETECT_PREVIEW_FPS 可指定预览帧率
+    double previewFps = qEnvironmentVariableIntValue("QTCAMDETECT_PREVIEW_FPS");
+    if (previewFps <= 0 && screen())
+    {
+        previewFps = screen()->refreshRate();
+    }
+    m_previewStage.setPreviewFps(previewFps);
+    m_previewStage.start();
+    
     // 连接信号和槽
     connect(ui.refreshButton, &QPushButton::clicked, this, &MainWindow::onRefreshDevices);
     connect(ui.connectButton, &QPushButton::clicked, this, &MainWindow::onConnectCamera);
@@ -97,6 +107,9 @@ MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), m_cameraControlle
 }
 MainWindow::~MainWindow()
 {
+    // 先停止显示阶段，释放它持有的采集帧
+    m_previewStage.stop();
+    
     if (m_cameraController->isConnected())
     {
         m_cameraController->disconnectCamera();
@@ -116,20 +129,59 @@ void MainWindow::setupUI()
     // 创建 YOLO 控制按钮（假设 UI 中有一个容器或我们添加到状态栏）
     m_loadModelButton = new QPushButton("加载 YOLO 模型", this);
     m_toggleYoloButton = new QPushButton("启用检测", this);
+    m_motionGateButton = new QPushButton("静止跳帧", this);
+    m_trackingButton = new QPushButton("目标跟踪", this);
     m_yoloStatusLabel = new QLabel("YOLO: 未加载", this);
+    m_modelLoadTimer = new QTimer(this);
+    m_modelLoadTimer->setInterval(100);
     
     // 初始状态
     m_toggleYoloButton->setEnabled(false);
     m_toggleYoloButton->setCheckable(true);
+    m_motionGateButton->setCheckable(true);
+    m_motionGateButton->setToolTip("画面静止时跳过推理，沿用上次检测结果");
+    m_trackingButton->setCheckable(true);
+    m_trackingButton->setToolTip("为检测目标分配持久 ID，未推理的帧按运动预测框的位置");
     
     // 将按钮添加到状态栏
     statusBar()->addPermanentWidget(m_yoloStatusLabel);
     statusBar()->addPermanentWidget(m_loadModelButton);
     statusBar()->addPermanentWidget(m_toggleYoloButton);
+    statusBar()->addPermanentWidget(m_motionGateButton);
+    statusBar()->addPermanentWidget(m_trackingButton);
     
     // 连接信号
     connect(m_loadModelButton, &QPushButton::clicked, this, &MainWindow::onLoadYoloModel);
     connect(m_toggleYoloButton, &QPushButton::clicked, this, &MainWindow::onToggleYoloDetection);
+    connect(m_motionGateButton, &QPushButton::toggled, this, [this](bool checked) {
+        m_cameraController->enableMotionGating(checked);
+        updateStatus(checked ? "已启用静止跳帧" : "已关闭静止跳帧");
+    });
+    connect(m_trackingButton, &QPushButton::toggled, this, [this](bool checked) {
+        m_cameraController->enableTracking(checked);
+        updateStatus(checked ? "已启用目标跟踪" : "已关闭目标跟踪");
+    });
+    // 轮询后台模型加载（热切换），加载期间当前模型继续检测
+    connect(m_modelLoadTimer, &QTimer::timeout, this, [this]() {
+        YoloDetector::ModelLoadState state = m_cameraController->pollYoloModelLoad();
+        if (state == YoloDetector::ModelLoadState::Loading) {
+            return;
+        }
+        m_modelLoadTimer->stop();
+        m_loadModelButton->setEnabled(true);
+        if (state == YoloDetector::ModelLoadState::Succeeded) {
+            m_currentModelPath = m_pendingModelPath;
+            m_currentModelIndex = m_pendingModelIndex;
+            m_latestDetections.clear();
+            updateStatus(QString("YOLO 模型已切换: %1").arg(QFileInfo(m_currentModelPath).fileName()));
+        }
+        else if (state == YoloDetector::ModelLoadState::Failed) {
+            updateStatus(QString("YOLO 模型切换失败，继续使用: %1").arg(QFileInfo(m_currentModelPath).fileName()));
+        }
+        m_yoloStatusLabel->setText(m_cameraController->isYoloEnabled()
+            ? QString("YOLO: 检测中...")
+            : QString("YOLO: %1 已加载").arg(QFileInfo(m_currentModelPath).fileName()));
+    });
     
     // 设置初始状态
     enableCaptureControls(false);
@@ -178,6 +230,7 @@ void MainWindow::onDisconnectCamera()
     {
         m_updateTimer->stop();
     }
+    m_previewStage.clear();
     
     // 检查当前视频源类型
     VideoSourceType sourceType = m_cameraController->getCurrentSourceType();
@@ -222,6 +275,7 @@ void MainWindow::onSwitchVideoSource()
     {
         m_updateTimer->stop();
     }
+    m_previewStage.clear();
     if (m_cameraController->isConnected())
     {
         m_cameraController->disconnectCamera();
@@ -321,6 +375,7 @@ void MainWindow::onStartCapture()
         
         // 重置FPS计数器
         m_frameCount = 0;
+        m_displayFrameCount = 0;
         m_currentFPS = 0.0;
         m_fpsTimer.restart();
         
@@ -352,6 +407,7 @@ void MainWindow::onStartCapture()
 void MainWindow::onStopCapture()
 {
     m_updateTimer->stop();
+    m_previewStage.clear();
     
     // 检查当前视频源类型
     VideoSourceType sourceType = m_cameraController->getCurrentSourceType();
@@ -464,32 +520,52 @@ void MainWindow::updateImage()
                 qDebug() << "[MainWindow::updateImage] 图像有效，尺寸:" << image.cols << "x" << image.rows;
             }
             
-            // 如果有检测结果，在图像上绘制检测框
-            if (!m_latestDetections.empty())
-            {
-                drawDetectionsOnImage(image, m_latestDetections);
-            }
-            
-            // 转换OpenCV Mat到QPixmap
-            cv::Mat rgbImage;
-            if (image.channels() == 3)
-            {
-                cv::cvtColor(image, rgbImage, cv::COLOR_BGR2RGB);
-            }
-            else
+            // 交给显示阶段（只替换最新帧引用，不缩放、不等待）
+            m_previewStage.submit(image);
+            m_frameCount++;
+        }
+    }
+    
+    // 显示阶段有新的预览帧时才绘制，绘制频率由预览帧率决定，与采集帧率无关
+    m_previewStage.setViewSize(ui.imageLabel->contentsRect().size() * ui.imageLabel->devicePixelRatioF());
+    cv::Mat preview;
+    cv::Size frameSize;
+    if (m_previewStage.take(preview, frameSize))
+    {
+        // 跟踪模式绘制当前帧的轨迹（标签附带轨迹 ID），否则绘制最近一次的检测结果
+        std::vector<BoundingBox> overlayBoxes;
+        if (m_cameraController->isTrackingEnabled())
+        {
+            for (const auto& track : m_cameraController->getCurrentTracks())
             {
-                cv::cvtColor(image, rgbImage, cv::COLOR_GRAY2RGB);
+                BoundingBox box;
+                box.label = track.label;
+                box.score = track.score;
+                box.labelname = (track.labelname.empty() ? std::string() : track.labelname + " ")
+                    + "#" + std::to_string(track.trackId);
+                std::copy(track.box, track.box + 4, box.box);
+                overlayBoxes.push_back(box);
             }
-            QImage qimg(rgbImage.data, rgbImage.cols, rgbImage.rows, rgbImage.step, QImage::Format_RGB888);
+        }
+        else
+        {
+            overlayBoxes = m_latestDetections;
+        }
+        
+        // 在显示分辨率的预览帧上叠加检测框，采集帧保持原样（快照/保存不带框）
+        QImage qimg = DetectionOverlay::render(preview, frameSize, overlayBoxes);
+        if (!qimg.isNull())
+        {
             m_currentImage = QPixmap::fromImage(qimg);
             
-            // 在 imageLabel 中显示相机实时图像（左侧）
+            // 在 imageLabel 中显示相机实时图像（左侧），由 QLabel 拉伸到控件大小
             ui.imageLabel->setPixmap(m_currentImage);
-            
-            // 更新FPS
-            updateFPS();
+            m_displayFrameCount++;
         }
     }
+    
+    // 更新FPS
+    updateFPS();
 }
 void MainWindow::updateStatus(const QString &message)
 {
@@ -511,19 +587,52 @@ void MainWindow::enableConnectionControls(bool enabled)
 
 void MainWindow::updateFPS()
 {
-    m_frameCount++;
-    
     // 每秒更新一次FPS显示
     qint64 elapsed = m_fpsTimer.elapsed();
     if (elapsed >= 1000) // 1秒
     {
         m_currentFPS = (m_frameCount * 1000.0) / elapsed;
+        double displayFps = (m_displayFrameCount * 1000.0) / elapsed;
+        uint64_t inferenceCompleted = 0;
+        double latencySumMs = 0;
+        m_cameraController->getYoloDetector()->getAsyncTiming(inferenceCompleted, latencySumMs);
+        double inferenceFps = inferenceCompleted >= m_lastInferenceCompleted
+            ? ((inferenceCompleted - m_lastInferenceCompleted) * 1000.0) / elapsed : 0.0;
+        m_lastInferenceCompleted = inferenceCompleted;
         
-        // 更新窗口标题显示FPS
-        setWindowTitle(QString("大華相机控制器 - FPS: %1").arg(m_currentFPS, 0, 'f', 1));
+        // 更新窗口标题：采集/推理/显示帧率分开显示，相机采集时附带 SDK 丢帧统计
+        QString title = QString("大華相机控制器 - FPS: 采集 %1 推理 %2 显示 %3")
+            .arg(m_currentFPS, 0, 'f', 1).arg(inferenceFps, 0, 'f', 1).arg(displayFps, 0, 'f', 1);
+        CameraStreamStats streamStats = m_cameraController->getStreamStats();
+        if (streamStats.sdkValid)
+        {
+            title += QString(" - 丢帧: %1 不完整: %2").arg(streamStats.sdkLost).arg(streamStats.sdkIncomplete);
+            qDebug() << "[MainWindow] 相机统计: SDK fps =" << streamStats.sdkFps
+                     << ", 接收" << streamStats.sdkReceived << ", 丢帧" << streamStats.sdkLost
+                     << ", 不完整" << streamStats.sdkIncomplete << ", 队列覆盖" << streamStats.overwritten
+                     << ", 跳过" << streamStats.skipped << ", 平均排队" << streamStats.avgQueueDelayUs << "us";
+        }
+        // 推理降级时提示当前策略，便于现场判断检测是否跟上
+        InferenceRateStatus rate = m_cameraController->getInferenceRateStatus();
+        if (m_cameraController->isYoloEnabled() && rate.degraded)
+        {
+            QString modeText = rate.mode == InferenceRateMode::EveryNth ? QString("每%1帧").arg(rate.stride)
+                : rate.mode == InferenceRateMode::LatestOnly ? QString("仅最新帧") : QString("每帧");
+            title += QString(" - 推理降级: %1 延迟 %2/%3 ms").arg(modeText)
+                .arg(rate.latencyMs, 0, 'f', 0).arg(rate.budgetMs, 0, 'f', 0);
+            if (rate.budgetUnattainable)
+            {
+                title += QString("（预算无法达到）");
+            }
+        }
+        setWindowTitle(title);
+        PreviewStageStats previewStats = m_previewStage.stats();
+        qDebug() << "[MainWindow] 显示统计: 预览" << previewStats.rendered << "/" << previewStats.submitted
+                 << "帧, 被替换" << previewStats.superseded << ", 缩放" << previewStats.scaleMs << "ms";
         
         // 重置计数器
         m_frameCount = 0;
+        m_displayFrameCount = 0;
         m_fpsTimer.restart();
     }
 }
@@ -617,6 +726,30 @@ void MainWindow::onLoadYoloModel()
 {
     qDebug() << "[UI] ========== 开始加载 YOLO 模型 ==========";
     
+    // 已有模型：选择新模型在后台加载，完成后在帧边界切换，期间当前模型继续检测
+    if (m_yoloModelLoaded) {
+        QString newModelPath = QFileDialog::getOpenFileName(this, "切换 YOLO 模型",
+            QFileInfo(m_currentModelPath).absolutePath(), "DXNN Models (*.dxnn)");
+        if (newModelPath.isEmpty()) {
+            return;
+        }
+        bool ok = false;
+        int newIndex = QInputDialog::getInt(this, "切换 YOLO 模型", "YOLO 参数配置索引:",
+                                            m_currentModelIndex, 0, 10, 1, &ok);
+        if (!ok) {
+            return;
+        }
+        if (m_cameraController->loadYoloModelAsync(newModelPath, newIndex)) {
+            m_pendingModelPath = newModelPath;
+            m_pendingModelIndex = newIndex;
+            m_loadModelButton->setEnabled(false);
+            m_yoloStatusLabel->setText(QString("YOLO: 后台加载 %1...").arg(QFileInfo(newModelPath).fileName()));
+            updateStatus(QString("正在后台加载 YOLO 模型: %1").arg(newModelPath));
+            m_modelLoadTimer->start();
+        }
+        return;
+    }
+    
     // 使用老版本 YOLOv7 模型（传统 anchor-based YOLO）
     QString modelPath = "./assets/models/YoloV7.dxnn";
     int paramIndex = 4;  // yolov7_640 (索引 4)
@@ -641,6 +774,7 @@ void MainWindow::onLoadYoloModel()
             QString statusText = QString("YOLO: %1 已加载").arg(fileInfo.fileName());
             m_yoloStatusLabel->setText(statusText);
             m_toggleYoloButton->setEnabled(true);
+            m_loadModelButton->setText("切换 YOLO 模型");
             
             updateStatus(QString("YOLO 模型加载成功: %1").arg(fileInfo.fileName()));
             
@@ -0,0 +1,724 @@
+#include "MultiStreamPipeline.h"
+#include "VideoSource.h"
+#include "YoloDetector.h"
+#include "yolo/image.h"
+#include "IMVApi.h"
+#include <QDebug>
+#include <algorithm>
+
+void StreamStats::accumulate(const StreamStats& other)
+{
+    captured += other.captured;
+    dropped += other.dropped;
+    gated += other.gated;
+    submitted += other.submitted;
+    completed += other.completed;
+    failures += other.failures;
+    detections += other.detections;
+    waitSumMs += other.waitSumMs;
+    latencySumMs += other.latencySumMs;
+    latencyMaxMs = std::max(latencyMaxMs, other.latencyMaxMs);
+    ended = ended || other.ended;
+}
+
+MultiStreamPipeline::MultiStreamPipeline(int maxInFlight)
+    : m_maxInFlight(std::max(maxInFlight, 1))
+    , m_outputType(dxrt::DataType::NONE_TYPE)
+    , m_batchSize(1)
+    , m_batchWindowUs(2000)
+    , m_batchCount(0)
+    , m_batchedFrames(0)
+    , m_stopping(false)
+    , m_batchStopping(false)
+    , m_running(false)
+{
+}
+
+void MultiStreamPipeline::setBatching(int batchSize, int windowUs)
+{
+    if (m_running) {
+        return;
+    }
+    // 一批最多占满全部推理槽位
+    m_batchSize = std::max(1, std::min(batchSize, m_maxInFlight));
+    m_batchWindowUs = std::max(0, windowUs);
+}
+
+void MultiStreamPipeline::takeBatchStats(uint64_t& batches, uint64_t& frames)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    batches = m_batchCount;
+    frames = m_batchedFrames;
+    m_batchCount = 0;
+    m_batchedFrames = 0;
+}
+
+MultiStreamPipeline::~MultiStreamPipeline()
+{
+    stop();
+}
+
+QStringList MultiStreamPipeline::enumerateCameraSources()
+{
+    QStringList sources;
+    IMV_DeviceList deviceList;
+    if (IMV_EnumDevices(&deviceList, interfaceTypeAll) != IMV_OK) {
+        qWarning() << "[MULTI STREAM] 枚举相机失败";
+        return sources;
+    }
+    for (unsigned int i = 0; i < deviceList.nDevNum; i++) {
+        sources.append(QString("camera:%1").arg(i));
+    }
+    return sources;
+}
+
+bool MultiStreamPipeline::initialize(std::unique_ptr<IInferenceBackend> backend, const YoloParam& config)
+{
+    if (m_running || !backend) {
+        return false;
+    }
+    m_config = config;
+    m_backend = std::move(backend);
+    m_outputShapes = m_backend->outputShapes();
+    m_outputType = m_backend->outputType();
+
+    // 每个推理槽位一个输出 buffer 和一个 Yolo（回调并发时互不干扰）
+    m_slots.clear();
+    m_freeSlots.clear();
+    for (int i = 0; i < m_maxInFlight; i++) {
+        auto slot = std::make_unique<Slot>();
+        slot->output.resize(m_backend->outputSize());
+        slot->yolo = std::make_unique<Yolo>(m_config);
+        if (!slot->yolo->LayerReorder(m_backend->outputTensors())) {
+            qCritical() << "[MULTI STREAM] YOLO 层重排序失败";
+            m_backend.reset();
+            m_slots.clear();
+            return false;
+        }
+        m_freeSlots.push_back(slot.get());
+        m_slots.push_back(std::move(slot));
+    }
+
+    m_backend->setCallback(
+        [this](void* output, void* arg)
+        {
+            onInferenceComplete(output, static_cast<Slot*>(arg));
+        });
+
+    qInfo() << "[MULTI STREAM] 共享推理后端:" << QString::fromStdString(m_backend->name())
+            << ", 模型尺寸" << m_config.width << "x" << m_config.height
+            << ", 推理槽位" << m_maxInFlight;
+    return true;
+}
+
+int MultiStreamPipeline::addStream(const StreamSpec& spec)
+{
+    if (!m_backend || m_running) {
+        return -1;
+    }
+
+    auto stream = std::make_unique<Stream>();
+    stream->spec = spec;
+    stream->spec.weight = std::max(spec.weight, 1);
+    stream->live = spec.source.startsWith("camera:") || V4l2CaptureOptions::isV4l2Source(spec.source);
+    SyntheticSourceConfig synthetic;
+    bool isSynthetic = SyntheticSourceConfig::isSyntheticSource(spec.source);
+    if (isSynthetic) {
+        QString error;
+        if (!SyntheticSourceConfig::parse(spec.source, synthetic, &error)) {
+            qCritical() << "[MULTI STREAM] 合成视频源参数错误:" << error;
+            return -1;
+        }
+        // 限速的合成源按相机处理（调度跟不上时丢帧），不限速时按文件源等待调度
+        stream->live = synthetic.fps > 0;
+    }
+    stream->motionGate.setConfig(spec.motionGateConfig);
+
+    if (isSynthetic) {
+        stream->source = std::make_unique<SyntheticVideoSource>(synthetic);
+    }
+    else if (V4l2CaptureOptions::isV4l2Source(spec.source)) {
+        V4l2CaptureOptions options;
+        QString error;
+        if (!V4l2CaptureOptions::parse(spec.source, options, &error)) {
+            qCritical() << "[MULTI STREAM] V4L2 源参数错误:" << error;
+            return -1;
+        }
+        stream->source = std::make_unique<V4l2VideoSource>(options);
+    }
+    else if (stream->live) {
+        auto camera = std::make_unique<CameraVideoSource>(spec.source.mid(7).toInt());
+        camera->setAcquisitionMode(spec.acquisition);
+        camera->setProfileRequest(spec.profileRequest);
+        stream->source = std::move(camera);
+    }
+    else if (ImageSequenceReader::isSequencePath(spec.source)) {
+        auto sequence = std::make_unique<ImageSequenceSource>(spec.source);
+        ImageSequenceOptions options = spec.sequenceOptions;
+        options.loop = spec.loop;
+        sequence->setSequenceOptions(options);
+        stream->source = std::move(sequence);
+    }
+    else {
+        auto file = std::make_unique<VideoFileSource>(spec.source);
+        file->setDecoderOptions(spec.decoderOptions);
+        file->setLoop(spec.loop);
+        stream->source = std::move(file);
+    }
+    if (!stream->source->open()) {
+        qCritical() << "[MULTI STREAM] 无法打开视频源:" << spec.source;
+        return -1;
+    }
+    stream->name = spec.source;
+    stream->interval.name = stream->name;
+    stream->total.name = stream->name;
+
+    // 每路的 Job 数：待调度 1 + 采集中 1 + 最多占满全部推理槽位
+    for (int i = 0; i < m_maxInFlight + 2; i++) {
+        auto job = std::make_unique<Job>();
+        job->input = cv::Mat(m_config.height, m_config.width, CV_8UC3);
+        stream->freeJobs.push_back(std::move(job));
+    }
+
+    int index = (int)m_streams.size();
+    stream->index = index;
+    m_streams.push_back(std::move(stream));
+    qInfo() << "[MULTI STREAM] 流" << index << ":" << spec.source << ", 权重" << m_streams.back()->spec.weight;
+    return index;
+}
+
+bool MultiStreamPipeline::start()
+{
+    if (m_running || !m_backend || m_streams.empty()) {
+        return false;
+    }
+    m_stopping = false;
+    m_running = true;
+    for (auto& stream : m_streams) {
+        Stream* s = stream.get();
+        s->worker = std::thread([this, s] { captureLoop(*s); });
+    }
+    m_scheduler = std::thread([this] { scheduleLoop(); });
+    if (m_batchSize > 1) {
+        // 向量 Run 是同步调用，按推理槽位可容纳的批数开线程，使多批可以同时在 NPU 上
+        m_batchStopping = false;
+        int workers = std::max(1, m_maxInFlight / m_batchSize);
+        for (int i = 0; i < workers; i++) {
+            m_batchWorkers.emplace_back([this] { batchLoop(); });
+        }
+    }
+    qInfo() << "[MULTI STREAM] 已启动" << m_streams.size() << "路"
+            << (m_batchSize > 1 ? QString(", 批大小 %1, 窗口 %2us").arg(m_batchSize).arg(m_batchWindowUs) : QString());
+    return true;
+}
+
+void MultiStreamPipeline::stop()
+{
+    if (!m_running) {
+        return;
+    }
+    m_stopping = true;
+    m_cv.notify_all();
+    if (m_scheduler.joinable()) {
+        m_scheduler.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_batchStopping = true;
+    }
+    m_cv.notify_all();
+    for (auto& worker : m_batchWorkers) {
+        worker.join();
+    }
+    m_batchWorkers.clear();
+    for (auto& stream : m_streams) {
+        if (stream->worker.joinable()) {
+            stream->worker.join();
+        }
+    }
+
+    // 等待已提交的推理回调完成（输出 buffer 和 Job 在回调中仍被使用）
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_cv.wait_for(lock, std::chrono::seconds(5), [this] { return m_freeSlots.size() == m_slots.size(); })) {
+            qWarning() << "[MULTI STREAM] 等待推理完成超时，仍有"
+                       << (m_slots.size() - m_freeSlots.size()) << "帧未返回";
+        }
+    }
+    for (auto& stream : m_streams) {
+        stream->source->close();
+    }
+    m_running = false;
+    qInfo() << "[MULTI STREAM] 已停止";
+}
+
+QString MultiStreamPipeline::streamName(int stream) const
+{
+    return stream >= 0 && stream < (int)m_streams.size() ? m_streams[stream]->name : QString();
+}
+
+bool MultiStreamPipeline::cameraStats(int stream, CameraStreamStats& stats) const
+{
+    if (stream < 0 || stream >= (int)m_streams.size()) {
+        return false;
+    }
+    auto* camera = dynamic_cast<CameraVideoSource*>(m_streams[stream]->source.get());
+    if (!camera) {
+        return false;
+    }
+    stats = camera->getStreamStats();
+    return true;
+}
+
+bool MultiStreamPipeline::videoStats(int stream, VideoDecoderStats& stats) const
+{
+    if (stream < 0 || stream >= (int)m_streams.size()) {
+        return false;
+    }
+    auto* file = dynamic_cast<VideoFileSource*>(m_streams[stream]->source.get());
+    if (!file) {
+        return false;
+    }
+    stats = file->getDecoderStats();
+    return true;
+}
+
+bool MultiStreamPipeline::imageSequenceStats(int stream, ImageSequenceStats& stats) const
+{
+    if (stream < 0 || stream >= (int)m_streams.size()) {
+        return false;
+    }
+    auto* sequence = dynamic_cast<ImageSequenceSource*>(m_streams[stream]->source.get());
+    if (!sequence) {
+        return false;
+    }
+    stats = sequence->getSequenceStats();
+    return true;
+}
+
+bool MultiStreamPipeline::syntheticStats(int stream, SyntheticStreamStats& stats) const
+{
+    if (stream < 0 || stream >= (int)m_streams.size()) {
+        return false;
+    }
+    auto* synthetic = dynamic_cast<SyntheticVideoSource*>(m_streams[stream]->source.get());
+    if (!synthetic) {
+        return false;
+    }
+    stats = synthetic->getStats();
+    return true;
+}
+
+bool MultiStreamPipeline::v4l2Stats(int stream, V4l2CaptureStats& stats) const
+{
+    if (stream < 0 || stream >= (int)m_streams.size()) {
+        return false;
+    }
+    auto* v4l2 = dynamic_cast<V4l2VideoSource*>(m_streams[stream]->source.get());
+    if (!v4l2) {
+        return false;
+    }
+    stats = v4l2->getStats();
+    return true;
+}
+
+void MultiStreamPipeline::captureLoop(Stream& stream)
+{
+    cv::Mat frame;
+    while (!m_stopping) {
+        if (!stream.source->grabFrame(frame) || frame.empty()) {
+            if (!stream.live && !stream.spec.loop) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                stream.interval.ended = true;
+                qInfo() << "[MULTI STREAM]" << stream.name << "播放结束";
+                break;
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                stream.interval.failures++;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        Clock::time_point grabTime = Clock::now();
+
+        // 静止帧不预处理也不调度，该路的最新结果保持不变
+        if (stream.spec.motionGate && !stream.motionGate.update(frame)) {
+            frame.release();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stream.interval.gated++;
+            continue;
+        }
+
+        std::unique_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [&] { return m_stopping || !stream.freeJobs.empty(); });
+            if (m_stopping) {
+                break;
+            }
+            job = std::move(stream.freeJobs.back());
+            stream.freeJobs.pop_back();
+        }
+
+        // 预处理在本路线程完成，调度线程只负责提交
+        PreProc(frame, job->input, true, true, 114);
+        job->originalWidth = frame.cols;
+        job->originalHeight = frame.rows;
+        job->inputName = stream.source->getFrameName();
+        job->grabTime = grabTime;
+        // 相机帧可能引用 SDK 缓冲，预处理后立即释放
+        frame.release();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (stream.ready) {
+            if (stream.live) {
+                // 实时源只保留最新帧，被替换的帧计为丢帧
+                recycle(stream, std::move(stream.ready));
+                stream.interval.dropped++;
+            }
+            else {
+                m_cv.wait(lock, [&] { return m_stopping || !stream.ready; });
+                if (m_stopping) {
+                    recycle(stream, std::move(job));
+                    break;
+                }
+            }
+        }
+        job->stream = stream.index;
+        job->readyTime = Clock::now();
+        stream.ready = std::move(job);
+        stream.interval.captured++;
+        lock.unlock();
+        // 进入待调度即视为已提交：之后的静止帧不会替换它，变化帧会替换为更新的画面
+        if (stream.spec.motionGate) {
+            stream.motionGate.markSubmitted();
+        }
+        m_cv.notify_all();
+    }
+}
+
+int MultiStreamPipeline::pickStream()
+{
+    // 平滑加权轮询（nginx 算法）：只在有待调度帧的流之间分配，权重相同时退化为轮询
+    int totalWeight = 0;
+    int best = -1;
+    for (size_t i = 0; i < m_streams.size(); i++) {
+        Stream& stream = *m_streams[i];
+        if (!stream.ready) {
+            continue;
+        }
+        stream.currentWeight += stream.spec.weight;
+        totalWeight += stream.spec.weight;
+        if (best < 0 || stream.currentWeight > m_streams[best]->currentWeight) {
+            best = (int)i;
+        }
+    }
+    if (best >= 0) {
+        m_streams[best]->currentWeight -= totalWeight;
+    }
+    return best;
+}
+
+bool MultiStreamPipeline::canSubmit() const
+{
+    if (m_freeSlots.empty()) {
+        return false;
+    }
+    for (const auto& stream : m_streams) {
+        if (stream->ready) {
+            return true;
+        }
+    }
+    return false;
+}
+
+MultiStreamPipeline::Slot* MultiStreamPipeline::takeNext()
+{
+    Stream& stream = *m_streams[pickStream()];
+    Slot* slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    slot->job = std::move(stream.ready);
+    // 帧号在提交时分配：被替换的帧不占号，交付端按连续帧号排序
+    slot->job->frameId = ++stream.nextFrameId;
+    stream.inFlight.emplace(slot->job->frameId, Clock::now());
+    stream.interval.submitted++;
+    stream.interval.waitSumMs += std::chrono::duration<double, std::milli>(Clock::now() - slot->job->readyTime).count();
+    return slot;
+}
+
+void MultiStreamPipeline::failSlot(Slot* slot)
+{
+    Stream& stream = *m_streams[slot->job->stream];
+    uint64_t frameId = slot->job->frameId;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stream.interval.failures++;
+        recycle(stream, std::move(slot->job));
+        m_freeSlots.push_back(slot);
+    }
+    m_cv.notify_all();
+
+    // 失败的帧也要占住帧号，后续帧才能继续交付
+    Completed failed;
+    failed.ok = false;
+    deliver(stream, frameId, std::move(failed));
+}
+
+void MultiStreamPipeline::scheduleLoop()
+{
+    Clock::time_point nextCheck = Clock::now() + std::chrono::milliseconds(kReorderTimeoutMs / 4);
+    while (true) {
+        // 回调一直不来的帧不会触发交付，由调度线程定期检查，空闲的流也不会停在缺失的帧号上
+        if (Clock::now() >= nextCheck) {
+            checkReorderTimeouts();
+            nextCheck = Clock::now() + std::chrono::milliseconds(kReorderTimeoutMs / 4);
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_cv.wait_until(lock, nextCheck, [this] { return m_stopping || canSubmit(); })) {
+            continue;
+        }
+        if (m_stopping) {
+            break;
+        }
+
+        std::vector<Slot*> batch;
+        batch.push_back(takeNext());
+        if (m_batchSize > 1) {
+            // 第一帧就绪后在时间窗口内继续凑批，窗口结束或凑满即提交
+            Clock::time_point deadline = Clock::now() + std::chrono::microseconds(m_batchWindowUs);
+            while ((int)batch.size() < m_batchSize) {
+                if (!m_cv.wait_until(lock, deadline, [this] { return m_stopping || canSubmit(); }) || m_stopping) {
+                    break;
+                }
+                batch.push_back(takeNext());
+            }
+            m_batchQueue.push_back(std::move(batch));
+            m_batchCount++;
+            m_batchedFrames += m_batchQueue.back().size();
+        }
+        lock.unlock();
+        // 待调度槽已空，文件源的采集线程可以放入下一帧；批量线程可以取批
+        m_cv.notify_all();
+
+        if (m_batchSize > 1) {
+            continue;
+        }
+        Slot* slot = batch.front();
+        int jobId = -1;
+        try {
+            jobId = m_backend->runAsync(slot->job->input.data, slot, slot->output.data());
+        }
+        catch (const std::exception& e) {
+            qCritical() << "[MULTI STREAM] 推理提交异常:" << e.what();
+        }
+        if (jobId < 0) {
+            failSlot(slot);
+        }
+    }
+}
+
+void MultiStreamPipeline::batchLoop()
+{
+    while (true) {
+        std::vector<Slot*> batch;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // 停止时先处理完已凑好的批，槽位才能全部归还
+            m_cv.wait(lock, [this] { return m_batchStopping || !m_batchQueue.empty(); });
+            if (m_batchQueue.empty()) {
+                break;
+            }
+            batch = std::move(m_batchQueue.front());
+            m_batchQueue.pop_front();
+        }
+
+        std::vector<void*> inputs, outputs;
+        for (Slot* slot : batch) {
+            inputs.push_back(slot->job->input.data);
+            outputs.push_back(slot->output.data());
+        }
+        bool ok = false;
+        try {
+            ok = m_backend->runBatch(inputs, outputs);
+        }
+        catch (const std::exception& e) {
+            qCritical() << "[MULTI STREAM] 批量推理异常:" << e.what();
+        }
+        for (Slot* slot : batch) {
+            if (ok) {
+                onInferenceComplete(slot->output.data(), slot);
+            }
+            else {
+                failSlot(slot);
+            }
+        }
+    }
+}
+
+void MultiStreamPipeline::onInferenceComplete(void* output, Slot* slot)
+{
+    if (!slot || !slot->job) {
+        return;
+    }
+    Job& job = *slot->job;
+    std::vector<BoundingBox> results;
+    try {
+        int outputLength = static_cast<int>(slot->output.size() / sizeof(float));
+        results = slot->yolo->PostProc(output, m_outputShapes, m_outputType, outputLength);
+        if (!results.empty()) {
+            YoloDetector::scaleCoordinates(results, job.originalWidth, job.originalHeight,
+                                           m_config.width, m_config.height);
+        }
+    }
+    catch (const std::exception& e) {
+        qCritical() << "[MULTI STREAM] 后处理失败:" << e.what();
+    }
+    Stream& stream = *m_streams[job.stream];
+    uint64_t frameId = job.frameId;
+    Completed completed;
+    completed.ok = true;
+    completed.results = std::move(results);
+    completed.inputName = job.inputName;
+    completed.grabTime = job.grabTime;
+
+    // 先归还 Job 和槽位（推理槽位不等待排序），再按帧序交付
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        recycle(stream, std::move(slot->job));
+        m_freeSlots.push_back(slot);
+    }
+    m_cv.notify_all();
+    deliver(stream, frameId, std::move(completed));
+}
+
+void MultiStreamPipeline::deliver(Stream& stream, uint64_t frameId, Completed completed)
+{
+    // 多设备或多核并行时完成顺序可能乱序，按帧号缓存后连续交付
+    std::lock_guard<std::mutex> deliverLock(stream.deliverMutex);
+    {
+        // 在 deliverMutex 内移出在途表，超时检查不会看到既不在途也不在缓冲中的帧号
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stream.inFlight.erase(frameId);
+    }
+    if (frameId < stream.nextDeliverId) {
+        return;   // 已超时跳过（计为失败）的帧迟到，不再交付
+    }
+    stream.pending.emplace(frameId, std::move(completed));
+    drainReorder(stream);
+}
+
+void MultiStreamPipeline::checkReorderTimeouts()
+{
+    for (auto& stream : m_streams) {
+        // 该路正在交付时由交付方自己检查，调度线程不等待结果回调
+        std::unique_lock<std::mutex> deliverLock(stream->deliverMutex, std::try_to_lock);
+        if (deliverLock.owns_lock()) {
+            drainReorder(*stream);
+        }
+    }
+}
+
+void MultiStreamPipeline::drainReorder(Stream& stream)
+{
+    while (true) {
+        if (stream.pending.empty() || stream.pending.begin()->first != stream.nextDeliverId) {
+            // 缺失的帧号还在推理中：未超时则继续等待；不在途说明尚未分配，同样等待
+            Clock::time_point submitTime;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto flight = stream.inFlight.find(stream.nextDeliverId);
+                if (flight == stream.inFlight.end()
+                    || Clock::now() - flight->second < std::chrono::milliseconds(kReorderTimeoutMs)) {
+                    return;
+                }
+                submitTime = flight->second;
+                stream.inFlight.erase(flight);
+                stream.interval.failures++;
+            }
+            qWarning() << "[MULTI STREAM]" << stream.name << "帧" << stream.nextDeliverId << "提交后"
+                       << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - submitTime).count()
+                       << "ms 未返回推理结果，跳过";
+            stream.nextDeliverId++;
+            continue;
+        }
+
+        Completed next = std::move(stream.pending.begin()->second);
+        uint64_t id = stream.pending.begin()->first;
+        stream.pending.erase(stream.pending.begin());
+        stream.nextDeliverId++;
+        if (!next.ok) {
+            continue;
+        }
+
+        double latencyMs = std::chrono::duration<double, std::milli>(Clock::now() - next.grabTime).count();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stream.interval.completed++;
+            stream.interval.detections += next.results.size();
+            stream.interval.latencySumMs += latencyMs;
+            stream.interval.latencyMaxMs = std::max(stream.interval.latencyMaxMs, latencyMs);
+            stream.latestResults = next.results;
+            stream.latestFrameId = id;
+        }
+        if (m_resultCallback) {
+            m_resultCallback(stream.index, id, next.inputName, next.results, latencyMs);
+        }
+    }
+}
+
+void MultiStreamPipeline::recycle(Stream& stream, std::unique_ptr<Job> job)
+{
+    if (job) {
+        stream.freeJobs.push_back(std::move(job));
+    }
+}
+
+bool MultiStreamPipeline::getLatestResults(int stream, std::vector<BoundingBox>& results, uint64_t& frameId) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (stream < 0 || stream >= (int)m_streams.size()) {
+        return false;
+    }
+    results = m_streams[stream]->latestResults;
+    frameId = m_streams[stream]->latestFrameId;
+    return true;
+}
+
+std::vector<StreamStats> MultiStreamPipeline::takeIntervalStats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<StreamStats> stats;
+    for (auto& stream : m_streams) {
+        stats.push_back(stream->interval);
+        stream->total.accumulate(stream->interval);
+        bool ended = stream->interval.ended;
+        stream->interval = StreamStats();
+        stream->interval.name = stream->name;
+        stream->interval.ended = ended;
+    }
+    return stats;
+}
+
+std::vector<StreamStats> MultiStreamPipeline::totalStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<StreamStats> stats;
+    for (const auto& stream : m_streams) {
+        StreamStats total = stream->total;
+        total.accumulate(stream->interval);
+        stats.push_back(total);
+    }
+    return stats;
+}
+
+bool MultiStreamPipeline::allEnded() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& stream : m_streams) {
+        if (!stream->interval.ended) {
+            return false;
+        }
+    }
+    return !m_streams.empty();
+}
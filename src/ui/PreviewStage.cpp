@@ -0,0 +1,176 @@
+#include "PreviewStage.h"
+#include <QDebug>
+#include <algorithm>
+
+PreviewStage::PreviewStage()
+    : m_running(false)
+    , m_busy(false)
+    , m_generation(0)
+    , m_previewFps(0)
+{
+}
+
+PreviewStage::~PreviewStage()
+{
+    stop();
+}
+
+void PreviewStage::start()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_running) {
+        return;
+    }
+    m_running = true;
+    m_nextSlot = Clock::now();
+    m_worker = std::thread(&PreviewStage::workerLoop, this);
+    qDebug() << "[PreviewStage] 启动, 预览帧率:" << (m_previewFps > 0 ? QString::number(m_previewFps, 'f', 1) : QString("不限"));
+}
+
+void PreviewStage::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_running) {
+            return;
+        }
+        m_running = false;
+    }
+    m_cond.notify_all();
+    m_worker.join();
+    clear();
+}
+
+void PreviewStage::setPreviewFps(double fps)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_previewFps = fps;
+    m_nextSlot = Clock::now();
+}
+
+double PreviewStage::previewFps() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_previewFps;
+}
+
+void PreviewStage::setViewSize(const QSize& size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_viewSize = size;
+}
+
+void PreviewStage::submit(const cv::Mat& frame)
+{
+    if (frame.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_pending.empty()) {
+            m_stats.superseded++;
+        }
+        m_pending = frame;     // 浅拷贝，旧的待处理帧在这里释放
+        m_stats.submitted++;
+    }
+    m_cond.notify_one();
+}
+
+bool PreviewStage::take(cv::Mat& preview, cv::Size& frameSize)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_ready.empty()) {
+        return false;
+    }
+    preview = std::move(m_ready);
+    m_ready.release();
+    frameSize = m_readyFrameSize;
+    return true;
+}
+
+void PreviewStage::clear()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_pending.release();
+    m_ready.release();
+    m_generation++;
+    // 工作线程正在锁外缩放的帧也引用着采集缓冲，等它释放后再返回（调用方随后可能关闭相机）
+    m_idle.wait(lock, [&] { return !m_busy; });
+}
+
+PreviewStageStats PreviewStage::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+cv::Size PreviewStage::displaySize(const cv::Size& frameSize, const QSize& viewSize)
+{
+    if (viewSize.width() <= 0 || viewSize.height() <= 0) {
+        return frameSize;
+    }
+    return cv::Size(std::min(frameSize.width, viewSize.width()), std::min(frameSize.height, viewSize.height()));
+}
+
+void PreviewStage::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_running) {
+        m_cond.wait(lock, [&] { return !m_running || !m_pending.empty(); });
+        if (!m_running) {
+            break;
+        }
+        // 按预览帧率节拍等待，等待期间到达的新帧替换旧帧，到点时取的总是最新帧
+        if (m_previewFps > 0 && Clock::now() < m_nextSlot) {
+            m_cond.wait_until(lock, m_nextSlot, [&] { return !m_running; });
+            if (!m_running || m_pending.empty()) {
+                continue;
+            }
+        }
+
+        cv::Mat frame = std::move(m_pending);
+        m_pending.release();
+        m_busy = true;
+        const cv::Size target = displaySize(frame.size(), m_viewSize);
+        const uint64_t generation = m_generation;
+        if (m_previewFps > 0) {
+            auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_previewFps));
+            m_nextSlot = std::max(m_nextSlot + period, Clock::now());
+        }
+        lock.unlock();
+
+        // INTER_AREA 缩小时对源像素取平均，预览不闪烁、不出现摩尔纹；结果是自有内存，界面可以直接在上面绘制
+        auto start = Clock::now();
+        cv::Mat scaled;
+        if (target == frame.size()) {
+            scaled = frame.channels() == 3 ? frame.clone() : frame;
+        }
+        else {
+            cv::resize(frame, scaled, target, 0, 0, cv::INTER_AREA);
+        }
+        cv::Mat preview;
+        if (scaled.channels() == 1) {
+            cv::cvtColor(scaled, preview, cv::COLOR_GRAY2BGR);
+        }
+        else if (scaled.channels() == 4) {
+            cv::cvtColor(scaled, preview, cv::COLOR_BGRA2BGR);
+        }
+        else {
+            preview = scaled;
+        }
+        const cv::Size frameSize = frame.size();
+        frame.release();       // 尽快归还采集缓冲
+        double scaleMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        lock.lock();
+        m_busy = false;
+        m_idle.notify_all();
+        if (generation != m_generation) {
+            continue;
+        }
+        m_ready = preview;
+        m_readyFrameSize = frameSize;
+        m_stats.rendered++;
+        m_stats.scaleMs = scaleMs;
+    }
+}
@@ -0,0 +1,334 @@
+#include "SyntheticFrameGenerator.h"
+#include <QDebug>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+void* allocatePages(size_t bytes)
+{
+    return VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+}
+
+bool protectPages(void* pages, size_t bytes)
+{
+    DWORD oldProtect = 0;
+    return VirtualProtect(pages, bytes, PAGE_READONLY, &oldProtect) != 0;
+}
+
+void freePages(void* pages, size_t)
+{
+    VirtualFree(pages, 0, MEM_RELEASE);
+}
+#else
+void* allocatePages(size_t bytes)
+{
+    void* pages = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return pages == MAP_FAILED ? nullptr : pages;
+}
+
+bool protectPages(void* pages, size_t bytes)
+{
+    return mprotect(pages, bytes, PROT_READ) == 0;
+}
+
+void freePages(void* pages, size_t bytes)
+{
+    munmap(pages, bytes);
+}
+#endif
+}
+
+bool SyntheticSourceConfig::parse(const QString& source, SyntheticSourceConfig& config, QString* error)
+{
+    auto fail = [&](const QString& message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+    if (!isSyntheticSource(source)) {
+        return fail("不是 synthetic: 源");
+    }
+
+    SyntheticSourceConfig parsed;
+    for (const QString& rawToken : source.mid(10).split(',', Qt::SkipEmptyParts)) {
+        QString token = rawToken.trimmed().toLower();
+        bool ok = true;
+        if (token == "mono8") {
+            parsed.format = SyntheticPixelFormat::Mono8;
+        }
+        else if (token == "bayer" || token == "bayerrg8") {
+            parsed.format = SyntheticPixelFormat::BayerRG8;
+        }
+        else if (token == "bgr8") {
+            parsed.format = SyntheticPixelFormat::BGR8;
+        }
+        else if (token.startsWith("objects=")) {
+            parsed.objects = token.mid(8).toInt(&ok);
+        }
+        else if (token.startsWith("pool=")) {
+            parsed.poolSize = token.mid(5).toInt(&ok);
+        }
+        else if (token.startsWith("seed=")) {
+            parsed.seed = token.mid(5).toUInt(&ok);
+        }
+        else if (token.contains('x') || token.startsWith('@')) {
+            // WxH、WxH@fps 或 @fps
+            int at = token.indexOf('@');
+            QString size = at >= 0 ? token.left(at) : token;
+            if (!size.isEmpty()) {
+                QStringList parts = size.split('x');
+                bool okWidth = false, okHeight = false;
+                if (parts.size() == 2) {
+                    parsed.width = parts[0].toInt(&okWidth);
+                    parsed.height = parts[1].toInt(&okHeight);
+                }
+                ok = okWidth && okHeight;
+            }
+            if (ok && at >= 0) {
+                parsed.fps = token.mid(at + 1).toDouble(&ok);
+            }
+        }
+        else {
+            ok = false;
+        }
+        if (!ok) {
+            return fail(QString("无法解析参数: %1").arg(rawToken));
+        }
+    }
+    if (parsed.width < 16 || parsed.height < 16 || parsed.fps < 0 || parsed.objects < 0 || parsed.poolSize < 0) {
+        return fail(QString("参数超出范围: %1").arg(source));
+    }
+    config = parsed;
+    return true;
+}
+
+const char* SyntheticSourceConfig::formatName() const
+{
+    switch (format) {
+    case SyntheticPixelFormat::Mono8:
+        return "mono8";
+    case SyntheticPixelFormat::BayerRG8:
+        return "bayer";
+    default:
+        return "bgr8";
+    }
+}
+
+size_t SyntheticSourceConfig::frameBytes() const
+{
+    return (size_t)width * height * (format == SyntheticPixelFormat::BGR8 ? 3 : 1);
+}
+
+int SyntheticSourceConfig::effectivePoolSize() const
+{
+    if (poolSize > 0) {
+        return poolSize;
+    }
+    size_t frames = kDefaultPoolBytes / std::max<size_t>(frameBytes(), 1);
+    return (int)std::min<size_t>(std::max<size_t>(frames, kMinPoolFrames), kMaxPoolFrames);
+}
+
+QString SyntheticSourceConfig::toString() const
+{
+    return QString("synthetic:%1x%2@%3,%4,objects=%5,pool=%6,seed=%7")
+        .arg(width).arg(height).arg(fps).arg(formatName()).arg(objects).arg(effectivePoolSize()).arg(seed);
+}
+
+// 池帧的内存只由这里释放；引用计数由 cv::Mat 自身的 UMatData 维护
+// Mat::create 需要重新分配时交给标准分配器，新内存与池无关
+class SyntheticFramePool::ReadOnlyAllocator : public cv::MatAllocator
+{
+public:
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(data, accessFlags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* u) const override
+    {
+        if (!u) {
+            return;
+        }
+        freePages(u->origdata, u->size);
+        delete u;
+    }
+};
+
+const SyntheticFramePool::ReadOnlyAllocator& SyntheticFramePool::allocator()
+{
+    static ReadOnlyAllocator instance;
+    return instance;
+}
+
+std::shared_ptr<const SyntheticFramePool> SyntheticFramePool::acquire(const SyntheticSourceConfig& config)
+{
+    // 帧率不影响帧内容，不同帧率的流也共享同一个池
+    SyntheticSourceConfig key = config;
+    key.fps = 0;
+    static std::mutex mutex;
+    static std::map<QString, std::weak_ptr<const SyntheticFramePool>> pools;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::weak_ptr<const SyntheticFramePool>& entry = pools[key.toString()];
+    std::shared_ptr<const SyntheticFramePool> pool = entry.lock();
+    if (!pool) {
+        pool = std::make_shared<SyntheticFramePool>(config);
+        entry = pool;
+    }
+    return pool;
+}
+
+SyntheticFramePool::SyntheticFramePool(const SyntheticSourceConfig& config)
+{
+    render(config);
+    qDebug() << "[SyntheticFramePool]" << config.toString() << ", 预渲染" << size() << "帧,"
+             << bytes() / (1024 * 1024) << "MB";
+}
+
+size_t SyntheticFramePool::bytes() const
+{
+    size_t total = 0;
+    for (const cv::Mat& frame : m_frames) {
+        total += frame.total() * frame.elemSize();
+    }
+    return total;
+}
+
+cv::Mat SyntheticFramePool::toBayerRG(const cv::Mat& bgr)
+{
+    // RGGB：偶数行 R G R G...，奇数行 G B G B...
+    cv::Mat bayer(bgr.rows, bgr.cols, CV_8UC1);
+    for (int y = 0; y < bgr.rows; y++) {
+        const cv::Vec3b* src = bgr.ptr<cv::Vec3b>(y);
+        uint8_t* dst = bayer.ptr<uint8_t>(y);
+        const int first = (y & 1) ? 1 : 2;     // 偶数列取 R（偶数行）或 G（奇数行）
+        const int second = (y & 1) ? 0 : 1;    // 奇数列取 G（偶数行）或 B（奇数行）
+        for (int x = 0; x < bgr.cols; x++) {
+            dst[x] = src[x][(x & 1) ? second : first];
+        }
+    }
+    return bayer;
+}
+
+cv::Mat SyntheticFramePool::toReadOnly(const cv::Mat& frame)
+{
+    size_t bytes = frame.total() * frame.elemSize();
+    void* pages = allocatePages(bytes);
+    if (!pages) {
+        qWarning() << "[SyntheticFramePool] 分配只读帧内存失败，使用普通内存";
+        return frame.clone();
+    }
+    cv::Mat image(frame.rows, frame.cols, frame.type(), pages);
+    frame.copyTo(image);
+    if (!protectPages(pages, bytes)) {
+        qWarning() << "[SyntheticFramePool] 设置帧内存只读失败";
+    }
+
+    // 给外部数据挂上引用计数：refcount 归零时 ReadOnlyAllocator::deallocate 释放页面
+    auto* u = new cv::UMatData(&allocator());
+    u->data = u->origdata = static_cast<uchar*>(pages);
+    u->size = bytes;
+    u->refcount = 1;
+    image.u = u;
+    return image;
+}
+
+void SyntheticFramePool::render(const SyntheticSourceConfig& config)
+{
+    const int width = config.width;
+    const int height = config.height;
+    cv::RNG rng(config.seed);
+
+    // 背景：四角插值的渐变 + 网格 + 固定噪声
+    cv::Mat corners(2, 2, CV_8UC3);
+    for (int i = 0; i < 4; i++) {
+        corners.at<cv::Vec3b>(i / 2, i % 2) = cv::Vec3b((uchar)rng.uniform(40, 200), (uchar)rng.uniform(40, 200),
+                                                        (uchar)rng.uniform(40, 200));
+    }
+    cv::Mat background;
+    cv::resize(corners, background, cv::Size(width, height), 0, 0, cv::INTER_LINEAR);
+    for (int x = 0; x < width; x += 64) {
+        cv::line(background, cv::Point(x, 0), cv::Point(x, height - 1), cv::Scalar(90, 90, 90), 1);
+    }
+    for (int y = 0; y < height; y += 64) {
+        cv::line(background, cv::Point(0, y), cv::Point(width - 1, y), cv::Scalar(90, 90, 90), 1);
+    }
+    cv::Mat noise(height, width, CV_8UC3);
+    rng.fill(noise, cv::RNG::UNIFORM, 0, 24);
+    background += noise;
+
+    struct Object
+    {
+        cv::Size size;
+        cv::Scalar color;
+        double amplitudeX, amplitudeY;
+        int cyclesX, cyclesY;              // 整数周期数：轨迹在池长度内闭合
+        double phaseX, phaseY;
+    };
+    std::vector<Object> objects(config.objects);
+    for (Object& object : objects) {
+        int side = std::min(width, height);
+        object.size = cv::Size(rng.uniform(side / 16, side / 5 + 1), rng.uniform(side / 16, side / 5 + 1));
+        object.color = cv::Scalar(rng.uniform(0, 256), rng.uniform(0, 256), rng.uniform(0, 256));
+        object.amplitudeX = (width - object.size.width) / 2.0 * rng.uniform(0.3, 1.0);
+        object.amplitudeY = (height - object.size.height) / 2.0 * rng.uniform(0.3, 1.0);
+        object.cyclesX = rng.uniform(1, 4);
+        object.cyclesY = rng.uniform(1, 4);
+        object.phaseX = rng.uniform(0.0, 2 * CV_PI);
+        object.phaseY = rng.uniform(0.0, 2 * CV_PI);
+    }
+
+    const int poolSize = config.effectivePoolSize();
+    m_frames.reserve(poolSize);
+    cv::Mat canvas;
+    for (int i = 0; i < poolSize; i++) {
+        background.copyTo(canvas);
+        double t = 2 * CV_PI * i / poolSize;
+        for (const Object& object : objects) {
+            int cx = (int)(width / 2.0 + object.amplitudeX * std::sin(object.cyclesX * t + object.phaseX));
+            int cy = (int)(height / 2.0 + object.amplitudeY * std::sin(object.cyclesY * t + object.phaseY));
+            cv::Rect rect(cx - object.size.width / 2, cy - object.size.height / 2, object.size.width, object.size.height);
+            cv::rectangle(canvas, rect, object.color, cv::FILLED);
+            cv::rectangle(canvas, rect, cv::Scalar(20, 20, 20), 3);
+        }
+
+        switch (config.format) {
+        case SyntheticPixelFormat::Mono8: {
+            cv::Mat gray;
+            cv::cvtColor(canvas, gray, cv::COLOR_BGR2GRAY);
+            m_frames.push_back(toReadOnly(gray));
+            break;
+        }
+        case SyntheticPixelFormat::BayerRG8:
+            m_frames.push_back(toReadOnly(toBayerRG(canvas)));
+            break;
+        default:
+            m_frames.push_back(toReadOnly(canvas));
+            break;
+        }
+    }
+}
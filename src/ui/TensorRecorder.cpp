@@ -0,0 +1,168 @@
+#include "TensorRecorder.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using namespace dxapp::common;
+
+TensorRecorder::TensorRecorder()
+    : m_outputSize(0)
+    , m_stopping(false)
+    , m_copying(0)
+    , m_recording(false)
+    , m_recorded(0)
+    , m_dropped(0)
+{
+}
+
+TensorRecorder::~TensorRecorder()
+{
+    stop();
+}
+
+bool TensorRecorder::start(const std::string& path,
+                           const std::string& modelName,
+                           const std::vector<OutputTensorDesc>& descs,
+                           uint64_t outputSize,
+                           int poolSize)
+{
+    stop();
+
+    std::vector<CaptureTensorDesc> tensors;
+    for (const auto& desc : descs) {
+        CaptureTensorDesc t{};
+        std::strncpy(t.name, desc.name.c_str(), sizeof(t.name) - 1);
+        t.dtype = static_cast<int32_t>(desc.type);
+        t.numDims = static_cast<uint32_t>(std::min<size_t>(desc.shape.size(), kCaptureMaxDims));
+        for (uint32_t i = 0; i < t.numDims; i++) {
+            t.dims[i] = desc.shape[i];
+        }
+        t.offset = desc.offset;
+        t.sizeInBytes = desc.sizeInBytes;
+        tensors.push_back(t);
+    }
+
+    if (!m_writer.open(path, modelName, tensors, outputSize)) {
+        qWarning() << "[RECORDER] 无法创建录制文件:" << QString::fromStdString(path);
+        return false;
+    }
+
+    // stop() 已等待所有进行中的 record() 拷贝完成，且 m_recording 为 false 时 record() 不会访问槽位
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_path = path;
+        m_outputSize = outputSize;
+        m_slots.assign(std::max(1, poolSize), std::vector<uint8_t>(outputSize));
+        m_freeSlots.clear();
+        for (int i = 0; i < (int)m_slots.size(); i++) {
+            m_freeSlots.push_back(i);
+        }
+        m_pending.clear();
+        m_stopping = false;
+        m_recorded = 0;
+        m_dropped = 0;
+        m_thread = std::thread(&TensorRecorder::writerLoop, this);
+        m_recording.store(true, std::memory_order_release);
+    }
+    qDebug() << "[RECORDER] 开始录制:" << QString::fromStdString(path)
+             << ", 每帧" << outputSize << "bytes, 槽位" << m_slots.size();
+    return true;
+}
+
+void TensorRecorder::stop()
+{
+    if (!m_thread.joinable()) {
+        return;
+    }
+    {
+        // 之后的 record() 不再取槽位；已取得槽位的拷贝完成入队后再让写线程退出
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_recording.store(false, std::memory_order_release);
+        m_copyDone.wait(lock, [this] { return m_copying == 0; });
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+    m_writer.close();
+    qDebug() << "[RECORDER] 录制结束:" << QString::fromStdString(m_path)
+             << ", 已写入" << m_recorded.load() << "帧, 丢弃" << m_dropped.load() << "帧";
+}
+
+bool TensorRecorder::record(uint64_t frameId, const std::string& inputRef,
+                            int inputWidth, int inputHeight, const void* output)
+{
+    if (!isRecording() || !output) {
+        return false;
+    }
+
+    int slot = -1;
+    {
+        // 在锁内确认仍在录制，stop()/start() 不会在拷贝期间重新分配槽位
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!isRecording()) {
+            return false;
+        }
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+            m_copying++;
+        }
+    }
+    if (slot < 0) {
+        m_dropped++;
+        return false;
+    }
+
+    std::memcpy(m_slots[slot].data(), output, m_outputSize);
+
+    Pending pending{};
+    pending.slot = slot;
+    pending.header.magic = kCaptureRecordMagic;
+    pending.header.payloadSize = static_cast<uint32_t>(m_outputSize);
+    pending.header.frameId = frameId;
+    pending.header.timestampUs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    pending.header.inputWidth = inputWidth;
+    pending.header.inputHeight = inputHeight;
+    std::strncpy(pending.header.inputRef, inputRef.c_str(), sizeof(pending.header.inputRef) - 1);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(pending);
+        if (--m_copying == 0) {
+            m_copyDone.notify_all();
+        }
+    }
+    m_cv.notify_one();
+    return true;
+}
+
+void TensorRecorder::writerLoop()
+{
+    while (true) {
+        Pending pending;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stopping || !m_pending.empty(); });
+            if (m_pending.empty()) {
+                return;  // m_stopping 且队列已排空
+            }
+            pending = m_pending.front();
+            m_pending.pop_front();
+        }
+
+        if (m_writer.append(pending.header, m_slots[pending.slot].data())) {
+            m_recorded++;
+        }
+        else {
+            m_dropped++;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_freeSlots.push_back(pending.slot);
+        }
+    }
+}
@@ -0,0 +1,559 @@
+#include "V4l2Capture.h"
+#include <QDebug>
+#include <QStringList>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <linux/videodev2.h>
+#endif
+
+// ============================================================================
+// V4l2CaptureOptions
+// ============================================================================
+
+bool V4l2CaptureOptions::parse(const QString& source, V4l2CaptureOptions& options, QString* error)
+{
+    auto fail = [&](const QString& message) {
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+    if (!isV4l2Source(source)) {
+        return fail("不是 v4l2: 源");
+    }
+
+    QStringList tokens = source.mid(5).split(',', Qt::SkipEmptyParts);
+    if (tokens.isEmpty()) {
+        return fail("缺少设备路径");
+    }
+    V4l2CaptureOptions parsed;
+    parsed.device = tokens.takeFirst().trimmed().toStdString();
+    for (const QString& rawToken : tokens) {
+        QString token = rawToken.trimmed();
+        bool ok = true;
+        if (token == "dmabuf") {
+            parsed.exportDmabuf = true;
+        }
+        else if (token.startsWith("fmt=")) {
+            parsed.pixelFormat = token.mid(4).toStdString();
+            ok = parsed.pixelFormat.size() == 4;
+        }
+        else if (token.startsWith("buffers=")) {
+            parsed.bufferCount = token.mid(8).toInt(&ok);
+        }
+        else if (token.contains('x')) {
+            QStringList parts = token.split('x');
+            bool okHeight = false;
+            ok = parts.size() == 2;
+            if (ok) {
+                parsed.width = parts[0].toInt(&ok);
+                parsed.height = parts[1].toInt(&okHeight);
+                ok = ok && okHeight;
+            }
+        }
+        else {
+            ok = false;
+        }
+        if (!ok) {
+            return fail(QString("无法解析参数: %1").arg(rawToken));
+        }
+    }
+    options = parsed;
+    return true;
+}
+
+QString V4l2CaptureOptions::toString() const
+{
+    return QString("v4l2:%1,%2x%3,fmt=%4")
+        .arg(QString::fromStdString(device)).arg(width).arg(height).arg(QString::fromStdString(pixelFormat));
+}
+
+// ============================================================================
+// 零拷贝帧的引用计数（与 CameraFramePool 相同：UMatData 挂外部缓冲，refcount 归零时归还驱动）
+// ============================================================================
+
+struct V4l2Capture::BufferRef
+{
+    std::shared_ptr<V4l2Capture> capture;
+    int index;
+};
+
+class V4l2Capture::BufferAllocator : public cv::MatAllocator
+{
+public:
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override
+    {
+        return cv::Mat::getStdAllocator()->allocate(data, accessFlags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* u) const override
+    {
+        if (!u) {
+            return;
+        }
+        auto* ref = static_cast<BufferRef*>(u->userdata);
+        if (ref) {
+            ref->capture->requeue(ref->index);
+            delete ref;
+        }
+        delete u;
+    }
+};
+
+const V4l2Capture::BufferAllocator& V4l2Capture::allocator()
+{
+    static BufferAllocator instance;
+    return instance;
+}
+
+std::shared_ptr<V4l2Capture> V4l2Capture::create(const V4l2CaptureOptions& options)
+{
+    return std::shared_ptr<V4l2Capture>(new V4l2Capture(options));
+}
+
+V4l2Capture::V4l2Capture(const V4l2CaptureOptions& options)
+    : m_options(options)
+    , m_fd(-1)
+    , m_fourcc(0)
+    , m_width(0)
+    , m_height(0)
+    , m_bytesPerLine(0)
+    , m_streaming(false)
+    , m_outstanding(0)
+    , m_captured(0)
+    , m_zeroCopy(0)
+    , m_converted(0)
+    , m_timeouts(0)
+{
+    if (m_options.bufferCount <= 0) {
+        m_options.bufferCount = kDriverBuffers + kDefaultPipelineDepth;
+    }
+}
+
+V4l2CaptureStats V4l2Capture::stats() const
+{
+    V4l2CaptureStats stats;
+    stats.captured = m_captured;
+    stats.zeroCopy = m_zeroCopy;
+    stats.converted = m_converted;
+    stats.timeouts = m_timeouts;
+    stats.outstanding = m_outstanding;
+    stats.bufferCount = (int)m_buffers.size();
+    return stats;
+}
+
+bool V4l2Capture::isBufferFrame(const cv::Mat& frame)
+{
+    return frame.u && frame.u->currAllocator == &allocator();
+}
+
+int V4l2Capture::dmabufFd(const cv::Mat& frame)
+{
+    if (!isBufferFrame(frame)) {
+        return -1;
+    }
+    auto* ref = static_cast<BufferRef*>(frame.u->userdata);
+    return ref ? ref->capture->m_buffers[ref->index].dmabufFd : -1;
+}
+
+#ifdef __linux__
+
+namespace {
+
+int xioctl(int fd, unsigned long request, void* arg)
+{
+    int r;
+    do {
+        r = ioctl(fd, request, arg);
+    } while (r == -1 && errno == EINTR);
+    return r;
+}
+
+QString fourccName(uint32_t fourcc)
+{
+    char name[5] = { (char)(fourcc & 0xff), (char)((fourcc >> 8) & 0xff), (char)((fourcc >> 16) & 0xff),
+                     (char)((fourcc >> 24) & 0xff), 0 };
+    return QString::fromLatin1(name);
+}
+
+} // namespace
+
+V4l2Capture::~V4l2Capture()
+{
+    // 走到这里说明已没有帧引用 mmap 缓冲
+    close();
+    releaseDevice();
+}
+
+void V4l2Capture::releaseDevice()
+{
+    if (m_fd < 0) {
+        return;
+    }
+    unmapBuffers();
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+bool V4l2Capture::open(QString* error)
+{
+    auto fail = [&](const QString& message) {
+        qCritical() << "[V4L2]" << message;
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+    if (m_fd >= 0) {
+        return fail("设备已打开");
+    }
+
+    m_fd = ::open(m_options.device.c_str(), O_RDWR | O_NONBLOCK);
+    if (m_fd < 0) {
+        return fail(QString("无法打开设备 %1: %2").arg(QString::fromStdString(m_options.device)).arg(strerror(errno)));
+    }
+
+    // 打开设备之后的失败：解除已建立的映射、释放驱动缓冲并关闭 fd，之后可以重新 open()
+    auto abort = [&](const QString& message) {
+        if (!message.isEmpty()) {
+            fail(message);
+        }
+        releaseDevice();
+        return false;
+    };
+
+    struct v4l2_capability caps = {};
+    if (xioctl(m_fd, VIDIOC_QUERYCAP, &caps) == -1) {
+        return abort(QString("VIDIOC_QUERYCAP 失败: %1").arg(strerror(errno)));
+    }
+    uint32_t capabilities = (caps.capabilities & V4L2_CAP_DEVICE_CAPS) ? caps.device_caps : caps.capabilities;
+    if (!(capabilities & V4L2_CAP_VIDEO_CAPTURE) || !(capabilities & V4L2_CAP_STREAMING)) {
+        return abort(QString("%1 不支持单平面视频采集或流式 I/O").arg(QString::fromStdString(m_options.device)));
+    }
+    qDebug() << "[V4L2] 驱动:" << (const char*)caps.driver << ", 设备:" << (const char*)caps.card;
+
+    // configure/mapBuffers 失败时已经输出了原因
+    if (!configure(error) || !mapBuffers(error)) {
+        return abort(QString());
+    }
+
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(m_fd, VIDIOC_STREAMON, &type) == -1) {
+        return abort(QString("VIDIOC_STREAMON 失败: %1").arg(strerror(errno)));
+    }
+    m_streaming = true;
+    qInfo() << "[V4L2] 开始采集:" << m_width << "x" << m_height << fourccName(m_fourcc)
+            << ", 缓冲" << m_buffers.size() << (m_options.exportDmabuf ? ", dmabuf 已导出" : "");
+    return true;
+}
+
+bool V4l2Capture::configure(QString* error)
+{
+    auto fail = [&](const QString& message) {
+        qCritical() << "[V4L2]" << message;
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+    const std::string& name = m_options.pixelFormat;
+    if (name.size() != 4) {
+        return fail(QString("像素格式应为 4 字符 fourcc: %1").arg(QString::fromStdString(name)));
+    }
+
+    struct v4l2_format fmt = {};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = m_options.width;
+    fmt.fmt.pix.height = m_options.height;
+    fmt.fmt.pix.pixelformat = v4l2_fourcc(name[0], name[1], name[2], name[3]);
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (xioctl(m_fd, VIDIOC_S_FMT, &fmt) == -1) {
+        return fail(QString("VIDIOC_S_FMT 失败: %1").arg(strerror(errno)));
+    }
+
+    // 驱动可能调整分辨率或格式，以实际生效的值为准
+    m_fourcc = fmt.fmt.pix.pixelformat;
+    m_width = (int)fmt.fmt.pix.width;
+    m_height = (int)fmt.fmt.pix.height;
+    m_bytesPerLine = (int)fmt.fmt.pix.bytesperline;
+    if (m_width != m_options.width || m_height != m_options.height || fourccName(m_fourcc) != QString::fromStdString(name)) {
+        qWarning() << "[V4L2] 驱动调整了采集格式:" << m_width << "x" << m_height << fourccName(m_fourcc);
+    }
+    switch (m_fourcc) {
+    case V4L2_PIX_FMT_BGR24:
+    case V4L2_PIX_FMT_GREY:
+    case V4L2_PIX_FMT_RGB24:
+    case V4L2_PIX_FMT_YUYV:
+    case V4L2_PIX_FMT_UYVY:
+    case V4L2_PIX_FMT_NV12:
+        return true;
+    default:
+        return fail(QString("不支持的像素格式: %1").arg(fourccName(m_fourcc)));
+    }
+}
+
+bool V4l2Capture::mapBuffers(QString* error)
+{
+    auto fail = [&](const QString& message) {
+        qCritical() << "[V4L2]" << message;
+        if (error) {
+            *error = message;
+        }
+        return false;
+    };
+
+    struct v4l2_requestbuffers req = {};
+    req.count = m_options.bufferCount;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(m_fd, VIDIOC_REQBUFS, &req) == -1) {
+        return fail(QString("VIDIOC_REQBUFS 失败: %1").arg(strerror(errno)));
+    }
+    if ((int)req.count < m_options.bufferCount) {
+        qWarning() << "[V4L2] 驱动只分配了" << req.count << "个缓冲（请求" << m_options.bufferCount << "）";
+    }
+    if (req.count < 2) {
+        return fail("驱动分配的缓冲不足");
+    }
+
+    m_buffers.resize(req.count);
+    for (unsigned int i = 0; i < req.count; i++) {
+        struct v4l2_buffer buf = {};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = i;
+        if (xioctl(m_fd, VIDIOC_QUERYBUF, &buf) == -1) {
+            return fail(QString("VIDIOC_QUERYBUF %1 失败: %2").arg(i).arg(strerror(errno)));
+        }
+        void* data = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, buf.m.offset);
+        if (data == MAP_FAILED) {
+            return fail(QString("mmap 缓冲 %1 失败: %2").arg(i).arg(strerror(errno)));
+        }
+        m_buffers[i].data = data;
+        m_buffers[i].length = buf.length;
+
+        if (m_options.exportDmabuf) {
+            struct v4l2_exportbuffer expbuf = {};
+            expbuf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            expbuf.index = i;
+            expbuf.flags = O_RDONLY | O_CLOEXEC;
+            if (xioctl(m_fd, VIDIOC_EXPBUF, &expbuf) == -1) {
+                // 导出失败不影响采集，只是该缓冲没有 dmabuf fd
+                qWarning() << "[V4L2] VIDIOC_EXPBUF" << i << "失败:" << strerror(errno);
+            }
+            else {
+                m_buffers[i].dmabufFd = expbuf.fd;
+            }
+        }
+
+        if (xioctl(m_fd, VIDIOC_QBUF, &buf) == -1) {
+            return fail(QString("VIDIOC_QBUF %1 失败: %2").arg(i).arg(strerror(errno)));
+        }
+    }
+    return true;
+}
+
+void V4l2Capture::unmapBuffers()
+{
+    for (Buffer& buffer : m_buffers) {
+        if (buffer.dmabufFd >= 0) {
+            ::close(buffer.dmabufFd);
+        }
+        if (buffer.data) {
+            munmap(buffer.data, buffer.length);
+        }
+    }
+    m_buffers.clear();
+    if (m_fd >= 0) {
+        struct v4l2_requestbuffers req = {};
+        req.count = 0;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = V4L2_MEMORY_MMAP;
+        xioctl(m_fd, VIDIOC_REQBUFS, &req);
+    }
+}
+
+void V4l2Capture::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_streaming) {
+        return;
+    }
+    // STREAMOFF 把驱动队列中的缓冲全部出队；仍被持有的帧释放时不再 QBUF
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    xioctl(m_fd, VIDIOC_STREAMOFF, &type);
+    m_streaming = false;
+    int remaining = m_outstanding.load();
+    if (remaining > 0) {
+        // 最后一帧在 requeue() 中归还时释放设备
+        qWarning() << "[V4L2] 停止采集时仍有" << remaining << "帧未归还（释放后解除映射并关闭设备）";
+        return;
+    }
+    releaseDevice();
+}
+
+cv::Mat V4l2Capture::grab()
+{
+    if (!m_streaming) {
+        return cv::Mat();
+    }
+
+    struct pollfd pfd = {};
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    int ready = poll(&pfd, 1, m_options.timeoutMs);
+    if (ready == 0) {
+        m_timeouts++;
+        return cv::Mat();
+    }
+    if (ready < 0) {
+        if (errno != EINTR) {
+            qWarning() << "[V4L2] poll 失败:" << strerror(errno);
+        }
+        return cv::Mat();
+    }
+
+    struct v4l2_buffer buf = {};
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(m_fd, VIDIOC_DQBUF, &buf) == -1) {
+        if (errno != EAGAIN) {
+            qWarning() << "[V4L2] VIDIOC_DQBUF 失败:" << strerror(errno);
+        }
+        return cv::Mat();
+    }
+    m_outstanding++;
+    if (buf.flags & V4L2_BUF_FLAG_ERROR) {
+        requeue((int)buf.index);
+        return cv::Mat();
+    }
+    m_captured++;
+    return wrap((int)buf.index, buf.bytesused);
+}
+
+cv::Mat V4l2Capture::wrap(int index, size_t bytesUsed)
+{
+    void* data = m_buffers[index].data;
+    const size_t step = m_bytesPerLine > 0 ? (size_t)m_bytesPerLine : cv::Mat::AUTO_STEP;
+
+    if (m_fourcc == V4L2_PIX_FMT_BGR24 || m_fourcc == V4L2_PIX_FMT_GREY) {
+        int type = m_fourcc == V4L2_PIX_FMT_GREY ? CV_8UC1 : CV_8UC3;
+        cv::Mat image(m_height, m_width, type, data, step);
+        auto* ref = new BufferRef{ shared_from_this(), index };
+        auto* u = new cv::UMatData(&allocator());
+        u->data = u->origdata = (uchar*)data;
+        u->size = std::max(bytesUsed, image.step[0] * (size_t)m_height);
+        u->refcount = 1;
+        u->userdata = ref;
+        image.u = u;
+        m_zeroCopy++;
+        return image;
+    }
+
+    // 需要颜色转换的格式：转换到自有内存后立即归还缓冲
+    cv::Mat image;
+    switch (m_fourcc) {
+    case V4L2_PIX_FMT_RGB24:
+        cv::cvtColor(cv::Mat(m_height, m_width, CV_8UC3, data, step), image, cv::COLOR_RGB2BGR);
+        break;
+    case V4L2_PIX_FMT_YUYV:
+        cv::cvtColor(cv::Mat(m_height, m_width, CV_8UC2, data, step), image, cv::COLOR_YUV2BGR_YUYV);
+        break;
+    case V4L2_PIX_FMT_UYVY:
+        cv::cvtColor(cv::Mat(m_height, m_width, CV_8UC2, data, step), image, cv::COLOR_YUV2BGR_UYVY);
+        break;
+    case V4L2_PIX_FMT_NV12:
+        cv::cvtColor(cv::Mat(m_height * 3 / 2, m_width, CV_8UC1, data, step), image, cv::COLOR_YUV2BGR_NV12);
+        break;
+    default:
+        break;
+    }
+    requeue(index);
+    m_converted++;
+    return image;
+}
+
+void V4l2Capture::requeue(int index)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_streaming) {
+        struct v4l2_buffer buf = {};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = V4L2_MEMORY_MMAP;
+        buf.index = index;
+        if (xioctl(m_fd, VIDIOC_QBUF, &buf) == -1) {
+            qWarning() << "[V4L2] VIDIOC_QBUF" << index << "失败:" << strerror(errno);
+        }
+    }
+    // close() 之后最后一帧归还：此时才能解除映射并关闭设备
+    if (--m_outstanding == 0 && !m_streaming) {
+        releaseDevice();
+    }
+}
+
+#else
+
+// 非 Linux 平台没有 V4L2：保留接口，open() 失败
+
+V4l2Capture::~V4l2Capture() = default;
+
+bool V4l2Capture::open(QString* error)
+{
+    qCritical() << "[V4L2] 当前平台不支持 V4L2 采集";
+    if (error) {
+        *error = "当前平台不支持 V4L2 采集";
+    }
+    return false;
+}
+
+void V4l2Capture::close()
+{
+}
+
+cv::Mat V4l2Capture::grab()
+{
+    return cv::Mat();
+}
+
+bool V4l2Capture::configure(QString*)
+{
+    return false;
+}
+
+bool V4l2Capture::mapBuffers(QString*)
+{
+    return false;
+}
+
+void V4l2Capture::unmapBuffers()
+{
+}
+
+void V4l2Capture::releaseDevice()
+{
+}
+
+void V4l2Capture::requeue(int)
+{
+    m_outstanding--;
+}
+
+cv::Mat V4l2Capture::wrap(int, size_t)
+{
+    return cv::Mat();
+}
+
+#endif
@@ -0,0 +1,237 @@
+#include "VideoFileDecoder.h"
+#include <QDebug>
+#include <algorithm>
+
+VideoFileDecoder::VideoFileDecoder(const std::string& path, const VideoDecoderOptions& options)
+    : m_path(path)
+    , m_options(options)
+    , m_loop(options.loop)
+    , m_fps(0)
+    , m_totalFrames(0)
+    , m_stopping(false)
+    , m_endOfFile(false)
+    , m_position(-1)
+    , m_paceStarted(false)
+    , m_decoded(0)
+    , m_delivered(0)
+    , m_skipped(0)
+    , m_starved(0)
+    , m_loops(0)
+    , m_decodeBusySec(0)
+{
+    m_options.queueCapacity = std::max(m_options.queueCapacity, 1);
+}
+
+VideoFileDecoder::~VideoFileDecoder()
+{
+    close();
+}
+
+bool VideoFileDecoder::openCapture(cv::VideoCapture& capture) const
+{
+    // 解码线程数只有 FFmpeg 后端支持，其他后端不带该参数打开
+    std::vector<int> params;
+    if (m_options.decodeThreads >= 0) {
+        params = { cv::CAP_PROP_N_THREADS, m_options.decodeThreads };
+    }
+
+    // 先尝试默认backend
+    if (capture.open(m_path, cv::CAP_ANY, params)) {
+        return true;
+    }
+    qWarning() << "[VideoFileDecoder] 默认backend失败，尝试使用FFMPEG backend...";
+    if (capture.open(m_path, cv::CAP_FFMPEG, params)) {
+        return true;
+    }
+    qWarning() << "[VideoFileDecoder] FFMPEG backend失败，尝试使用MSMF backend...";
+    return capture.open(m_path, cv::CAP_MSMF);
+}
+
+bool VideoFileDecoder::open()
+{
+    close();
+    m_capture = std::make_unique<cv::VideoCapture>();
+    m_standby = std::make_unique<cv::VideoCapture>();
+    if (!openCapture(*m_capture)) {
+        qCritical() << "[VideoFileDecoder] OpenCV版本:" << CV_VERSION;
+        qCritical() << "[VideoFileDecoder] 请确保OpenCV编译时包含了FFMPEG或Media Foundation支持";
+        m_capture.reset();
+        return false;
+    }
+    m_fps = m_capture->get(cv::CAP_PROP_FPS);
+    m_totalFrames = static_cast<int>(m_capture->get(cv::CAP_PROP_FRAME_COUNT));
+    qDebug() << "[VideoFileDecoder] backend:" << QString::fromStdString(m_capture->getBackendName())
+             << ", 队列:" << m_options.queueCapacity << ", 解码线程:" << m_options.decodeThreads
+             << ", 节奏:" << (m_options.pacing == VideoPacing::RealTime ? "realtime" : "unpaced");
+    start(0);
+    return true;
+}
+
+void VideoFileDecoder::close()
+{
+    stop();
+    m_capture.reset();
+    m_standby.reset();
+}
+
+void VideoFileDecoder::start(int frameIndex)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.clear();
+        m_stopping = false;
+        m_endOfFile = false;
+        m_paceStarted = false;
+    }
+    m_thread = std::thread(&VideoFileDecoder::decodeLoop, this, frameIndex);
+}
+
+void VideoFileDecoder::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_notFull.notify_all();
+    m_notEmpty.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void VideoFileDecoder::seek(int frameIndex)
+{
+    if (!isOpened()) {
+        return;
+    }
+    stop();
+    m_capture->set(cv::CAP_PROP_POS_FRAMES, frameIndex);
+    start(frameIndex);
+}
+
+void VideoFileDecoder::decodeLoop(int frameIndex)
+{
+    int index = frameIndex;
+    bool standbyAttempted = false;      // 每轮只尝试预先打开一次，打开失败时到末尾再重试
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_stopping && (int)m_queue.size() >= m_options.queueCapacity) {
+                if (m_loop && !standbyAttempted && !m_standby->isOpened()) {
+                    // 队列已满、解码空闲：为下一轮循环预先打开解码器
+                    standbyAttempted = true;
+                    lock.unlock();
+                    openCapture(*m_standby);
+                    lock.lock();
+                    continue;
+                }
+                m_notFull.wait(lock);
+            }
+            if (m_stopping) {
+                return;
+            }
+        }
+
+        Clock::time_point start = Clock::now();
+        cv::Mat frame;
+        bool ok = m_capture->read(frame) && !frame.empty();
+        if (!ok && m_loop) {
+            // 循环：切换到预先打开的解码器（未预先打开时在此打开），不在当前解码器上 seek
+            if (!m_standby->isOpened() && !openCapture(*m_standby)) {
+                qWarning() << "[VideoFileDecoder] 循环播放时无法重新打开文件";
+            }
+            std::swap(m_capture, m_standby);
+            m_standby->release();
+            standbyAttempted = false;
+            index = 0;
+            ok = m_capture->isOpened() && m_capture->read(frame) && !frame.empty();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_loops++;
+        }
+        double decodeSec = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!ok) {
+            m_endOfFile = true;
+            m_notEmpty.notify_all();
+            return;
+        }
+        m_queue.push_back({ std::move(frame), index++ });
+        m_decoded++;
+        m_decodeBusySec += decodeSec;
+        m_notEmpty.notify_one();
+    }
+}
+
+bool VideoFileDecoder::take(cv::Mat& outFrame, int timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_queue.empty() && !m_endOfFile) {
+        m_starved++;
+        m_notEmpty.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                            [this] { return !m_queue.empty() || m_endOfFile || m_stopping; });
+    }
+    if (m_queue.empty()) {
+        return false;
+    }
+
+    if (m_options.pacing == VideoPacing::RealTime && m_fps > 0) {
+        auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_fps));
+        Clock::time_point now = Clock::now();
+        // 首帧或长时间未取帧（暂停后恢复）时重新对齐时间轴
+        if (!m_paceStarted || now - m_nextDue > std::chrono::seconds(1)) {
+            m_nextDue = now;
+            m_paceStarted = true;
+        }
+        if (now < m_nextDue) {
+            m_notEmpty.wait_until(lock, m_nextDue, [this] { return m_stopping; });
+            if (m_stopping || m_queue.empty()) {
+                return false;
+            }
+            now = Clock::now();
+        }
+        // 取帧方跟不上播放时刻：像实时源一样丢弃已过期的帧
+        while (m_queue.size() > 1 && now >= m_nextDue + interval) {
+            m_queue.pop_front();
+            m_skipped++;
+            m_nextDue += interval;
+        }
+        m_nextDue += interval;
+    }
+
+    Entry entry = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_delivered++;
+    m_position = entry.index;
+    lock.unlock();
+    m_notFull.notify_one();
+
+    outFrame = std::move(entry.image);
+    return true;
+}
+
+bool VideoFileDecoder::finished() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_endOfFile && m_queue.empty();
+}
+
+int VideoFileDecoder::position() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_position;
+}
+
+VideoDecoderStats VideoFileDecoder::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    VideoDecoderStats stats;
+    stats.decoded = m_decoded;
+    stats.delivered = m_delivered;
+    stats.skipped = m_skipped;
+    stats.starved = m_starved;
+    stats.loops = m_loops;
+    stats.queued = (int)m_queue.size();
+    stats.decodeFps = m_decodeBusySec > 0 ? m_decoded / m_decodeBusySec : 0;
+    return stats;
+}
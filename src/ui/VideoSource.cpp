@@ -1,7 +1,9 @@
 #include "VideoSource.h"
+#include "CameraFramePool.h"
 #include "IMVApi.h"
 #include <QDebug>
 #include <QFileInfo>
+#include <thread>
 
 // ============================================================================
 // CameraVideoSource 实现
@@ -10,6 +12,7 @@
 CameraVideoSource::CameraVideoSource(int deviceIndex, QObject* parent)
     : IVideoSource(parent)
     , m_deviceHandle(nullptr)
+    , m_acquisitionMode(CameraAcquisitionMode::Polling)
     , m_deviceIndex(deviceIndex)
     , m_isConnected(false)
     , m_isCapturing(false)
@@ -65,13 +68,35 @@ bool CameraVideoSource::open()
         return false;
     }
     
+    // 相机端 ROI/合并/像素格式只能在停止采集时修改；失败时保持相机当前配置继续
+    if (!m_profileRequest.isEmpty() && !applyCameraProfileRequest((IMV_HANDLE)m_deviceHandle, m_profileRequest)) {
+        qWarning() << "[CameraVideoSource] 相机配置未完全生效，使用相机当前配置";
+    }
+    
+    // SDK 缓冲数量按流水线深度设置（必须在开始采集前）
+    m_framePool = CameraFramePool::create((IMV_HANDLE)m_deviceHandle);
+    m_framePool->configureBufferCount();
+    
+    // 回调模式必须在开始采集前注册（设备关闭后失效）；注册失败时退回轮询
+    if (m_acquisitionMode == CameraAcquisitionMode::Callback) {
+        m_callbackGrabber = std::make_unique<CameraCallbackGrabber>((IMV_HANDLE)m_deviceHandle, m_framePool);
+        if (!m_callbackGrabber->attach()) {
+            qWarning() << "[CameraVideoSource] 回调注册失败，改用轮询取帧";
+            m_callbackGrabber.reset();
+        }
+    }
+    
     // 开始采集
     ret = IMV_StartGrabbing((IMV_HANDLE)m_deviceHandle);
     if (ret != IMV_OK) {
         QString error = QString("启动相机采集失败，错误码: %1").arg(ret);
         qCritical() << error;
-        IMV_Close((IMV_HANDLE)m_deviceHandle);
-        IMV_DestroyHandle((IMV_HANDLE)m_deviceHandle);
+        m_callbackGrabber.reset();
+        if (m_framePool->detach()) {
+            IMV_Close((IMV_HANDLE)m_deviceHandle);
+            IMV_DestroyHandle((IMV_HANDLE)m_deviceHandle);
+        }
+        m_framePool.reset();
         m_deviceHandle = nullptr;
         emit errorOccurred(error);
         return false;
@@ -100,8 +125,14 @@ void CameraVideoSource::close()
         m_isCapturing = false;
     }
     
-    IMV_Close((IMV_HANDLE)m_deviceHandle);
-    IMV_DestroyHandle((IMV_HANDLE)m_deviceHandle);
+    // 等待下游归还 SDK 缓冲中的帧；超时时设备由缓冲池在最后一帧归还后关闭
+    m_callbackGrabber.reset();
+    bool closeNow = !m_framePool || m_framePool->detach();
+    m_framePool.reset();
+    if (closeNow) {
+        IMV_Close((IMV_HANDLE)m_deviceHandle);
+        IMV_DestroyHandle((IMV_HANDLE)m_deviceHandle);
+    }
     
     m_deviceHandle = nullptr;
     m_isConnected = false;
@@ -115,35 +146,20 @@ bool CameraVideoSource::grabFrame(cv::Mat& outFrame)
         return false;
     }
     
+    // 回调模式：帧已在到达时入队，直接取最新帧
+    if (m_callbackGrabber) {
+        return m_callbackGrabber->take(outFrame, 100);
+    }
+    
     IMV_Frame frame;
     int ret = IMV_GetFrame((IMV_HANDLE)m_deviceHandle, &frame, 1000);
     if (ret != IMV_OK) {
         return false;
     }
     
-    // 转换为 RGB 格式
-    if (frame.frameInfo.pixelFormat == gvspPixelMono8) {
-        // 单通道灰度图
-        outFrame = cv::Mat(frame.frameInfo.height, frame.frameInfo.width, CV_8UC1, frame.pData).clone();
-        cv::cvtColor(outFrame, outFrame, cv::COLOR_GRAY2BGR);
-    }
-    else if (frame.frameInfo.pixelFormat == gvspPixelBGR8) {
-        // BGR 格式
-        outFrame = cv::Mat(frame.frameInfo.height, frame.frameInfo.width, CV_8UC3, frame.pData).clone();
-    }
-    else if (frame.frameInfo.pixelFormat == gvspPixelRGB8) {
-        // RGB 格式，需要转换为 BGR
-        cv::Mat rgb(frame.frameInfo.height, frame.frameInfo.width, CV_8UC3, frame.pData);
-        cv::cvtColor(rgb, outFrame, cv::COLOR_RGB2BGR);
-    }
-    else {
-        qWarning() << "[CameraVideoSource] 不支持的像素格式:" << frame.frameInfo.pixelFormat;
-        IMV_ReleaseFrame((IMV_HANDLE)m_deviceHandle, &frame);
-        return false;
-    }
-    
-    IMV_ReleaseFrame((IMV_HANDLE)m_deviceHandle, &frame);
-    return true;
+    // Mono8/BGR8 直接引用 SDK 缓冲，其他格式转换为 BGR；frame 的所有权交给 m_framePool
+    outFrame = m_framePool->wrap(frame);
+    return !outFrame.empty();
 }
 
 QString CameraVideoSource::getSourceName() const
@@ -151,6 +167,18 @@ QString CameraVideoSource::getSourceName() const
     return QString("相机 %1").arg(m_deviceName);
 }
 
+CameraStreamStats CameraVideoSource::getStreamStats() const
+{
+    CameraStreamStats stats;
+    if (m_isCapturing) {
+        queryCameraStreamStats((IMV_HANDLE)m_deviceHandle, stats);
+    }
+    if (m_callbackGrabber) {
+        m_callbackGrabber->fillStats(stats);
+    }
+    return stats;
+}
+
 // ============================================================================
 // VideoFileSource 实现
 // ============================================================================
@@ -158,8 +186,8 @@ QString CameraVideoSource::getSourceName() const
 VideoFileSource::VideoFileSource(const QString& filePath, QObject* parent)
     : IVideoSource(parent)
     , m_filePath(filePath)
-    , m_loop(false)
 {
+    m_decoderOptions.loop = false;
 }
 
 VideoFileSource::~VideoFileSource()
@@ -167,6 +195,16 @@ VideoFileSource::~VideoFileSource()
     close();
 }
 
+void VideoFileSource::setDecoderOptions(const VideoDecoderOptions& options)
+{
+    m_decoderOptions = options;
+}
+
+VideoDecoderStats VideoFileSource::getDecoderStats() const
+{
+    return m_decoder ? m_decoder->stats() : VideoDecoderStats();
+}
+
 bool VideoFileSource::open()
 {
     qDebug() << "[VideoFileSource] 尝试打开视频文件:" << m_filePath;
@@ -179,39 +217,24 @@ bool VideoFileSource::open()
         return false;
     }
     
-    // 尝试使用不同的backend打开视频文件
     std::string filePath = m_filePath.toStdString();
     qDebug() << "[VideoFileSource] 文件大小:" << fileInfo.size() << "bytes";
     qDebug() << "[VideoFileSource] 文件路径(std::string):" << QString::fromStdString(filePath);
     
-    // 先尝试默认backend
-    m_capture.open(filePath);
-    
-    if (!m_capture.isOpened()) {
-        qWarning() << "[VideoFileSource] 默认backend失败，尝试使用FFMPEG backend...";
-        // 尝试明确指定FFMPEG backend
-        m_capture.open(filePath, cv::CAP_FFMPEG);
-    }
-    
-    if (!m_capture.isOpened()) {
-        qWarning() << "[VideoFileSource] FFMPEG backend失败，尝试使用MSMF backend...";
-        // 尝试Windows Media Foundation
-        m_capture.open(filePath, cv::CAP_MSMF);
-    }
-    
-    if (!m_capture.isOpened()) {
+    // 解码器依次尝试默认、FFMPEG、MSMF backend，打开后启动解码线程
+    m_decoder = std::make_unique<VideoFileDecoder>(filePath, m_decoderOptions);
+    if (!m_decoder->open()) {
+        m_decoder.reset();
         QString error = QString("无法打开视频文件: %1 (已尝试所有backend)").arg(m_filePath);
         qCritical() << error;
-        qCritical() << "[VideoFileSource] OpenCV版本:" << CV_VERSION;
-        qCritical() << "[VideoFileSource] 请确保OpenCV编译时包含了FFMPEG或Media Foundation支持";
         emit errorOccurred(error);
         return false;
     }
     
-    QString msg = QString("视频文件已打开: %1 (%2 帧, %.1f FPS)")
+    QString msg = QString("视频文件已打开: %1 (%2 帧, %3 FPS)")
         .arg(fileInfo.fileName())
         .arg(getTotalFrames())
-        .arg(getFPS());
+        .arg(getFPS(), 0, 'f', 1);
     qInfo() << msg;
     emit statusChanged(msg);
     
@@ -220,69 +243,267 @@ bool VideoFileSource::open()
 
 void VideoFileSource::close()
 {
-    if (m_capture.isOpened()) {
+    if (m_decoder) {
         qDebug() << "[VideoFileSource] 关闭视频文件:" << m_filePath;
-        m_capture.release();
+        m_decoder.reset();
         emit statusChanged("视频文件已关闭");
     }
 }
 
 bool VideoFileSource::isOpened() const
 {
-    return m_capture.isOpened();
+    return m_decoder && m_decoder->isOpened();
 }
 
 bool VideoFileSource::grabFrame(cv::Mat& outFrame)
 {
-    if (!m_capture.isOpened()) {
+    if (!m_decoder) {
         return false;
     }
-    
-    bool success = m_capture.read(outFrame);
-    
-    // 如果读取失败且开启了循环播放
-    if (!success && m_loop) {
-        m_capture.set(cv::CAP_PROP_POS_FRAMES, 0);  // 重置到开头
-        success = m_capture.read(outFrame);
-        if (success) {
-            qDebug() << "[VideoFileSource] 视频循环播放，从头开始";
-        }
-    }
-    
-    return success;
+    // 循环播放在解码线程中切换，取帧方看到的是连续的帧序列
+    return m_decoder->take(outFrame, kGrabTimeoutMs);
 }
 
 int VideoFileSource::getTotalFrames() const
 {
-    if (!m_capture.isOpened()) {
-        return 0;
-    }
-    return static_cast<int>(m_capture.get(cv::CAP_PROP_FRAME_COUNT));
+    return m_decoder ? m_decoder->totalFrames() : 0;
 }
 
 int VideoFileSource::getCurrentFramePos() const
 {
-    if (!m_capture.isOpened()) {
-        return 0;
-    }
-    return static_cast<int>(m_capture.get(cv::CAP_PROP_POS_FRAMES));
+    // 预取的帧不计入，返回最近取走的帧之后的位置（与 CAP_PROP_POS_FRAMES 含义一致）
+    return m_decoder ? m_decoder->position() + 1 : 0;
 }
 
 double VideoFileSource::getFPS() const
 {
-    if (!m_capture.isOpened()) {
-        return 0.0;
-    }
-    return m_capture.get(cv::CAP_PROP_FPS);
+    return m_decoder ? m_decoder->fps() : 0.0;
 }
 
 void VideoFileSource::setFramePos(int pos)
 {
-    if (m_capture.isOpened()) {
-        m_capture.set(cv::CAP_PROP_POS_FRAMES, pos);
+    if (m_decoder) {
+        m_decoder->seek(pos);
+    }
+}
+
+void VideoFileSource::setLoop(bool loop)
+{
+    m_decoderOptions.loop = loop;
+    if (m_decoder) {
+        m_decoder->setLoop(loop);
     }
 }
 
+// ============================================================================
+// ImageSequenceSource 实现
+// ============================================================================
+
+ImageSequenceSource::ImageSequenceSource(const QString& path, QObject* parent)
+    : IVideoSource(parent)
+    , m_path(path)
+{
+}
+
+ImageSequenceSource::~ImageSequenceSource()
+{
+    close();
+}
+
+ImageSequenceStats ImageSequenceSource::getSequenceStats() const
+{
+    return m_reader ? m_reader->stats() : ImageSequenceStats();
+}
+
+bool ImageSequenceSource::open()
+{
+    qDebug() << "[ImageSequenceSource] 尝试打开图片序列:" << m_path;
+
+    QStringList files = ImageSequenceReader::listFiles(m_path);
+    if (files.isEmpty()) {
+        QString error = QString("图片序列为空或无法读取: %1").arg(m_path);
+        qCritical() << error;
+        emit errorOccurred(error);
+        return false;
+    }
+
+    m_reader = std::make_unique<ImageSequenceReader>(files, m_options);
+    m_reader->start();
+    m_currentFile.clear();
+
+    QString msg = QString("图片序列已打开: %1 (%2 张)").arg(m_path).arg(files.size());
+    qInfo() << msg;
+    emit statusChanged(msg);
+    return true;
+}
+
+void ImageSequenceSource::close()
+{
+    if (m_reader) {
+        qDebug() << "[ImageSequenceSource] 关闭图片序列:" << m_path;
+        m_reader.reset();
+        emit statusChanged("图片序列已关闭");
+    }
+}
+
+bool ImageSequenceSource::grabFrame(cv::Mat& outFrame)
+{
+    int fileIndex = -1;
+    if (!m_reader || !m_reader->take(outFrame, fileIndex, kGrabTimeoutMs)) {
+        return false;
+    }
+    m_currentFile = m_reader->file(fileIndex);
+    return true;
+}
+
+// ============================================================================
+// SyntheticVideoSource 实现
+// ============================================================================
+
+SyntheticVideoSource::SyntheticVideoSource(const SyntheticSourceConfig& config, QObject* parent)
+    : IVideoSource(parent)
+    , m_config(config)
+    , m_frameNumber(0)
+    , m_delivered(0)
+    , m_dropped(0)
+{
+}
+
+SyntheticVideoSource::~SyntheticVideoSource()
+{
+    close();
+}
+
+SyntheticStreamStats SyntheticVideoSource::getStats() const
+{
+    SyntheticStreamStats stats;
+    stats.delivered = m_delivered;
+    stats.dropped = m_dropped;
+    std::shared_ptr<const SyntheticFramePool> pool = m_pool;
+    if (pool) {
+        stats.poolFrames = pool->size();
+        stats.poolBytes = pool->bytes();
+    }
+    return stats;
+}
+
+bool SyntheticVideoSource::open()
+{
+    // 相同配置的多路共享帧池，首次打开时渲染
+    m_pool = SyntheticFramePool::acquire(m_config);
+    m_frameNumber = 0;
+    m_startTime = Clock::now();
+
+    QString msg = QString("合成视频源已打开: %1").arg(m_config.toString());
+    qInfo() << msg;
+    emit statusChanged(msg);
+    return true;
+}
+
+void SyntheticVideoSource::close()
+{
+    if (m_pool) {
+        qDebug() << "[SyntheticVideoSource] 关闭:" << m_config.toString();
+        m_pool.reset();
+        emit statusChanged("合成视频源已关闭");
+    }
+}
+
+bool SyntheticVideoSource::grabFrame(cv::Mat& outFrame)
+{
+    if (!m_pool) {
+        return false;
+    }
+
+    if (m_config.fps > 0) {
+        // 第 n 帧的曝光时刻为 start + n / fps：未到则等待，已错过整帧则跳过（帧号随时间推进）
+        auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_config.fps));
+        Clock::time_point due = m_startTime + interval * (int64_t)m_frameNumber;
+        Clock::time_point now = Clock::now();
+        if (now < due) {
+            std::this_thread::sleep_until(due);
+        }
+        else {
+            uint64_t behind = (uint64_t)((now - due) / interval);
+            m_frameNumber += behind;
+            m_dropped += behind;
+        }
+    }
+
+    const cv::Mat& frame = m_pool->frame(m_frameNumber++);
+    if (m_config.format == SyntheticPixelFormat::BayerRG8) {
+        // OpenCV 的 Bayer 命名取第二行第二、三列，RGGB 对应 COLOR_BayerBG2BGR
+        cv::cvtColor(frame, outFrame, cv::COLOR_BayerBG2BGR);
+    }
+    else {
+        outFrame = frame;
+    }
+    m_delivered++;
+    return true;
+}
+
+// ============================================================================
+// V4l2VideoSource 实现
+// ============================================================================
+
+V4l2VideoSource::V4l2VideoSource(const V4l2CaptureOptions& options, QObject* parent)
+    : IVideoSource(parent)
+    , m_options(options)
+{
+}
+
+V4l2VideoSource::~V4l2VideoSource()
+{
+    close();
+}
+
+V4l2CaptureStats V4l2VideoSource::getStats() const
+{
+    return m_capture ? m_capture->stats() : V4l2CaptureStats();
+}
+
+bool V4l2VideoSource::open()
+{
+    qDebug() << "[V4l2VideoSource] 尝试打开:" << m_options.toString();
+
+    // 每次打开新建采集对象：上次关闭后仍被持有的帧继续引用旧的映射和 fd，
+    // 驱动缓冲要等这些帧释放后才归还，在此之前新对象的 REQBUFS 返回 EBUSY（见头文件）
+    m_capture = V4l2Capture::create(m_options);
+    QString error;
+    if (!m_capture->open(&error)) {
+        m_capture.reset();
+        emit errorOccurred(error);
+        return false;
+    }
+
+    QString msg = QString("V4L2 设备已打开: %1 (%2x%3)")
+        .arg(QString::fromStdString(m_options.device)).arg(m_capture->width()).arg(m_capture->height());
+    qInfo() << msg;
+    emit statusChanged(msg);
+    return true;
+}
+
+void V4l2VideoSource::close()
+{
+    if (m_capture) {
+        qDebug() << "[V4l2VideoSource] 关闭:" << m_options.toString();
+        m_capture->close();
+        m_capture.reset();
+        emit statusChanged("V4L2 设备已关闭");
+    }
+}
+
+bool V4l2VideoSource::grabFrame(cv::Mat& outFrame)
+{
+    if (!m_capture) {
+        return false;
+    }
+    // 先释放上一帧，避免调用方复用同一个 Mat 时多占一个缓冲
+    outFrame.release();
+    outFrame = m_capture->grab();
+    return !outFrame.empty();
+}
+
 // ============================================================================
 // VideoSourceManager 实现
 // ============================================================================
@@ -309,6 +530,17 @@ bool VideoSourceManager::setSource(VideoSourceType type, const QString& param)
     else if (type == VideoSourceType::VideoFile) {
         return openVideoFile(param);
     }
+    else if (type == VideoSourceType::ImageSequence) {
+        return openImageSequence(param);
+    }
+    else if (type == VideoSourceType::Synthetic) {
+        SyntheticSourceConfig config;
+        return SyntheticSourceConfig::parse(param, config) && openSynthetic(config);
+    }
+    else if (type == VideoSourceType::V4l2) {
+        V4l2CaptureOptions options;
+        return V4l2CaptureOptions::parse(param, options) && openV4l2(options);
+    }
     
     return false;
 }
@@ -321,13 +553,15 @@ VideoSourceType VideoSourceManager::getCurrentType() const
     return m_currentSource->getType();
 }
 
-bool VideoSourceManager::openCamera(int deviceIndex)
+bool VideoSourceManager::openCamera(int deviceIndex, CameraAcquisitionMode mode, const CameraProfileRequest& profileRequest)
 {
     closeSource();
     
     qDebug() << "[VideoSourceManager] 切换到相机源，设备索引:" << deviceIndex;
     
     auto* cameraSource = new CameraVideoSource(deviceIndex, this);
+    cameraSource->setAcquisitionMode(mode);
+    cameraSource->setProfileRequest(profileRequest);
     
     // 连接信号
     connect(cameraSource, &IVideoSource::statusChanged, this, &VideoSourceManager::statusChanged);
@@ -344,13 +578,14 @@ bool VideoSourceManager::openCamera(int deviceIndex)
     return true;
 }
 
-bool VideoSourceManager::openVideoFile(const QString& filePath)
+bool VideoSourceManager::openVideoFile(const QString& filePath, const VideoDecoderOptions& decoderOptions)
 {
     closeSource();
     
     qDebug() << "[VideoSourceManager] 切换到视频文件源:" << filePath;
     
     auto* fileSource = new VideoFileSource(filePath, this);
+    fileSource->setDecoderOptions(decoderOptions);
     
     // 连接信号
     connect(fileSource, &IVideoSource::statusChanged, this, &VideoSourceManager::statusChanged);
@@ -370,6 +605,73 @@ bool VideoSourceManager::openVideoFile(const QString& filePath)
     return true;
 }
 
+bool VideoSourceManager::openImageSequence(const QString& path, const ImageSequenceOptions& options)
+{
+    closeSource();
+
+    qDebug() << "[VideoSourceManager] 切换到图片序列源:" << path;
+
+    auto* sequenceSource = new ImageSequenceSource(path, this);
+    sequenceSource->setSequenceOptions(options);
+
+    connect(sequenceSource, &IVideoSource::statusChanged, this, &VideoSourceManager::statusChanged);
+    connect(sequenceSource, &IVideoSource::errorOccurred, this, &VideoSourceManager::errorOccurred);
+
+    if (!sequenceSource->open()) {
+        delete sequenceSource;
+        return false;
+    }
+
+    m_currentSource = sequenceSource;
+    emit sourceChanged(VideoSourceType::ImageSequence, sequenceSource->getSourceName());
+
+    return true;
+}
+
+bool VideoSourceManager::openSynthetic(const SyntheticSourceConfig& config)
+{
+    closeSource();
+
+    qDebug() << "[VideoSourceManager] 切换到合成视频源:" << config.toString();
+
+    auto* syntheticSource = new SyntheticVideoSource(config, this);
+
+    connect(syntheticSource, &IVideoSource::statusChanged, this, &VideoSourceManager::statusChanged);
+    connect(syntheticSource, &IVideoSource::errorOccurred, this, &VideoSourceManager::errorOccurred);
+
+    if (!syntheticSource->open()) {
+        delete syntheticSource;
+        return false;
+    }
+
+    m_currentSource = syntheticSource;
+    emit sourceChanged(VideoSourceType::Synthetic, syntheticSource->getSourceName());
+
+    return true;
+}
+
+bool VideoSourceManager::openV4l2(const V4l2CaptureOptions& options)
+{
+    closeSource();
+
+    qDebug() << "[VideoSourceManager] 切换到 V4L2 源:" << options.toString();
+
+    auto* v4l2Source = new V4l2VideoSource(options, this);
+
+    connect(v4l2Source, &IVideoSource::statusChanged, this, &VideoSourceManager::statusChanged);
+    connect(v4l2Source, &IVideoSource::errorOccurred, this, &VideoSourceManager::errorOccurred);
+
+    if (!v4l2Source->open()) {
+        delete v4l2Source;
+        return false;
+    }
+
+    m_currentSource = v4l2Source;
+    emit sourceChanged(VideoSourceType::V4l2, v4l2Source->getSourceName());
+
+    return true;
+}
+
 void VideoSourceManager::closeSource()
 {
     if (m_currentSource) {
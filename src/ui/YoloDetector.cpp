@@ -58,21 +58,104 @@ YoloDetector::YoloDetector(QObject* parent)
     , m_initialized(false)
     , m_currentOriginalWidth(0)
     , m_currentOriginalHeight(0)
+    , m_warmupRuns(kAsyncSlots + 1)
+    , m_modelLoadState(ModelLoadState::Idle)
+    , m_recorder(std::make_unique<TensorRecorder>())
+    , m_frameCounter(0)
+    , m_latestResultFrameId(0)
+    , m_inFlight(0)
+    , m_completedCount(0)
+    , m_latencySumUs(0)
 {
     qDebug() << "[YOLO] YoloDetector 已创建";
 }
 
 YoloDetector::~YoloDetector()
 {
-    QMutexLocker locker(&m_mutex);
-    m_inferenceEngine.reset();
-    m_yolo.reset();
+    if (m_loaderThread.joinable()) {
+        m_loaderThread.join();
+    }
+    std::unique_ptr<ModelState> model;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_initialized = false;
+        model = std::move(m_model);
+    }
+    if (model) {
+        retireModel(std::move(model));
+    }
+    // 超时仍未完成的模型不再等待：后端回调可能还会写入其槽位，只能泄漏
+    std::vector<std::unique_ptr<ModelState>> retired;
+    {
+        QMutexLocker locker(&m_mutex);
+        retired.swap(m_retiredModels);
+    }
+    for (auto& previous : retired) {
+        if (drainModel(*previous)) {
+            previous.reset();
+        }
+        else {
+            qWarning() << "[YOLO] 旧模型仍有在途帧，不释放（泄漏）";
+            previous.release();
+        }
+    }
+    m_recorder->stop();  // 后端停止后再关闭录制文件（写入索引）
 }
 
 bool YoloDetector::initializeModel(const QString& modelPath, int parameterIndex)
 {
-    QMutexLocker locker(&m_mutex);
+    std::unique_ptr<ModelState> model = loadModel(modelPath, parameterIndex);
+    if (!model) {
+        return false;
+    }
+    activateModel(std::move(model));
+    qInfo() << "[YOLO] 模型路径:" << modelPath;
+    return true;
+}
+
+bool YoloDetector::loadModelAsync(const QString& modelPath, int parameterIndex)
+{
+    {
+        QMutexLocker locker(&m_loadMutex);
+        if (m_modelLoadState == ModelLoadState::Loading) {
+            qWarning() << "[YOLO] 已有模型正在后台加载，忽略:" << modelPath;
+            return false;
+        }
+        m_modelLoadState = ModelLoadState::Loading;
+    }
+    // 上一次的加载线程已经结束（状态不是 Loading），join 不会阻塞
+    if (m_loaderThread.joinable()) {
+        m_loaderThread.join();
+    }
+
+    qInfo() << "[YOLO] 后台加载模型:" << modelPath << ", 参数索引:" << parameterIndex;
+    m_loaderThread = std::thread([this, modelPath, parameterIndex]() {
+        Clock::time_point start = Clock::now();
+        std::unique_ptr<ModelState> model = loadModel(modelPath, parameterIndex);
+        bool ok = model != nullptr;
+        if (ok) {
+            activateModel(std::move(model));
+            qInfo() << "[YOLO] 后台加载完成:" << modelPath << ", 耗时"
+                    << QString::number(std::chrono::duration<double, std::milli>(Clock::now() - start).count(), 'f', 0) << "ms";
+        }
+        QMutexLocker locker(&m_loadMutex);
+        m_modelLoadState = ok ? ModelLoadState::Succeeded : ModelLoadState::Failed;
+    });
+    return true;
+}
+
+YoloDetector::ModelLoadState YoloDetector::takeModelLoadResult()
+{
+    QMutexLocker locker(&m_loadMutex);
+    ModelLoadState state = m_modelLoadState;
+    if (state == ModelLoadState::Succeeded || state == ModelLoadState::Failed) {
+        m_modelLoadState = ModelLoadState::Idle;
+    }
+    return state;
+}
 
+std::unique_ptr<YoloDetector::ModelState> YoloDetector::loadModel(const QString& modelPath, int parameterIndex)
+{
     try {
         qDebug() << "[YOLO] 开始初始化模型:" << modelPath;
         qDebug() << "[YOLO] 参数索引:" << parameterIndex;
@@ -80,26 +163,12 @@ bool YoloDetector::initializeModel(const QString& modelPath, int parameterIndex)
         // 调试：打印 extern 变量的值
         debugYoloParams();
         
-        // 验证参数索引
-        if (parameterIndex < 0 || parameterIndex >= g_yoloParamsCount) {
-            QString error = QString("Invalid parameter index: %1. Valid range: 0-%2")
-                .arg(parameterIndex)
-                .arg(g_yoloParamsCount - 1);
-            qWarning() << "[YOLO ERROR]" << error;
-            emit errorOccurred(error);
-            return false;
+        // 验证参数索引并获取配置
+        YoloParam config;
+        if (!loadConfig(parameterIndex, config)) {
+            return nullptr;
         }
 
-        // 获取配置（通过指针引用）
-        m_config = *g_yoloParamsPtr[parameterIndex];
-        qDebug() << "[YOLO] 从 g_yoloParamsPtr[" << parameterIndex << "] 复制配置";
-        qDebug() << "[YOLO] g_yoloParamsPtr[" << parameterIndex << "]->width =" << g_yoloParamsPtr[parameterIndex]->width;
-        qDebug() << "[YOLO] g_yoloParamsPtr[" << parameterIndex << "]->height =" << g_yoloParamsPtr[parameterIndex]->height;
-        qDebug() << "[YOLO] m_config.width =" << m_config.width;
-        qDebug() << "[YOLO] m_config.height =" << m_config.height;
-        qDebug() << "[YOLO] m_config.numClasses =" << m_config.numClasses;
-        qDebug() << "[YOLO] m_config.numBoxes =" << m_config.numBoxes;
-
         // 尝试不使用 InferenceOption，直接用默认配置
         qDebug() << "[YOLO] 尝试使用默认 InferenceOption...";
 
@@ -113,7 +182,7 @@ bool YoloDetector::initializeModel(const QString& modelPath, int parameterIndex)
             QString error = QString("模型文件不存在: %1").arg(modelPath);
             qCritical() << "[YOLO ERROR]" << error;
             emit errorOccurred(error);
-            return false;
+            return nullptr;
         }
         qDebug() << "[YOLO] 模型文件大小:" << modelFileInfo.size() << "bytes";
         qDebug() << "[YOLO] 模型文件可读:" << modelFileInfo.isReadable();
@@ -140,28 +209,11 @@ bool YoloDetector::initializeModel(const QString& modelPath, int parameterIndex)
         qDebug() << "[YOLO] 传递给 InferenceEngine 的路径:" << QString::fromStdString(modelPathStd);
         qDebug() << "[YOLO] ======================================";
         
+        std::unique_ptr<IInferenceBackend> backend;
         try {
-            qDebug() << "[YOLO] 开始调用 InferenceEngine 构造函数(使用相对路径)...";
-            qDebug() << "[YOLO] 尝试使用 new 而非 make_unique...";
-            
-            // 尝试使用普通 new 代替 make_unique
-            dxrt::InferenceEngine* engine = nullptr;
-            try {
-                qDebug() << "[YOLO] 创建 InferenceEngine 对象...";
-                engine = new dxrt::InferenceEngine(modelPathStd);
-                qDebug() << "[YOLO] ✓ InferenceEngine 对象创建成功";
-                
-                // 包装到 unique_ptr
-                m_inferenceEngine.reset(engine);
-                qDebug() << "[YOLO] ✓ 推理引擎已设置到 unique_ptr";
-            }
-            catch (...) {
-                qCritical() << "[YOLO] InferenceEngine 构造函数抛出异常";
-                if (engine) {
-                    delete engine;
-                }
-                throw;
-            }
+            qDebug() << "[YOLO] 开始创建 DXRT 推理后端(使用相对路径)...";
+            backend = std::make_unique<DxrtInferenceBackend>(modelPathStd);
+            qDebug() << "[YOLO] ✓ DXRT 推理后端创建成功";
         }
         catch (const dxrt::Exception& e) {
             QString errorMsg = QString("推理引擎创建失败 [dxrt::Exception]: %1 (错误码: %2)")
@@ -172,27 +224,21 @@ bool YoloDetector::initializeModel(const QString& modelPath, int parameterIndex)
             qCritical() << "[YOLO] 错误代码:" << e.code();
             
             emit errorOccurred(errorMsg);
-            m_inferenceEngine.reset();
-            m_yolo.reset();
-            return false;
+            return nullptr;
         }
         catch (const std::exception& e) {
             QString errorMsg = QString("推理引擎创建失败 [std::exception]: %1").arg(e.what());
             qCritical() << "[YOLO EXCEPTION]" << errorMsg;
             qCritical() << "[YOLO] 异常类型:" << typeid(e).name();
             emit errorOccurred(errorMsg);
-            m_inferenceEngine.reset();
-            m_yolo.reset();
-            return false;
+            return nullptr;
         }
         catch (...) {
             QString errorMsg = "推理引擎创建失败: 未知异常类型";
             qCritical() << "[YOLO EXCEPTION]" << errorMsg;
             qCritical() << "[YOLO] 可能原因: 1)DXRT运行时环境问题 2)模型文件损坏 3)设备驱动问题";
             emit errorOccurred(errorMsg);
-            m_inferenceEngine.reset();
-            m_yolo.reset();
-            return false;
+            return nullptr;
         }
 
         // 暂时跳过版本检查
@@ -203,110 +249,344 @@ bool YoloDetector::initializeModel(const QString& modelPath, int parameterIndex)
         //     return false;
         // }
 
-        // 创建 YOLO 处理器
-        qDebug() << "[YOLO] 正在创建 YOLO 处理器...";
-        m_yolo = std::make_unique<Yolo>(m_config);
-        qDebug() << "[YOLO] YOLO 处理器创建成功";
-        
-        // 重新排序层
-        qDebug() << "[YOLO] 正在重排序层...";
-        
-        // 打印所有输出张量信息以便调试
-        auto outputs = m_inferenceEngine->GetOutputs();
-        qDebug() << "[YOLO] 模型输出张量数量:" << outputs.size();
-        for (size_t i = 0; i < outputs.size(); i++) {
-            QString shapeStr = "[";
-            for (size_t j = 0; j < outputs[i].shape().size(); j++) {
-                shapeStr += QString::number(outputs[i].shape()[j]);
-                if (j < outputs[i].shape().size() - 1) shapeStr += ",";
-            }
-            shapeStr += "]";
-            qDebug() << "[YOLO] 输出张量[" << i << "]: name =" << outputs[i].name().c_str() 
-                     << ", shape =" << shapeStr;
-        }
-        qDebug() << "[YOLO] 配置的 onnxOutputName =" << m_config.onnxOutputName.c_str();
-        
-        if (!m_yolo->LayerReorder(outputs)) {
-            QString error = "YOLO层重排序失败";
-            qWarning() << "[YOLO ERROR]" << error;
-            emit errorOccurred(error);
-            return false;
-        }
-        qDebug() << "[YOLO] 层重排序成功";
-
-        // 分配输出缓冲区
-        qDebug() << "[YOLO] 分配输出缓冲区...";
-        m_outputBuffer.resize(m_inferenceEngine->GetOutputSize());
-        qDebug() << "[YOLO] 输出缓冲区大小:" << m_outputBuffer.size();
-        
-        // 分配预处理图像缓冲区
-        qDebug() << "[YOLO] 分配预处理图像缓冲区...";
-        m_preprocessedImage = cv::Mat(m_config.height, m_config.width, CV_8UC3);
-        qDebug() << "[YOLO] 预处理图像缓冲区分配成功";
-
-        // 注册异步推理回调
-        qDebug() << "[YOLO] 注册异步推理回调...";
-        std::function<int(std::vector<std::shared_ptr<dxrt::Tensor>>, void*)> callback = 
-            [this](std::vector<std::shared_ptr<dxrt::Tensor>> outputs, void* arg) -> int
-            {
-                // 获取输出长度
-                int64_t outputLength = outputs.front()->shape()[0];
-                if (dxapp::common::compareVersions(DXRT_VERSION, "2.6.3")) {
-                    outputLength = outputs.front()->shape()[1];
-                }
-                
-                // 调用后处理
-                this->postProcessFromBuffer((void*)m_outputBuffer.data(), outputLength);
-                return 0;
-            };
-        m_inferenceEngine->RegisterCallBack(callback);
-        qDebug() << "[YOLO] 回调注册成功";
-
-        m_initialized = true;
-        qInfo() << "[YOLO] ========== 模型初始化成功 ==========";
-        qInfo() << "[YOLO] 模型路径:" << modelPath;
-        qInfo() << "[YOLO] 模型尺寸:" << m_config.width << "x" << m_config.height;
-        qInfo() << "[YOLO] 类别数:" << m_config.numClasses;
-        qInfo() << "[YOLO] 使用异步推理模式";
-
-        return true;
+        return buildModel(std::move(backend), config);
     }
     catch (const std::exception& e) {
         QString error = QString("初始化模型失败: %1").arg(e.what());
         qCritical() << "[YOLO EXCEPTION]" << error;
         qCritical() << "[YOLO EXCEPTION] 异常类型: std::exception";
         emit errorOccurred(error);
-        
-        // 清理已分配的资源
-        m_inferenceEngine.reset();
-        m_yolo.reset();
-        m_initialized = false;
-        
-        return false;
+        return nullptr;
     }
     catch (...) {
         QString error = "初始化模型失败: 未知异常";
         qCritical() << "[YOLO EXCEPTION]" << error;
         qCritical() << "[YOLO EXCEPTION] 异常类型: 未知";
         emit errorOccurred(error);
-        
-        // 清理已分配的资源
-        m_inferenceEngine.reset();
-        m_yolo.reset();
-        m_initialized = false;
-        
+        return nullptr;
+    }
+}
+
+bool YoloDetector::initializeWithBackend(std::unique_ptr<IInferenceBackend> backend, int parameterIndex)
+{
+    if (!backend) {
+        emit errorOccurred("推理后端为空");
+        return false;
+    }
+    qDebug() << "[YOLO] 使用外部推理后端初始化:" << QString::fromStdString(backend->name());
+
+    try {
+        YoloParam config;
+        if (!loadConfig(parameterIndex, config)) {
+            return false;
+        }
+        std::unique_ptr<ModelState> model = buildModel(std::move(backend), config);
+        if (!model) {
+            return false;
+        }
+        activateModel(std::move(model));
+        return true;
+    }
+    catch (const std::exception& e) {
+        QString error = QString("初始化模型失败: %1").arg(e.what());
+        qCritical() << "[YOLO EXCEPTION]" << error;
+        emit errorOccurred(error);
         return false;
     }
 }
 
+bool YoloDetector::getParameterConfig(int parameterIndex, YoloParam& config)
+{
+    if (parameterIndex < 0 || parameterIndex >= g_yoloParamsCount) {
+        return false;
+    }
+    config = *g_yoloParamsPtr[parameterIndex];
+    return true;
+}
+
+bool YoloDetector::loadConfig(int parameterIndex, YoloParam& config)
+{
+    if (!getParameterConfig(parameterIndex, config)) {
+        QString error = QString("Invalid parameter index: %1. Valid range: 0-%2")
+            .arg(parameterIndex)
+            .arg(g_yoloParamsCount - 1);
+        qWarning() << "[YOLO ERROR]" << error;
+        emit errorOccurred(error);
+        return false;
+    }
+
+    qDebug() << "[YOLO] 从 g_yoloParamsPtr[" << parameterIndex << "] 复制配置";
+    qDebug() << "[YOLO] config.width =" << config.width;
+    qDebug() << "[YOLO] config.height =" << config.height;
+    qDebug() << "[YOLO] config.numClasses =" << config.numClasses;
+    qDebug() << "[YOLO] config.numBoxes =" << config.numBoxes;
+    return true;
+}
+
+// 不访问当前模型，可在加载线程中执行
+std::unique_ptr<YoloDetector::ModelState> YoloDetector::buildModel(std::unique_ptr<IInferenceBackend> backend,
+                                                                   const YoloParam& config)
+{
+    auto model = std::make_unique<ModelState>();
+    model->backend = std::move(backend);
+    model->config = config;
+
+    // 创建 YOLO 处理器
+    qDebug() << "[YOLO] 正在创建 YOLO 处理器...";
+    model->yolo = std::make_unique<Yolo>(model->config);
+    qDebug() << "[YOLO] YOLO 处理器创建成功";
+    
+    // 重新排序层
+    qDebug() << "[YOLO] 正在重排序层...";
+    
+    // 打印所有输出张量信息以便调试
+    const auto& descs = model->backend->outputDescs();
+    qDebug() << "[YOLO] 模型输出张量数量:" << descs.size();
+    for (size_t i = 0; i < descs.size(); i++) {
+        QString shapeStr = "[";
+        for (size_t j = 0; j < descs[i].shape.size(); j++) {
+            shapeStr += QString::number(descs[i].shape[j]);
+            if (j < descs[i].shape.size() - 1) shapeStr += ",";
+        }
+        shapeStr += "]";
+        qDebug() << "[YOLO] 输出张量[" << i << "]: name =" << descs[i].name.c_str() 
+                 << ", shape =" << shapeStr;
+    }
+    qDebug() << "[YOLO] 配置的 onnxOutputName =" << model->config.onnxOutputName.c_str();
+    
+    if (!model->yolo->LayerReorder(model->backend->outputTensors())) {
+        QString error = "YOLO层重排序失败";
+        qWarning() << "[YOLO ERROR]" << error;
+        emit errorOccurred(error);
+        return nullptr;
+    }
+    qDebug() << "[YOLO] 层重排序成功";
+
+    // 缓存输出 shape 和数据类型（回调中不再每次查询引擎）
+    model->outputShapes = model->backend->outputShapes();
+    model->outputType = model->backend->outputType();
+
+    // 异步推理槽位（属于该模型，切换后旧模型的在途帧仍写入旧槽位）
+    for (int i = 0; i < kAsyncSlots; i++) {
+        auto slot = std::make_unique<AsyncSlot>();
+        slot->model = model.get();
+        slot->input = cv::Mat(model->config.height, model->config.width, CV_8UC3);
+        slot->output.resize(model->backend->outputSize());
+        model->asyncSlots.push_back(std::move(slot));
+    }
+    qDebug() << "[YOLO] 异步推理槽位数:" << kAsyncSlots;
+
+    // 预热使用同步推理，在注册回调之前完成
+    int warmupRuns = 0;
+    cv::Size warmupInputSize;
+    {
+        QMutexLocker locker(&m_mutex);
+        warmupRuns = m_warmupRuns;
+        warmupInputSize = m_warmupInputSize;
+    }
+    warmup(*model, warmupRuns, warmupInputSize);
+
+    // 注册异步推理回调（userArg 为提交时的槽位）
+    qDebug() << "[YOLO] 注册异步推理回调...";
+    model->backend->setCallback(
+        [this](void* output, void* arg)
+        {
+            (void)output;
+            AsyncSlot* slot = static_cast<AsyncSlot*>(arg);
+            if (!slot) {
+                return;
+            }
+            this->postProcessFromBuffer(slot);
+            // 后处理全部结束后才释放槽位：槽位空闲即表示该模型的后处理器和输出 buffer 不再被使用
+            this->releaseSlot(slot);
+            m_inFlight--;
+        });
+    qDebug() << "[YOLO] 回调注册成功";
+
+    return model;
+}
+
+void YoloDetector::activateModel(std::unique_ptr<ModelState> model)
+{
+    std::unique_ptr<ModelState> previous;
+    // 释放 m_mutex 后 m_model 可能被并发的加载再次替换并释放，日志和预留只使用这里复制的值
+    size_t reservedResults = 0;
+    QString backendName;
+    YoloParam config;
+    {
+        // 帧边界：detectAsync 在 m_mutex 下分配槽位，切换之后提交的帧全部进入新模型
+        QMutexLocker locker(&m_mutex);
+        previous = std::move(m_model);
+        m_model = std::move(model);
+        m_config = m_model->config;
+        m_warmupReport = m_model->warmupReport;
+        m_outputBuffer.resize(m_model->backend->outputSize());
+        m_preprocessedImage = cv::Mat(m_config.height, m_config.width, CV_8UC3);
+        m_initialized = true;
+        reservedResults = m_model->reservedResults;
+        backendName = QString::fromStdString(m_model->backend->name());
+        config = m_config;
+    }
+    {
+        QMutexLocker locker(&m_resultMutex);
+        m_latestResults.reserve(reservedResults);
+    }
+
+    qInfo() << "[YOLO] ========== 模型初始化成功 ==========";
+    qInfo() << "[YOLO] 推理后端:" << backendName;
+    qInfo() << "[YOLO] 模型尺寸:" << config.width << "x" << config.height;
+    qInfo() << "[YOLO] 类别数:" << config.numClasses;
+    qInfo() << "[YOLO] 使用异步推理模式";
+
+    // 旧模型的在途帧由旧后端完成并照常输出结果，全部完成后再释放旧引擎
+    if (previous) {
+        retireModel(std::move(previous));
+    }
+}
+
+void YoloDetector::retireModel(std::unique_ptr<ModelState> model)
+{
+    bool drained = drainModel(*model);
+
+    // 输出格式随模型变化，录制文件不能跨模型继续写；旧模型的回调已结束（或超时），再关闭录制文件
+    if (isRecording() && m_recordingModel.load() == model.get()) {
+        qWarning() << "[YOLO] 切换模型，停止输出张量录制";
+        stopRecording();
+    }
+
+    std::vector<std::unique_ptr<ModelState>> released;
+    {
+        QMutexLocker locker(&m_mutex);
+        // 超时的模型暂存，后端回调仍可能写入其槽位、使用其后处理器；下次切换时再尝试释放
+        if (!drained) {
+            m_retiredModels.push_back(std::move(model));
+        }
+        for (auto it = m_retiredModels.begin(); it != m_retiredModels.end();) {
+            if (busySlots(**it) == 0) {
+                released.push_back(std::move(*it));
+                it = m_retiredModels.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        if (!m_retiredModels.empty()) {
+            qWarning() << "[YOLO] 旧模型仍有在途帧，暂不释放, 待释放模型数:" << m_retiredModels.size();
+        }
+    }
+    if (drained) {
+        model.reset();
+        qInfo() << "[YOLO] 旧模型已释放";
+    }
+    if (!released.empty()) {
+        qInfo() << "[YOLO] 释放" << released.size() << "个此前超时的旧模型";
+        released.clear();
+    }
+}
+
+int YoloDetector::busySlots(const ModelState& model) const
+{
+    int busy = 0;
+    for (const auto& slot : model.asyncSlots) {
+        busy += slot->busy ? 1 : 0;
+    }
+    return busy;
+}
+
+bool YoloDetector::drainModel(ModelState& model)
+{
+    Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(kDrainTimeoutMs);
+    for (;;) {
+        int busy = 0;
+        {
+            QMutexLocker locker(&m_mutex);
+            busy = busySlots(model);
+        }
+        if (busy == 0) {
+            return true;
+        }
+        if (Clock::now() > deadline) {
+            qWarning() << "[YOLO] 等待旧模型在途帧超时，仍有" << busy << "帧未完成";
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+void YoloDetector::setWarmup(int runs, const cv::Size& inputSize)
+{
+    QMutexLocker locker(&m_mutex);
+    m_warmupRuns = std::max(runs, 0);
+    m_warmupInputSize = inputSize;
+}
+
+// 模型尚未生效（只有当前线程访问），不需要加锁
+void YoloDetector::warmup(ModelState& model, int warmupRuns, const cv::Size& inputSize)
+{
+    WarmupReport& report = model.warmupReport;
+    report = WarmupReport();
+
+    // 后处理容器按上限预留：候选框按类别分桶，clear() 后容量保留，首帧之后不再扩容
+    size_t reserved = kReservedCandidates;
+    if (model.config.numBoxes > 0) {
+        reserved = std::min(reserved, (size_t)model.config.numBoxes);
+    }
+    model.yolo->ReserveCandidates(reserved, reserved);
+    model.reservedResults = reserved;
+
+    if (warmupRuns <= 0) {
+        return;
+    }
+
+    cv::Size size = inputSize.empty() ? cv::Size(model.config.width, model.config.height) : inputSize;
+    // 随机噪声帧：输出中有一定数量的候选框，后处理的筛选、排序和 NMS 都会执行到
+    cv::Mat dummy(size, CV_8UC3);
+    cv::randu(dummy, cv::Scalar::all(0), cv::Scalar::all(256));
+
+    int runs = std::max(warmupRuns, kAsyncSlots);
+    double warmSumMs = 0;
+    try {
+        for (int i = 0; i < runs; i++) {
+            AsyncSlot* slot = model.asyncSlots[i % kAsyncSlots].get();
+            Clock::time_point start = Clock::now();
+            PreProc(dummy, slot->input, true, true, 114);
+            if (!model.backend->warmupRun(slot->input.data, slot->output.data())) {
+                qWarning() << "[YOLO] 预热推理失败，跳过剩余预热";
+                break;
+            }
+            model.yolo->PostProc(slot->output.data(), model.outputShapes, model.outputType,
+                                 static_cast<int>(slot->output.size() / sizeof(float)));
+            double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (i == 0) {
+                report.coldMs = elapsedMs;
+            }
+            else {
+                warmSumMs += elapsedMs;
+            }
+            report.runs++;
+        }
+    }
+    catch (const std::exception& e) {
+        // 预热失败不影响加载，首帧按冷启动处理
+        qWarning() << "[YOLO] 预热异常:" << e.what();
+    }
+    model.yolo->ClearCandidates();
+
+    if (report.runs > 1) {
+        report.warmMs = warmSumMs / (report.runs - 1);
+    }
+    qInfo() << "[YOLO] 预热完成:" << report.runs << "次, 输入" << size.width << "x" << size.height
+            << ", 首次" << QString::number(report.coldMs, 'f', 1) << "ms"
+            << ", 预热后平均" << QString::number(report.warmMs, 'f', 1) << "ms";
+}
+
 cv::Mat YoloDetector::preprocessImage(const cv::Mat& image)
 {
     cv::Mat processed;
-    cv::Mat imageCopy = image.clone();
     
     // 使用 demo_utils 中的预处理函数
     // PreProc(input, output, letterbox, bgr2rgb, pad_value)
-    PreProc(imageCopy, processed, true, true, 114);
+    PreProc(image, processed, true, true, 114);
     
     return processed;
 }
@@ -328,30 +608,28 @@ std::vector<BoundingBox> YoloDetector::detectSync(const cv::Mat& image)
              << ", channels=" << image.channels() << ", type=" << image.type();
 
     try {
-        // 预处理 - 创建可修改的副本
+        // 预处理（PreProc 不修改输入，直接读取相机帧，无需拷贝）
         qDebug() << "[YOLO DETECT] Step 1: 开始预处理...";
-        cv::Mat imageCopy = image.clone();
-        PreProc(imageCopy, m_preprocessedImage, true, true, 114);
+        PreProc(image, m_preprocessedImage, true, true, 114);
         qDebug() << "[YOLO DETECT] Step 1: 预处理完成 -> " 
                  << m_preprocessedImage.cols << "x" << m_preprocessedImage.rows;
         
         // 同步推理
         qDebug() << "[YOLO DETECT] Step 2: 开始推理...";
-        m_inferenceEngine->Run(
+        if (!m_model->backend->run(
             m_preprocessedImage.data, 
-            nullptr,  // 第二个参数设为 nullptr
             m_outputBuffer.data()  // 输出会写入这个缓冲区
-        );
+        )) {
+            qWarning() << "[YOLO DETECT] 同步推理失败，跳过本帧";
+            return std::vector<BoundingBox>();
+        }
         
-        // 获取输出张量的元数据（shape等信息）
-        m_outputTensors = m_inferenceEngine->GetOutputs();
-        qDebug() << "[YOLO DETECT] Step 2: 推理完成, 输出层数=" << m_outputTensors.size();
+        // 输出张量的元数据（shape等信息）在初始化时已缓存
+        const auto& output_shapes = m_model->outputShapes;
+        qDebug() << "[YOLO DETECT] Step 2: 推理完成, 输出层数=" << output_shapes.size();
         
-        // 准备 output_shape 信息
-        std::vector<std::vector<int64_t>> output_shapes;
-        for (size_t i = 0; i < m_outputTensors.size(); ++i) {
-            auto shape = m_outputTensors[i].shape();
-            output_shapes.push_back(shape);
+        for (size_t i = 0; i < output_shapes.size(); ++i) {
+            const auto& shape = output_shapes[i];
             
             // 手動構建 shape 字符串用於調試
             QString shapeStr = "[";
@@ -365,7 +643,7 @@ std::vector<BoundingBox> YoloDetector::detectSync(const cv::Mat& image)
         
         // 簡單起見，直接傳入空的 data_type（PostProc 內部會根據情況處理）
         // 修復：從推理引擎獲取實際的數據類型（與 dx_app od.cpp 第70行一致）
-        dxrt::DataType dataType = m_inferenceEngine->outputs().front().type();
+        dxrt::DataType dataType = m_model->outputType;
         int outputLength = m_outputBuffer.size() / sizeof(float);
         
         qDebug() << "[YOLO DETECT] 使用 buffer 版本的 PostProc";
@@ -375,7 +653,7 @@ std::vector<BoundingBox> YoloDetector::detectSync(const cv::Mat& image)
 
         // 后处理 - 使用 buffer 版本
         qDebug() << "[YOLO DETECT] Step 3: 开始后处理...";
-        auto results = m_yolo->PostProc(m_outputBuffer.data(), output_shapes, dataType, outputLength);
+        auto results = m_model->yolo->PostProc(m_outputBuffer.data(), output_shapes, dataType, outputLength);
         qDebug() << "[YOLO DETECT] Step 3: 后处理完成, 检测到" << results.size() << "个目标";
         
         // Step 4: 坐標轉換 - 從模型輸入尺寸縮放到原始圖像尺寸
@@ -435,7 +713,7 @@ std::vector<BoundingBox> YoloDetector::detectSync(const cv::Mat& image)
     }
 }
 
-bool YoloDetector::detectAsync(const cv::Mat& image)
+bool YoloDetector::detectAsync(const cv::Mat& image, const QString& inputRef)
 {
     if (!m_initialized) {
         qWarning() << "[YOLO ASYNC] 模型未初始化";
@@ -451,47 +729,63 @@ bool YoloDetector::detectAsync(const cv::Mat& image)
     asyncCallCount++;
     
     bool verboseLog = (asyncCallCount == 1 || asyncCallCount % 30 == 0);
+    Clock::time_point submitTime = Clock::now();
 
-    try {
-        if (verboseLog) {
-            qDebug() << "[YOLO ASYNC] ========== 第" << asyncCallCount << "次异步调用 ==========";
-            qDebug() << "[YOLO ASYNC] 输入图像:" << image.cols << "x" << image.rows;
+    // 取一个空闲槽位，同时记录帧信息（后处理时从槽位取，不受后续提交影响）
+    AsyncSlot* slot = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (auto& candidate : m_model->asyncSlots) {
+            if (!candidate->busy) {
+                slot = candidate.get();
+                break;
+            }
         }
-        
-        // 保存原始图像尺寸（用于后处理时的坐标缩放）
-        {
-            QMutexLocker locker(&m_mutex);
-            m_currentOriginalWidth = image.cols;
-            m_currentOriginalHeight = image.rows;
+        if (!slot) {
             if (verboseLog) {
-                qDebug() << "[YOLO ASYNC] 保存原始尺寸完成";
+                qDebug() << "[YOLO ASYNC] 推理槽位已满（" << kAsyncSlots << "帧在途），跳过本帧";
             }
+            return false;
         }
-        
-        // 预处理
-        if (verboseLog) {
-            qDebug() << "[YOLO ASYNC] 开始预处理...";
-        }
-        cv::Mat imageCopy = image.clone();
-        PreProc(imageCopy, m_preprocessedImage, true, true, 114);
+        slot->busy = true;
+        slot->frameId = ++m_frameCounter;
+        slot->originalWidth = image.cols;
+        slot->originalHeight = image.rows;
+        slot->inputRef = isRecording() ? inputRef.toStdString() : std::string();
+        slot->submitTime = submitTime;
+        m_currentOriginalWidth = image.cols;
+        m_currentOriginalHeight = image.rows;
+    }
+
+    bool counted = false;
+    try {
         if (verboseLog) {
-            qDebug() << "[YOLO ASYNC] 预处理完成:" << m_preprocessedImage.cols << "x" << m_preprocessedImage.rows;
+            qDebug() << "[YOLO ASYNC] ========== 第" << asyncCallCount << "次异步调用 ==========";
+            qDebug() << "[YOLO ASYNC] 输入图像:" << image.cols << "x" << image.rows
+                     << ", 帧号:" << slot->frameId << ", 在途:" << m_inFlight.load();
         }
         
-        // 异步推理 - 参考 od.cpp 第139行
-        // RunAsync 会立即返回，推理完成后自动调用回调
+        // 预处理（写入槽位自己的输入 buffer）
+        PreProc(image, slot->input, true, true, 114);
         if (verboseLog) {
-            qDebug() << "[YOLO ASYNC] 准备调用 RunAsync...";
-            qDebug() << "[YOLO ASYNC]   输入数据地址:" << (void*)m_preprocessedImage.data;
-            qDebug() << "[YOLO ASYNC]   this指针:" << (void*)this;
-            qDebug() << "[YOLO ASYNC]   输出缓冲区地址:" << (void*)m_outputBuffer.data();
+            qDebug() << "[YOLO ASYNC] 预处理完成:" << slot->input.cols << "x" << slot->input.rows;
         }
         
-        m_inferenceEngine->RunAsync(
-            m_preprocessedImage.data,
-            (void*)this,  // 传递 this 指针作为回调参数
-            m_outputBuffer.data()
+        // 异步推理 - 参考 od.cpp 第139行
+        // RunAsync 会立即返回，推理完成后自动调用回调；回调可能在 runAsync 返回前执行，先计入在途
+        m_inFlight++;
+        counted = true;
+        int jobId = slot->model->backend->runAsync(
+            slot->input.data,
+            slot,  // 回调参数：槽位
+            slot->output.data()
         );
+        if (jobId < 0) {
+            qWarning() << "[YOLO ASYNC] 推理后端拒绝提交（队列已满）";
+            m_inFlight--;
+            releaseSlot(slot);
+            return false;
+        }
         
         if (verboseLog) {
             qDebug() << "[YOLO ASYNC] RunAsync 已返回（推理已提交到 NPU）✓";
@@ -502,68 +796,74 @@ bool YoloDetector::detectAsync(const cv::Mat& image)
     catch (const std::exception& e) {
         QString error = QString("异步推理失败: %1").arg(e.what());
         qCritical() << "[YOLO ASYNC ERROR]" << error;
+        if (counted) {
+            m_inFlight--;
+        }
+        releaseSlot(slot);
         emit errorOccurred(error);
         return false;
     }
 }
 
+void YoloDetector::releaseSlot(AsyncSlot* slot)
+{
+    QMutexLocker locker(&m_mutex);
+    slot->busy = false;
+}
+
+void YoloDetector::getAsyncTiming(uint64_t& completed, double& latencySumMs) const
+{
+    completed = m_completedCount.load();
+    latencySumMs = m_latencySumUs.load() / 1000.0;
+}
+
+double YoloDetector::getNpuTimeMs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_model ? m_model->backend->npuTimeUs() / 1000.0 : 0;
+}
+
 // 后处理回调实现（在 NPU 推理完成后由 DXRT 线程调用）
-void YoloDetector::postProcessFromBuffer(void* outputData, int outputLength)
+void YoloDetector::postProcessFromBuffer(AsyncSlot* slot)
 {
-    static int callbackCount = 0;
-    callbackCount++;
+    if (!slot) {
+        return;
+    }
+    static std::atomic<int> callbackCount{0};
+    int callbackIndex = ++callbackCount;
     
-    bool verboseLog = (callbackCount == 1 || callbackCount % 30 == 0);
+    bool verboseLog = (callbackIndex == 1 || callbackIndex % 30 == 0);
+    uint64_t frameId = slot->frameId;
+    void* outputData = slot->output.data();
+    int outputLength = static_cast<int>(slot->output.size() / sizeof(float));
     
     try {
         if (verboseLog) {
-            qDebug() << "[YOLO CALLBACK] ========== 第" << callbackCount << "次回调 ==========";
-            qDebug() << "[YOLO CALLBACK] 输出数据地址:" << outputData;
-            qDebug() << "[YOLO CALLBACK] 输出长度:" << outputLength;
+            qDebug() << "[YOLO CALLBACK] ========== 第" << callbackIndex << "次回调 ==========";
+            qDebug() << "[YOLO CALLBACK] 帧号:" << frameId << ", 输出长度:" << outputLength;
         }
         
-        // 获取输出张量信息
-        if (verboseLog) {
-            qDebug() << "[YOLO CALLBACK] 获取输出张量信息...";
-        }
-        auto outputs = m_inferenceEngine->GetOutputs();
-        std::vector<std::vector<int64_t>> output_shapes;
-        for (size_t i = 0; i < outputs.size(); ++i) {
-            output_shapes.push_back(outputs[i].shape());
-        }
-        if (verboseLog) {
-            qDebug() << "[YOLO CALLBACK] 输出张量数量:" << outputs.size();
+        // 录制输出张量（仅拷贝到录制槽位，写文件在录制线程完成）；只录制开始录制时的模型输出
+        if (isRecording() && slot->model == m_recordingModel.load()) {
+            m_recorder->record(frameId, slot->inputRef, slot->originalWidth, slot->originalHeight, outputData);
         }
         
-        dxrt::DataType dataType = m_inferenceEngine->outputs().front().type();
-        
         // 调用 YOLO 后处理
-        if (verboseLog) {
-            qDebug() << "[YOLO CALLBACK] 开始 YOLO 后处理...";
+        std::vector<BoundingBox> results;
+        {
+            QMutexLocker locker(&m_postMutex);
+            results = slot->model->yolo->PostProc(outputData, slot->model->outputShapes, slot->model->outputType, outputLength);
         }
-        auto results = m_yolo->PostProc(outputData, output_shapes, dataType, outputLength);
         if (verboseLog) {
             qDebug() << "[YOLO CALLBACK] 后处理完成，检测数量:" << results.size();
         }
         
-        // 坐标缩放 - 从模型输入尺寸映射回原始图像尺寸
+        // 坐标缩放 - 从模型输入尺寸映射回原始图像尺寸（与 PreProc 的 letterbox 对应）
         if (!results.empty()) {
-            int origWidth, origHeight;
-            {
-                QMutexLocker locker(&m_mutex);
-                origWidth = m_currentOriginalWidth;
-                origHeight = m_currentOriginalHeight;
-            }
-            
-            if (verboseLog) {
-                qDebug() << "[YOLO CALLBACK] 坐标缩放: 从" << m_config.width << "x" << m_config.height
-                         << "到" << origWidth << "x" << origHeight;
-            }
-            
-            int npuWidth = m_config.width;
-            int npuHeight = m_config.height;
-            
-            // 计算缩放参数（与 PreProc 的 letterbox 对应）
+            int npuWidth = slot->model->config.width;
+            int npuHeight = slot->model->config.height;
+            int origWidth = slot->originalWidth;
+            int origHeight = slot->originalHeight;
             float preprocRatio = std::min((float)npuWidth / origWidth, (float)npuHeight / origHeight);
             int resizedWidth = (int)(origWidth * preprocRatio);
             int resizedHeight = (int)(origHeight * preprocRatio);
@@ -571,40 +871,29 @@ void YoloDetector::postProcessFromBuffer(void* outputData, int outputLength)
             float padHeight = (npuHeight - resizedHeight) / 2.0f;
             float scaleRatio = 1.0f / preprocRatio;
             
-            // 缩放坐标
             for (auto& box : results) {
                 box.box[0] = (box.box[0] - padWidth) * scaleRatio;
                 box.box[1] = (box.box[1] - padHeight) * scaleRatio;
                 box.box[2] = (box.box[2] - padWidth) * scaleRatio;
                 box.box[3] = (box.box[3] - padHeight) * scaleRatio;
             }
-            
-            if (verboseLog) {
-                qDebug() << "[YOLO CALLBACK] 坐标缩放完成";
-            }
         }
         
-        // 保存结果（线程安全）
+        // 保存结果（线程安全）；多设备时完成顺序可能乱序，不用旧帧覆盖新帧
         {
             QMutexLocker locker(&m_resultMutex);
-            m_latestResults = results;
-        }
-        
-        if (verboseLog) {
-            qDebug() << "[YOLO CALLBACK] 准备发射 detectionComplete 信号...";
-            qDebug() << "[YOLO CALLBACK] 检测结果向量大小:" << results.size();
-            qDebug() << "[YOLO CALLBACK] sizeof(BoundingBox):" << sizeof(BoundingBox);
-            qDebug() << "[YOLO CALLBACK] 预计传输数据量:" << (results.size() * sizeof(BoundingBox)) << "bytes";
+            if (frameId > m_latestResultFrameId) {
+                m_latestResults = results;
+                m_latestResultFrameId = frameId;
+                m_latestResultSubmitTime = slot->submitTime;
+            }
         }
         
         // ========== 轮询模式：不再发射信号 ==========
         // 结果已经保存到 m_latestResults（带 mutex 保护）
         // UI 定时器会通过 getLatestResults() 主动获取
-        // 不再使用 emit detectionComplete() 跨线程信号
-        qDebug() << "[YOLO CALLBACK #" << callbackCount << "] 结果已保存（轮询模式，不发射信号）, size=" << results.size();
-        
         if (verboseLog) {
-            qDebug() << "[YOLO CALLBACK] 回调处理完成 ✓（轮询模式）";
+            qDebug() << "[YOLO CALLBACK] 回调处理完成 ✓（轮询模式）, size=" << results.size();
         }
     }
     catch (const std::exception& e) {
@@ -612,15 +901,65 @@ void YoloDetector::postProcessFromBuffer(void* outputData, int outputLength)
         qCritical() << "[YOLO CALLBACK ERROR]" << error;
         emit errorOccurred(error);
     }
+    
+    double latencyUs = std::chrono::duration<double, std::micro>(Clock::now() - slot->submitTime).count();
+    m_latencySumUs += (uint64_t)latencyUs;
+    m_completedCount++;
 }
 
 // 获取最新检测结果（线程安全）
+bool YoloDetector::startRecording(const QString& path)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_initialized) {
+        emit errorOccurred("模型未初始化，无法录制输出张量");
+        return false;
+    }
+
+    // 录制器对象在构造时创建且不再替换，回调线程可无锁访问
+    if (!m_recorder->start(path.toStdString(), m_model->backend->name(),
+                           m_model->backend->outputDescs(), m_model->backend->outputSize())) {
+        emit errorOccurred(QString("无法创建录制文件: %1").arg(path));
+        return false;
+    }
+    m_recordingModel = m_model.get();
+    qInfo() << "[YOLO] 开始录制输出张量:" << path;
+    return true;
+}
+
+void YoloDetector::stopRecording()
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_recorder->isRecording()) {
+        return;
+    }
+    // 先让回调不再录制；已通过检查的回调由录制器自身加锁，stop() 等待其拷贝完成
+    m_recordingModel = nullptr;
+    m_recorder->stop();
+    qInfo() << "[YOLO] 录制结束, 写入" << m_recorder->recordedCount()
+            << "帧, 丢弃" << m_recorder->droppedCount() << "帧";
+}
+
 std::vector<BoundingBox> YoloDetector::getLatestResults()
 {
     QMutexLocker locker(&m_resultMutex);
     return m_latestResults;
 }
 
+uint64_t YoloDetector::getLatestResultFrameId()
+{
+    QMutexLocker locker(&m_resultMutex);
+    return m_latestResultFrameId;
+}
+
+std::vector<BoundingBox> YoloDetector::getLatestResults(uint64_t& frameId, std::chrono::steady_clock::time_point& submitTime)
+{
+    QMutexLocker locker(&m_resultMutex);
+    frameId = m_latestResultFrameId;
+    submitTime = m_latestResultSubmitTime;
+    return m_latestResults;
+}
+
 std::vector<BoundingBox> YoloDetector::postProcess(
     const uint8_t* outputData,
     const std::vector<std::vector<int64_t>>& outputShapes,
@@ -633,7 +972,7 @@ std::vector<BoundingBox> YoloDetector::postProcess(
     
     // 调用 YOLO 后处理 (需要 void* 类型，强制转换去掉 const)
     int outputLength = m_outputBuffer.size() / sizeof(float);
-    auto results = m_yolo->PostProc(const_cast<uint8_t*>(outputData), outputShapes, dataType, outputLength);
+    auto results = m_model->yolo->PostProc(const_cast<uint8_t*>(outputData), outputShapes, dataType, outputLength);
     
     qDebug() << "[PostProcess] YOLO后处理完成, 检测数:" << results.size();
     
@@ -1,52 +1,15 @@
 ﻿#include <QtWidgets/QApplication>
 #include <QStyleFactory>
 #include <QDir>
-#include <QFile>
 #include <QDebug>
 #include <QDateTime>
 #include "MainWindow.h"
+#include "AsyncLogger.h"
 #include "yolo/bbox.h"
 
 // 注册自定义类型以支持跨线程信号传递
 Q_DECLARE_METATYPE(std::vector<BoundingBox>)
 
-// 自定义消息处理器，将 qDebug 输出重定向到文件和控制台
-void customMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
-{
-    static QFile logFile(QApplication::applicationDirPath() + "/debug.log");
-    static bool isOpen = logFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Append);
-    
-    QString txt;
-    switch (type) {
-    case QtDebugMsg:
-        txt = QString("[DEBUG] %1").arg(msg);
-        break;
-    case QtInfoMsg:
-        txt = QString("[INFO] %1").arg(msg);
-        break;
-    case QtWarningMsg:
-        txt = QString("[WARNING] %1").arg(msg);
-        break;
-    case QtCriticalMsg:
-        txt = QString("[CRITICAL] %1").arg(msg);
-        break;
-    case QtFatalMsg:
-        txt = QString("[FATAL] %1").arg(msg);
-        break;
-    }
-    
-    QString logMsg = QString("%1 %2\n").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz")).arg(txt);
-    
-    if (isOpen) {
-        QTextStream stream(&logFile);
-        stream << logMsg;
-        logFile.flush();
-    }
-    
-    // 同时输出到标准错误
-    fprintf(stderr, "%s", logMsg.toLocal8Bit().constData());
-}
-
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
@@ -59,8 +22,10 @@ int main(int argc, char *argv[])
     qDebug() << "[MAIN] 主线程 ID:" << QThread::currentThreadId();
     qDebug() << "[MAIN] ========================================";
     
-    // 安装自定义消息处理器
-    qInstallMessageHandler(customMessageHandler);
+    // 安装异步日志：qDebug 输出由后台线程批量写入 debug.log 和控制台，采集/推理线程不等待磁盘
+    AsyncLoggerConfig logConfig;
+    logConfig.filePath = QApplication::applicationDirPath() + "/debug.log";
+    AsyncLogger::instance().start(logConfig);
     
     qDebug() << "========== 应用程序启动 ==========";
     qDebug() << "启动时间:" << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
@@ -84,10 +49,16 @@ int main(int argc, char *argv[])
     qDebug() << "设置工作目录后:" << QDir::currentPath();
     
     qDebug() << "@@@@@@@@@@@@@@@ 准备创建 MainWindow @@@@@@@@@@@@@@@";
-    // 创建并显示主窗口
-    MainWindow window;
-    qDebug() << "@@@@@@@@@@@@@@@ MainWindow 创建完成 @@@@@@@@@@@@@@@";
-    window.show();
-    qDebug() << "@@@@@@@@@@@@@@@ MainWindow.show() 完成 @@@@@@@@@@@@@@@";
-    return app.exec();
+    int exitCode = 0;
+    {
+        // 创建并显示主窗口
+        MainWindow window;
+        qDebug() << "@@@@@@@@@@@@@@@ MainWindow 创建完成 @@@@@@@@@@@@@@@";
+        window.show();
+        qDebug() << "@@@@@@@@@@@@@@@ MainWindow.show() 完成 @@@@@@@@@@@@@@@";
+        exitCode = app.exec();
+    }
+    // 主窗口析构（断开相机等）的日志也要写出后再退出
+    AsyncLogger::instance().stop();
+    return exitCode;
 }
\ No newline at end of file
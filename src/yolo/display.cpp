@@ -1,17 +1,28 @@
 #include "display.h"
 #include <utils/color_table.hpp>
-#include <cstdio>
+#include "label_cache.h"
 
 void DisplayBoundingBox(cv::Mat& frame, 
                        std::vector<BoundingBox>& result, 
                        float OriginHeight, 
                        float OriginWidth, 
-                       std::vector<cv::Scalar> ObjectColors, 
+                       const std::vector<cv::Scalar>& ObjectColors, 
                        PostProcType type, 
                        bool ImageCenterAligned, 
                        float InputWidth, 
                        float InputHeight)
 {
+    // 标签："person=0.87"，类别颜色背景、白色文字
+    static LabelSpriteCache labelCache([] {
+        LabelStyle style;
+        style.fontScale = 0.4;
+        style.separator = "=";
+        style.scoreFormat = LabelScoreFormat::Decimal;
+        style.decimals = 2;
+        style.padding = 1;
+        return style;
+    }());
+
     // 注意：如果在 YoloDetector 中已经做了坐标缩放，这里就不需要再次缩放
     // 这个函数主要用于当坐标还是模型输入尺寸时的转换
     // 如果坐标已经是原始图像尺寸，可以直接绘制
@@ -23,7 +34,6 @@ void DisplayBoundingBox(cv::Mat& frame,
     float r = 1.0f;  // 默认不缩放（假设坐标已经转换）
     bool reformatting = false;
     float reformatting_ratio_width = 1.f, reformatting_ratio_height = 1.f;
-    int txtBaseline = 0;
 
     // 如果提供了 OriginWidth 和 OriginHeight，说明需要进行坐标转换
     bool needsScaling = (OriginWidth > 0 && OriginHeight > 0 && 
@@ -86,27 +96,12 @@ void DisplayBoundingBox(cv::Mat& frame,
         y1 = std::min((float)h, std::max((float)0.0, y1));
         y2 = std::min((float)h, std::max((float)0.0, y2));
 
-        // Create label text with score (rounded to 2 decimal places)
-        char scoreStr[16];
-        snprintf(scoreStr, sizeof(scoreStr), "%.2f", bbox.score);
-        std::string labelWithScore = bbox.labelname + "=" + scoreStr;
-        
-        // Get text size for the combined label and score
-        auto textSize = cv::getTextSize(labelWithScore, cv::FONT_HERSHEY_SIMPLEX, 0.4, 1, &txtBaseline);
-        
         // Draw bounding box
         cv::rectangle(frame, cv::Point(x1, y1), cv::Point(x2, y2), ObjectColors[bbox.label], 2);
         
-        // Draw label background
-        cv::rectangle(frame, 
-                     cv::Point(x1, y1-textSize.height), 
-                     cv::Point(x1 + textSize.width, y1), 
-                     ObjectColors[bbox.label], 
-                     cv::FILLED);
-        
-        // Draw label text with score
-        cv::putText(frame, labelWithScore, cv::Point(x1, y1), 
-                   cv::FONT_HERSHEY_SIMPLEX, 0.4, cv::Scalar(255,255,255));
+        // Draw label (class name and score) from cached sprites
+        labelCache.draw(frame, cv::Point(x1, y1), bbox.labelname, bbox.score,
+                        cv::Scalar(255, 255, 255), ObjectColors[bbox.label]);
 
         if (type == PostProcType::POSE) 
         {
@@ -1,8 +1,10 @@
 #include "image.h"
 #include <opencv2/opencv.hpp>
 
-void PreProc(cv::Mat& src, cv::Mat& dest, bool keepRatio, bool bgr2rgb, uint8_t padValue)
+void PreProc(const cv::Mat& src, cv::Mat& dest, bool keepRatio, bool bgr2rgb, uint8_t padValue)
 {
+    // 单通道输入（Mono8 相机帧）缩放后再扩展为三通道，避免整帧颜色转换；灰度扩展后 RGB/BGR 相同
+    bool gray = src.channels() == 1;
     cv::Mat Resized;
     if(keepRatio)
     {
@@ -23,6 +25,10 @@ void PreProc(cv::Mat& src, cv::Mat& dest, bool keepRatio, bool bgr2rgb, uint8_t
         }
         cv::Mat src2;
         cv::resize(src, src2, cv::Size(newWidth, newHeight), 0, 0, cv::INTER_LINEAR);
+        if(gray)
+        {
+            cv::cvtColor(src2, src2, cv::COLOR_GRAY2BGR);
+        }
         dw = (dest.cols - src2.cols)/2.;
         dh = (dest.rows - src2.rows)/2.;
         top    = (uint16_t)round(dh - 0.1);
@@ -31,11 +37,16 @@ void PreProc(cv::Mat& src, cv::Mat& dest, bool keepRatio, bool bgr2rgb, uint8_t
         right  = (uint16_t)round(dw + 0.1);
         cv::copyMakeBorder(src2, dest, top, bottom, left, right, cv::BORDER_CONSTANT, cv::Scalar(padValue,padValue,padValue));
     }
+    else if(gray)
+    {
+        cv::resize(src, Resized, cv::Size(dest.cols, dest.rows), 0, 0, cv::INTER_LINEAR);
+        cv::cvtColor(Resized, dest, cv::COLOR_GRAY2BGR);
+    }
     else
     {
         cv::resize(src, dest, cv::Size(dest.cols, dest.rows), 0, 0, cv::INTER_LINEAR);
     }
-    if(bgr2rgb)
+    if(bgr2rgb && !gray)
     {
         cv::cvtColor(dest, dest, cv::COLOR_BGR2RGB);
     }
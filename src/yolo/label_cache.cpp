@@ -0,0 +1,189 @@
+#include "label_cache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // 按覆盖率把 color 混合到 dst 的 area 区域，mask 左上角对应 dst 的 origin
+    template <int CN>
+    void blendMask(cv::Mat& dst, const cv::Mat& mask, const cv::Point& origin, const cv::Rect& area, const uchar color[4])
+    {
+        for (int y = area.y; y < area.y + area.height; y++) {
+            const uchar* m = mask.ptr<uchar>(y - origin.y) + (area.x - origin.x);
+            uchar* d = dst.ptr<uchar>(y) + area.x * CN;
+            for (int x = 0; x < area.width; x++, d += CN) {
+                const int a = m[x];
+                if (a == 0) {
+                    continue;
+                }
+                for (int c = 0; c < 3; c++) {
+                    d[c] = (uchar)((d[c] * (255 - a) + color[c] * a + 127) / 255);
+                }
+                if (CN == 4) {
+                    d[3] = 255;
+                }
+            }
+        }
+    }
+}
+
+LabelSpriteCache::LabelSpriteCache(const LabelStyle& style)
+    : m_style(style)
+{
+    // 所有精灵共用一个行高：基线以上留字符最大高度，以下留下伸部分，上下各留一个笔画粗细
+    int baseline = 0;
+    cv::Size size = cv::getTextSize("0123456789%Agjpqy|", m_style.fontFace, m_style.fontScale, m_style.thickness, &baseline);
+    m_baseline = m_style.thickness + size.height;
+    m_cellHeight = m_baseline + baseline + m_style.thickness;
+
+    for (const char* c = "0123456789.%"; *c; c++) {
+        m_glyphs[(int)*c] = render(std::string(1, *c));
+    }
+}
+
+LabelSpriteCache::Sprite LabelSpriteCache::render(const std::string& text) const
+{
+    // getTextSize 的宽度 = 前进宽度之和 + 笔画粗细；文字从 x = thickness 开始画，左右都不会被截断
+    int baseline = 0;
+    cv::Size size = cv::getTextSize(text, m_style.fontFace, m_style.fontScale, m_style.thickness, &baseline);
+    Sprite sprite;
+    sprite.advance = std::max(0, size.width - m_style.thickness);
+    sprite.mask = cv::Mat::zeros(m_cellHeight, sprite.advance + 3 * m_style.thickness, CV_8UC1);
+    if (!text.empty()) {
+        cv::putText(sprite.mask, text, cv::Point(m_style.thickness, m_baseline), m_style.fontFace, m_style.fontScale,
+                    cv::Scalar(255), m_style.thickness, cv::LINE_AA);
+    }
+    return sprite;
+}
+
+LabelSpriteCache::Sprite LabelSpriteCache::nameSprite(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_names.find(name);
+    if (it != m_names.end()) {
+        return it->second;
+    }
+    if (m_names.size() >= kMaxNames) {
+        m_names.clear();
+    }
+    return m_names.emplace(name, render(name + m_style.separator)).first->second;
+}
+
+int LabelSpriteCache::formatScore(float score, char* buf) const
+{
+    score = std::max(0.f, score);
+    char digits[12];
+    int n = 0;
+    auto appendInt = [&](long value, int minDigits) {
+        int count = 0;
+        do {
+            digits[count++] = (char)('0' + value % 10);
+            value /= 10;
+        } while ((value > 0 || count < minDigits) && count < (int)sizeof(digits));
+        while (count > 0) {
+            buf[n++] = digits[--count];
+        }
+    };
+
+    if (m_style.scoreFormat == LabelScoreFormat::Percent) {
+        appendInt(std::min(100L, (long)(score * 100)), 1);
+        buf[n++] = '%';
+        return n;
+    }
+
+    const int decimals = std::min(std::max(m_style.decimals, 0), 6);
+    long scale = 1;
+    for (int i = 0; i < decimals; i++) {
+        scale *= 10;
+    }
+    long value = std::lround(std::min(score, 999.f) * scale);
+    appendInt(value / scale, 1);
+    if (decimals > 0) {
+        buf[n++] = '.';
+        appendInt(value % scale, decimals);
+    }
+    return n;
+}
+
+int LabelSpriteCache::textWidth(const Sprite& name, const char* score, int scoreLength) const
+{
+    int advance = name.advance;
+    for (int i = 0; i < scoreLength; i++) {
+        advance += m_glyphs[(int)score[i]].advance;
+    }
+    return advance + 3 * m_style.thickness;
+}
+
+void LabelSpriteCache::compose(const Sprite& name, const char* score, int scoreLength, cv::Mat& mask) const
+{
+    // 相邻字符的抗锯齿边缘可能重叠，按最大值合并，保证只混合一次
+    int pen = 0;
+    auto place = [&](const Sprite& sprite) {
+        cv::Mat roi = mask(cv::Rect(pen, 0, sprite.mask.cols, sprite.mask.rows));
+        cv::max(roi, sprite.mask, roi);
+        pen += sprite.advance;
+    };
+    place(name);
+    for (int i = 0; i < scoreLength; i++) {
+        place(m_glyphs[(int)score[i]]);
+    }
+}
+
+cv::Size LabelSpriteCache::measure(const std::string& name, float score)
+{
+    char score_text[16];
+    int length = formatScore(score, score_text);
+    return cv::Size(textWidth(nameSprite(name), score_text, length) + 2 * m_style.padding,
+                    m_cellHeight + 2 * m_style.padding);
+}
+
+cv::Rect LabelSpriteCache::draw(cv::Mat& dst, const cv::Point& boxTopLeft, const std::string& name, float score,
+                                const cv::Scalar& textColor, const cv::Scalar& backgroundColor)
+{
+    if (dst.empty() || dst.depth() != CV_8U || (dst.channels() != 3 && dst.channels() != 4)) {
+        return cv::Rect();
+    }
+
+    const Sprite sprite = nameSprite(name);
+    char score_text[16];
+    const int length = formatScore(score, score_text);
+    const int width = textWidth(sprite, score_text, length);
+    const int pad = m_style.padding;
+
+    // 标签放在框的上方，超出图像顶部时放到框内
+    cv::Rect label(boxTopLeft.x, boxTopLeft.y - (m_cellHeight + 2 * pad), width + 2 * pad, m_cellHeight + 2 * pad);
+    if (label.y < 0) {
+        label.y = boxTopLeft.y;
+    }
+    const cv::Rect clipped = label & cv::Rect(0, 0, dst.cols, dst.rows);
+    if (clipped.empty()) {
+        return clipped;
+    }
+
+    if (m_style.fillBackground) {
+        cv::Scalar fill = backgroundColor;
+        fill[3] = 255;
+        dst(clipped).setTo(fill);
+    }
+
+    // 拼接用的覆盖率图按线程复用，只在更宽的标签出现时重新分配
+    thread_local cv::Mat scratch;
+    if (scratch.rows < m_cellHeight || scratch.cols < width) {
+        scratch.create(std::max(scratch.rows, m_cellHeight), std::max(scratch.cols, width), CV_8UC1);
+    }
+    cv::Mat mask = scratch(cv::Rect(0, 0, width, m_cellHeight));
+    mask.setTo(0);
+    compose(sprite, score_text, length, mask);
+
+    const cv::Point origin(label.x + pad, label.y + pad);
+    const cv::Rect area = cv::Rect(origin, mask.size()) & clipped;
+    const uchar color[4] = { cv::saturate_cast<uchar>(textColor[0]), cv::saturate_cast<uchar>(textColor[1]),
+                             cv::saturate_cast<uchar>(textColor[2]), 255 };
+    if (dst.channels() == 3) {
+        blendMask<3>(dst, mask, origin, area, color);
+    }
+    else {
+        blendMask<4>(dst, mask, origin, area, color);
+    }
+    return clipped;
+}
@@ -0,0 +1,122 @@
+#include "motion_gate.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cstdlib>
+
+MotionGate::MotionGate()
+{
+    reset();
+}
+
+MotionGate::MotionGate(const MotionGateConfig& config)
+    : m_config(config)
+{
+    reset();
+}
+
+void MotionGate::setConfig(const MotionGateConfig& config)
+{
+    m_config = config;
+    reset();
+}
+
+void MotionGate::reset()
+{
+    m_background.release();
+    m_sourceSize = cv::Size();
+    m_blocksX = 0;
+    m_blocksY = 0;
+    m_lastChangedBlocks = 0;
+    m_pending = true;              // 首帧总是推理
+    m_framesSinceSubmit = 0;
+    m_frames = 0;
+    m_changedFrames = 0;
+    m_gatedFrames = 0;
+}
+
+void MotionGate::toLuma(const cv::Mat& frame, cv::Mat& luma) const
+{
+    // 先缩放再转灰度：INTER_AREA 取块均值，同时抑制传感器噪声；颜色转换只作用于小图
+    cv::Size size(m_blocksX * kBlockSize, m_blocksY * kBlockSize);
+    if (frame.channels() == 1) {
+        cv::resize(frame, luma, size, 0, 0, cv::INTER_AREA);
+        return;
+    }
+    cv::Mat small;
+    cv::resize(frame, small, size, 0, 0, cv::INTER_AREA);
+    cv::cvtColor(small, luma, frame.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+}
+
+int MotionGate::countChangedBlocks(const cv::Mat& luma) const
+{
+    const int blockThreshold = m_config.blockThreshold * kBlockSize * kBlockSize;
+    int changed = 0;
+    for (int by = 0; by < m_blocksY; by++) {
+        for (int bx = 0; bx < m_blocksX; bx++) {
+            unsigned sad = 0;
+            for (int y = by * kBlockSize; y < (by + 1) * kBlockSize; y++) {
+                const uint8_t* cur = luma.ptr<uint8_t>(y) + bx * kBlockSize;
+                const uint8_t* bg = m_background.ptr<uint8_t>(y) + bx * kBlockSize;
+#if CV_SIMD128
+                // 一行 16 像素正好一个 128 位寄存器（SSE2 psadbw / NEON vabd + 累加）
+                sad += cv::v_reduce_sad(cv::v_load(cur), cv::v_load(bg));
+#else
+                for (int x = 0; x < kBlockSize; x++) {
+                    sad += (unsigned)std::abs((int)cur[x] - (int)bg[x]);
+                }
+#endif
+            }
+            if ((int)sad > blockThreshold) {
+                changed++;
+            }
+        }
+    }
+    return changed;
+}
+
+bool MotionGate::update(const cv::Mat& frame)
+{
+    if (frame.empty()) {
+        return false;
+    }
+    m_frames++;
+    m_framesSinceSubmit++;
+
+    if (frame.size() != m_sourceSize || m_background.empty()) {
+        // 分辨率变化（或首帧）：重建分析尺寸和背景，本帧按变化处理
+        int width = std::max(std::min(m_config.analysisWidth, frame.cols), kBlockSize);
+        int height = std::max(width * frame.rows / std::max(frame.cols, 1), kBlockSize);
+        m_blocksX = width / kBlockSize;
+        m_blocksY = height / kBlockSize;
+        m_sourceSize = frame.size();
+        toLuma(frame, m_background);
+        m_lastChangedBlocks = blockCount();
+        m_changedFrames++;
+        m_pending = true;
+        return true;
+    }
+
+    toLuma(frame, m_luma);
+    m_lastChangedBlocks = countChangedBlocks(m_luma);
+    bool changed = m_lastChangedBlocks >= std::max(m_config.minChangedBlocks, 1);
+    if (changed) {
+        m_changedFrames++;
+        m_pending = true;
+    }
+
+    // 滑动背景：bg = (1 - alpha) * bg + alpha * cur
+    cv::addWeighted(m_background, 1.0 - m_config.backgroundAlpha, m_luma, m_config.backgroundAlpha, 0, m_background);
+
+    bool refresh = m_config.refreshInterval > 0 && m_framesSinceSubmit >= m_config.refreshInterval;
+    if (m_pending || refresh) {
+        return true;
+    }
+    m_gatedFrames++;
+    return false;
+}
+
+void MotionGate::markSubmitted()
+{
+    m_pending = false;
+    m_framesSinceSubmit = 0;
+}
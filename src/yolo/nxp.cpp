@@ -8,11 +8,13 @@
 #include <string.h> // for memcpy
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <opencv2/opencv.hpp>
 #include "nxp.h"
+#include "label_cache.h"
 
 FrameBuffer::FrameBuffer(string dev, uint32_t numBuf_)
-:numBuf(numBuf_)
+:numBuf(numBuf_), frontBuf(0), canFlip(false), waitVsync(true)
 {
     fd = open((char*)dev.c_str(), O_RDWR);
     if (fd == -1) {
@@ -34,6 +36,19 @@ FrameBuffer::FrameBuffer(string dev, uint32_t numBuf_)
     yres = vinfo.yres;
     bpp = vinfo.bits_per_pixel/8;
 
+    // 页数受显存和虚拟分辨率限制，不足时减少页数（只有一页时直接在显示页上绘制）
+    if (numBuf < 1) numBuf = 1;
+    if (numBuf > kMaxBuf) numBuf = kMaxBuf;
+    if (finfo.smem_len > 0 && (long)finfo.smem_len < screenSize * (long)numBuf) {
+        numBuf = std::max<long>(1, finfo.smem_len / screenSize);
+    }
+    canFlip = numBuf > 1 && vinfo.yres_virtual >= yres * numBuf;
+    if (numBuf > 1 && !canFlip) {
+        printf("    - Warning: virtual resolution %dx%d cannot hold %d pages, page flipping disabled\n",
+            vinfo.xres_virtual, vinfo.yres_virtual, numBuf);
+        numBuf = 1;
+    }
+
     printf("    - Framebuffer Resolution: %dx%d, %d bytes per pixel\n", vinfo.xres, vinfo.yres, bpp);
     printf("    - Framebuffer size: %ld bytes x %d\n", screenSize, numBuf);
 
@@ -48,22 +63,103 @@ FrameBuffer::FrameBuffer(string dev, uint32_t numBuf_)
     }
     std::cout << "    - Framebuffer Pointer: " << std::hex << (uint64_t)data[0] << std::dec << std::endl;
 }
+
+FrameBuffer::~FrameBuffer()
+{
+    munmap(data[0], screenSize*numBuf);
+    close(fd);
+}
+
 void FrameBuffer::Clear()
 {
-    char *buf = (char*)data[0];
-    for(int i=0;i<screenSize*numBuf;i++)
+    // memset 由 libc 按 SIMD 宽度整块清零
+    memset(data[0], 0, screenSize*numBuf);
+    for(int i=0;i<(int)numBuf;i++)
     {
-        buf[i] = 0;
+        dirty[i].clear();
+    }
+}
+
+void FrameBuffer::MarkDirty(int bufId, const cv::Rect &rect)
+{
+    cv::Rect clipped = rect & cv::Rect(0, 0, xres, yres);
+    if (!clipped.empty()) {
+        dirty[bufId].push_back(clipped);
     }
 }
 
+void FrameBuffer::EraseRect(int bufId, const cv::Rect &rect)
+{
+    // 逐行清零区域宽度的字节
+    const size_t lineBytes = (size_t)xres * bpp;
+    const size_t rowBytes = (size_t)rect.width * bpp;
+    uint8_t *base = (uint8_t*)data[bufId] + (size_t)rect.y * lineBytes + (size_t)rect.x * bpp;
+    for(int y=0;y<rect.height;y++)
+    {
+        memset(base + y * lineBytes, 0, rowBytes);
+    }
+}
+
+int FrameBuffer::NextBuffer()
+{
+    // 后台页轮流使用：正在显示的下一页是最早提交的一页
+    return numBuf > 1 ? (frontBuf + 1) % numBuf : 0;
+}
+
+bool FrameBuffer::Present(int bufId)
+{
+    bufId = PageIndex(bufId);
+    if (bufId < 0) {
+        return false;
+    }
+    if (!canFlip) {
+        frontBuf = 0;
+        return true;
+    }
+    // 在垂直消隐期间切换，避免撕裂；驱动不支持时退化为立即切换
+    if (waitVsync) {
+        uint32_t crtc = 0;
+        if (ioctl(fd, FBIO_WAITFORVSYNC, &crtc) == -1) {
+            waitVsync = false;
+        }
+    }
+    vinfo.yoffset = yres * bufId;
+    if (ioctl(fd, FBIOPAN_DISPLAY, &vinfo)) {
+        perror("Error panning display");
+        canFlip = false;
+        return false;
+    }
+    frontBuf = bufId;
+    return true;
+}
+
 void FrameBuffer::DrawBoxes(int bufId, std::vector<BoundingBox> &result, std::vector<cv::Scalar> &colors, float OriginHeight, float OriginWidth)
 {
+    // 按请求页数使用页号的调用方在页数被减少后也不会越界
+    bufId = PageIndex(bufId);
+    if (bufId < 0) {
+        return;
+    }
+    EraseBoxes(bufId, result, OriginHeight, OriginWidth);
+
     void *buf = data[bufId];
     cv::Mat image(yres, xres, CV_8UC4, buf, xres * bpp);
     float rx = OriginWidth/xres;
     float ry = OriginHeight/yres;
     uint32_t x1, y1, x2, y2;
+    const int thickness = 2;
+    const int margin = thickness;   // 边框向两侧扩展半个线宽，按整个线宽留余量
+    // 标签："person 0.87"，类别颜色文字、透明背景
+    static LabelSpriteCache labelCache([] {
+        LabelStyle style;
+        style.fontScale = 1.0;
+        style.thickness = 2;
+        style.separator = " ";
+        style.scoreFormat = LabelScoreFormat::Decimal;
+        style.decimals = 2;
+        style.fillBackground = false;
+        return style;
+    }());
 
     for(auto &bbox:result)
     {
@@ -71,28 +167,45 @@ void FrameBuffer::DrawBoxes(int bufId, std::vector<BoundingBox> &result, std::ve
         y1 = bbox.box[1]/ry < 0.f ? 0: (uint32_t)(bbox.box[1]/ry);
         x2 = bbox.box[2]/rx > xres ? xres: (uint32_t)(bbox.box[2]/rx);
         y2 = bbox.box[3]/ry > yres ? yres: (uint32_t)(bbox.box[3]/ry);
-        char label_score[64] = {0, };
-        sprintf(label_score, "%s %.4lf", bbox.labelname, bbox.score);
+        cv::Scalar color(colors[bbox.label][0], colors[bbox.label][1], colors[bbox.label][2], 255);
         cv::rectangle(image, 
             cv::Point(x1, y1), 
             cv::Point(x2, y2), 
-            cv::Scalar(colors[bbox.label][0], colors[bbox.label][1], colors[bbox.label][2], 255), 
-            2, 8, 0);
-        cv::putText(image, label_score, cv::Point(x1, y1-5),
-                cv::FONT_HERSHEY_SIMPLEX, 1.0, 
-                cv::Scalar(colors[bbox.label][0], colors[bbox.label][1], colors[bbox.label][2], 255), 
-                2);
+            color, 
+            thickness, 8, 0);
+        cv::Rect label = labelCache.draw(image, cv::Point(x1, y1), bbox.labelname, bbox.score, color, color);
+
+        // 只记录实际画过的像素：四条边框和标签，框内部不擦除
+        int left = (int)x1, top = (int)y1, right = (int)x2, bottom = (int)y2;
+        int w = right - left, h = bottom - top;
+        MarkDirty(bufId, cv::Rect(left - margin, top - margin, w + 2 * margin + 1, 2 * margin + 1));
+        MarkDirty(bufId, cv::Rect(left - margin, bottom - margin, w + 2 * margin + 1, 2 * margin + 1));
+        MarkDirty(bufId, cv::Rect(left - margin, top - margin, 2 * margin + 1, h + 2 * margin + 1));
+        MarkDirty(bufId, cv::Rect(right - margin, top - margin, 2 * margin + 1, h + 2 * margin + 1));
+        MarkDirty(bufId, label);
     }
-    vinfo.yoffset = yres * bufId;
-    if (ioctl(fd, FBIOPAN_DISPLAY, &vinfo)) {
-		perror("Error panning display");
-		exit(5);
-	}
+    Present(bufId);
+}
+
+int FrameBuffer::DrawBoxes(std::vector<BoundingBox> &result, std::vector<cv::Scalar> &colors, float OriginHeight, float OriginWidth)
+{
+    // 后台页不在显示中，绘制过程不会被看到；Present() 在垂直同步时切换过去
+    int bufId = NextBuffer();
+    DrawBoxes(bufId, result, colors, OriginHeight, OriginWidth);
+    return bufId;
 }
+
 void FrameBuffer::EraseBoxes(int bufId, std::vector<BoundingBox> &result, float OriginHeight, float OriginWidth)
 {
-    char *buf = (char*)data[bufId];
-    memset(buf, 0, screenSize); 
+    bufId = PageIndex(bufId);
+    if (bufId < 0) {
+        return;
+    }
+    for(const cv::Rect &rect : dirty[bufId])
+    {
+        EraseRect(bufId, rect);
+    }
+    dirty[bufId].clear();
 }
 
 
@@ -0,0 +1,287 @@
+#include "tracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// 噪声按目标高度缩放（与 ByteTrack 相同的思路），时间单位为秒
+const float kPositionStd = 0.05f;      // 观测噪声：高度的 5%
+const float kProcessPositionStd = 0.05f;
+const float kProcessVelocityStd = 0.6f; // 速度随机游走：每秒高度的 60%
+const float kInitVelocityStd = 1.0f;
+
+inline float square(float value)
+{
+    return value * value;
+}
+
+} // namespace
+
+MultiObjectTracker::MultiObjectTracker()
+    : m_nextId(1)
+{
+}
+
+MultiObjectTracker::MultiObjectTracker(const TrackerConfig& config)
+    : m_config(config)
+    , m_nextId(1)
+{
+}
+
+void MultiObjectTracker::reset()
+{
+    m_tracks.clear();
+    m_nextId = 1;
+}
+
+void MultiObjectTracker::initTrack(Track& track, const BoundingBox& detection, double timestampSec) const
+{
+    float w = detection.box[2] - detection.box[0];
+    float h = detection.box[3] - detection.box[1];
+    track.label = detection.label;
+    track.labelname = detection.labelname;
+    track.score = detection.score;
+    track.x = State(detection.box[0] + w / 2, detection.box[1] + h / 2, w, h, 0, 0, 0, 0);
+    track.P = Covariance::zeros();
+    float posVar = square(2 * kPositionStd * h);
+    float velVar = square(kInitVelocityStd * h);
+    for (int i = 0; i < 4; i++) {
+        track.P(i, i) = posVar;
+        track.P(i + 4, i + 4) = velVar;
+    }
+    track.time = timestampSec;
+    track.lastSeen = timestampSec;
+    track.hits = 1;
+    track.matched = true;
+}
+
+void MultiObjectTracker::predictTrack(Track& track, double timestampSec) const
+{
+    float dt = (float)(timestampSec - track.time);
+    if (dt <= 0) {
+        return;
+    }
+    Covariance F = Covariance::eye();
+    for (int i = 0; i < 4; i++) {
+        F(i, i + 4) = dt;
+    }
+    float h = std::max(track.x(3), 1.0f);
+    Covariance Q = Covariance::zeros();
+    for (int i = 0; i < 4; i++) {
+        Q(i, i) = square(kProcessPositionStd * h) * dt;
+        Q(i + 4, i + 4) = square(kProcessVelocityStd * h) * dt;
+    }
+    track.x = F * track.x;
+    track.P = F * track.P * F.t() + Q;
+    track.time = timestampSec;
+}
+
+void MultiObjectTracker::correctTrack(Track& track, const BoundingBox& detection) const
+{
+    float w = detection.box[2] - detection.box[0];
+    float h = detection.box[3] - detection.box[1];
+    cv::Matx<float, 4, 1> z(detection.box[0] + w / 2, detection.box[1] + h / 2, w, h);
+
+    // H = [I 0]：直接取状态和协方差的子块，避免 8x8 矩阵乘法
+    cv::Matx<float, 4, 1> y;
+    cv::Matx<float, 4, 4> S;
+    cv::Matx<float, 8, 4> PHt;
+    float r = square(kPositionStd * std::max(track.x(3), 1.0f));
+    for (int i = 0; i < 4; i++) {
+        y(i) = z(i) - track.x(i);
+        for (int j = 0; j < 4; j++) {
+            S(i, j) = track.P(i, j) + (i == j ? r : 0);
+        }
+    }
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 4; j++) {
+            PHt(i, j) = track.P(i, j);
+        }
+    }
+    cv::Matx<float, 8, 4> K = PHt * S.inv(cv::DECOMP_CHOLESKY);
+    track.x += K * y;
+    // P = (I - KH) P，KH 只有左 4 列非零
+    cv::Matx<float, 8, 8> KH = cv::Matx<float, 8, 8>::zeros();
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 4; j++) {
+            KH(i, j) = K(i, j);
+        }
+    }
+    track.P = (Covariance::eye() - KH) * track.P;
+
+    track.label = detection.label;
+    track.labelname = detection.labelname;
+    track.score = detection.score;
+    track.lastSeen = track.time;
+    track.hits++;
+    track.matched = true;
+}
+
+void MultiObjectTracker::toBox(const State& x, double dt, float box[4], float velocity[2])
+{
+    float t = (float)std::max(dt, 0.0);
+    float cx = x(0) + x(4) * t;
+    float cy = x(1) + x(5) * t;
+    float w = std::max(x(2) + x(6) * t, 1.0f);
+    float h = std::max(x(3) + x(7) * t, 1.0f);
+    box[0] = cx - w / 2;
+    box[1] = cy - h / 2;
+    box[2] = cx + w / 2;
+    box[3] = cy + h / 2;
+    velocity[0] = x(4);
+    velocity[1] = x(5);
+}
+
+std::vector<std::pair<int, int>> MultiObjectTracker::associate(const std::vector<int>& trackIndices,
+                                                               const std::vector<int>& detIndices,
+                                                               const std::vector<BoundingBox>& detections,
+                                                               float minIou) const
+{
+    std::vector<std::pair<int, int>> matches;
+    const size_t numTracks = trackIndices.size();
+    const size_t numDets = detIndices.size();
+    if (numTracks == 0 || numDets == 0) {
+        return matches;
+    }
+
+    // 检测框按结构数组存放，逐条轨迹对整行检测计算 IoU
+    std::vector<float> dx1(numDets), dy1(numDets), dx2(numDets), dy2(numDets), darea(numDets), dlabel(numDets);
+    for (size_t j = 0; j < numDets; j++) {
+        const BoundingBox& det = detections[detIndices[j]];
+        dx1[j] = det.box[0];
+        dy1[j] = det.box[1];
+        dx2[j] = det.box[2];
+        dy2[j] = det.box[3];
+        darea[j] = std::max(det.box[2] - det.box[0], 0.0f) * std::max(det.box[3] - det.box[1], 0.0f);
+        dlabel[j] = (float)det.label;
+    }
+
+    std::vector<float> iou(numTracks * numDets);
+    for (size_t i = 0; i < numTracks; i++) {
+        const Track& track = m_tracks[trackIndices[i]];
+        float tbox[4], velocity[2];
+        toBox(track.x, 0, tbox, velocity);
+        const float tx1 = tbox[0], ty1 = tbox[1], tx2 = tbox[2], ty2 = tbox[3];
+        const float tarea = (tx2 - tx1) * (ty2 - ty1);
+        const float tlabel = (float)track.label;
+        const float classMask = m_config.classAware ? 1.0f : 0.0f;
+        float* row = &iou[i * numDets];
+        for (size_t j = 0; j < numDets; j++) {
+            float iw = std::max(std::min(tx2, dx2[j]) - std::max(tx1, dx1[j]), 0.0f);
+            float ih = std::max(std::min(ty2, dy2[j]) - std::max(ty1, dy1[j]), 0.0f);
+            float inter = iw * ih;
+            float value = inter / std::max(tarea + darea[j] - inter, 1e-6f);
+            // 类别不同时置 0（乘法代替分支）
+            float sameClass = (tlabel == dlabel[j]) ? 1.0f : 0.0f;
+            row[j] = value * (1.0f - classMask * (1.0f - sameClass));
+        }
+    }
+
+    std::vector<std::pair<float, int>> candidates;
+    for (size_t k = 0; k < iou.size(); k++) {
+        if (iou[k] >= minIou) {
+            candidates.emplace_back(iou[k], (int)k);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const std::pair<float, int>& a, const std::pair<float, int>& b) { return a.first > b.first; });
+
+    std::vector<char> trackUsed(numTracks, 0), detUsed(numDets, 0);
+    for (const auto& candidate : candidates) {
+        int i = candidate.second / (int)numDets;
+        int j = candidate.second % (int)numDets;
+        if (trackUsed[i] || detUsed[j]) {
+            continue;
+        }
+        trackUsed[i] = 1;
+        detUsed[j] = 1;
+        matches.emplace_back(trackIndices[i], detIndices[j]);
+    }
+    return matches;
+}
+
+void MultiObjectTracker::update(const std::vector<BoundingBox>& detections, double timestampSec)
+{
+    std::vector<int> allTracks;
+    for (size_t i = 0; i < m_tracks.size(); i++) {
+        predictTrack(m_tracks[i], timestampSec);
+        m_tracks[i].matched = false;
+        allTracks.push_back((int)i);
+    }
+
+    std::vector<int> highDets, lowDets;
+    for (size_t j = 0; j < detections.size(); j++) {
+        if (detections[j].score >= m_config.highScore) {
+            highDets.push_back((int)j);
+        }
+        else if (detections[j].score >= m_config.lowScore) {
+            lowDets.push_back((int)j);
+        }
+    }
+
+    // 第一轮：高分检测与全部轨迹
+    std::vector<char> detMatched(detections.size(), 0);
+    for (const auto& match : associate(allTracks, highDets, detections, m_config.matchIou)) {
+        correctTrack(m_tracks[match.first], detections[match.second]);
+        detMatched[match.second] = 1;
+    }
+
+    // 第二轮：低分检测（遮挡、运动模糊）只用于延续已确认的轨迹
+    std::vector<int> remainingTracks;
+    for (int i : allTracks) {
+        if (!m_tracks[i].matched && m_tracks[i].id > 0) {
+            remainingTracks.push_back(i);
+        }
+    }
+    for (const auto& match : associate(remainingTracks, lowDets, detections, m_config.lowMatchIou)) {
+        correctTrack(m_tracks[match.first], detections[match.second]);
+    }
+
+    // 删除：未确认的轨迹一旦漏检即删除，已确认的轨迹超过 maxLostSec 删除
+    m_tracks.erase(std::remove_if(m_tracks.begin(), m_tracks.end(), [&](const Track& track) {
+        if (track.matched) {
+            return false;
+        }
+        return track.id == 0 || timestampSec - track.lastSeen > m_config.maxLostSec;
+    }), m_tracks.end());
+
+    // 确认
+    for (Track& track : m_tracks) {
+        if (track.id == 0 && track.hits >= std::max(m_config.minHits, 1)) {
+            track.id = m_nextId++;
+        }
+    }
+
+    // 新建轨迹
+    for (int j : highDets) {
+        if (detMatched[j] || detections[j].score < m_config.newTrackScore) {
+            continue;
+        }
+        Track track;
+        initTrack(track, detections[j], timestampSec);
+        if (m_config.minHits <= 1) {
+            track.id = m_nextId++;
+        }
+        m_tracks.push_back(std::move(track));
+    }
+}
+
+std::vector<TrackedObject> MultiObjectTracker::predict(double timestampSec) const
+{
+    std::vector<TrackedObject> objects;
+    for (const Track& track : m_tracks) {
+        if (track.id == 0 || !track.matched) {
+            continue;
+        }
+        TrackedObject object;
+        object.trackId = track.id;
+        object.label = track.label;
+        object.labelname = track.labelname;
+        object.score = track.score;
+        object.hits = track.hits;
+        object.lastSeenSec = track.lastSeen;
+        toBox(track.x, timestampSec - track.time, object.box, object.velocity);
+        objects.push_back(std::move(object));
+    }
+    return objects;
+}
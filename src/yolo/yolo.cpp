@@ -88,7 +88,9 @@ bool Yolo::LayerReorder(dxrt::Tensors output_info)
     {
         if(cfg.onnxOutputName == output_info[i].name())
         {
-            cfg.numBoxes = output_info.front().shape()[1];
+            // YOLOv8 风格输出为 [1, 4+numClasses, numBoxes]，其余为 [1, numBoxes, pitch]
+            cfg.numBoxes = (cfg.postproc_type == PostProcType::YOLOV8) ?
+                output_info[i].shape()[2] : output_info[i].shape()[1];
             std::cout << "cfg.numBoxes: " << cfg.numBoxes << std::endl; 
             onnxOutputIdx.emplace_back(i);
             Boxes.clear();
@@ -132,9 +134,161 @@ bool Yolo::LayerReorder(dxrt::Tensors output_info)
     cfg.layers.clear();
     cfg.layers = temp;
     cfg.Show();
+
+    // 预计算 anchor-based 解码表（层顺序与 output_info 一致）
+    if(anchorSize > 0)
+    {
+        std::vector<std::vector<int64_t>> output_shape;
+        for(size_t i=0;i<output_info.size();i++)
+        {
+            output_shape.emplace_back(output_info[i].shape());
+        }
+        BuildDecodePlan(output_shape);
+    }
+    return true;
+}
+
+void YoloDecodePlan::clear()
+{
+    layers.clear();
+    shapes.clear();
+    dataOffset.clear();
+    cellX.clear();
+    cellY.clear();
+    strideX.clear();
+    strideY.clear();
+    anchorW.clear();
+    anchorH.clear();
+}
+
+bool Yolo::BuildDecodePlan(const std::vector<std::vector<int64_t>> &output_shape)
+{
+    decodePlan.clear();
+    if(anchorSize <= 0 || cfg.layers.empty())
+    {
+        return false;
+    }
+    if(output_shape.size() < cfg.layers.size())
+    {
+        std::cerr << "[DXAPP] [ER] Yolo::BuildDecodePlan : output shape count (" << output_shape.size()
+                  << ") is less than layer count (" << cfg.layers.size() << ")." << std::endl;
+        return false;
+    }
+
+    size_t numEntries = 0;
+    for(const auto &layer : cfg.layers)
+    {
+        numEntries += static_cast<size_t>(layer.numGridX) * layer.numGridY * layer.numBoxes;
+    }
+    decodePlan.dataOffset.reserve(numEntries);
+    decodePlan.cellX.reserve(numEntries);
+    decodePlan.cellY.reserve(numEntries);
+    decodePlan.strideX.reserve(numEntries);
+    decodePlan.strideY.reserve(numEntries);
+    decodePlan.anchorW.reserve(numEntries);
+    decodePlan.anchorH.reserve(numEntries);
+
+    const int boxChannels = cfg.numClasses + 5;
+    int64_t layerBase = 0;
+    for(size_t i=0; i<cfg.layers.size(); i++)
+    {
+        const auto &layer = cfg.layers[i];
+        const auto &shape = output_shape[i];
+        int channels = shape.empty() ? 0 : static_cast<int>(shape.back());
+        if(channels < layer.numBoxes * boxChannels || (int)layer.anchorWidth.size() < layer.numBoxes
+            || (int)layer.anchorHeight.size() < layer.numBoxes)
+        {
+            std::cerr << "[DXAPP] [ER] Yolo::BuildDecodePlan : layer " << layer.name << " has " << channels
+                      << " channels, " << layer.numBoxes << " boxes x " << boxChannels << " required." << std::endl;
+            decodePlan.clear();
+            return false;
+        }
+
+        YoloDecodeLayer decodeLayer;
+        decodeLayer.firstEntry = static_cast<int32_t>(decodePlan.size());
+        decodeLayer.channels = channels;
+        float cellBias = -0.5f;
+        if(layer.scaleX != 0)
+        {
+            decodeLayer.xyPreScale = layer.scaleX;
+            decodeLayer.xyPreBias = -0.5f * (layer.scaleX - 1);
+            decodeLayer.xyGain = 1.0f;
+            cellBias = 0.0f;
+        }
+        float strideX = static_cast<float>(cfg.width / layer.numGridX);
+        float strideY = static_cast<float>(cfg.height / layer.numGridY);
+
+        for(int gY=0; gY<layer.numGridY; gY++)
+        {
+            for(int gX=0; gX<layer.numGridX; gX++)
+            {
+                for(int box=0; box<layer.numBoxes; box++)
+                {
+                    int64_t offset = layerBase + (static_cast<int64_t>(gY) * layer.numGridX * channels)
+                                               + (gX * channels)
+                                               + (box * boxChannels);
+                    decodePlan.dataOffset.push_back(static_cast<int32_t>(offset));
+                    decodePlan.cellX.push_back(gX + cellBias);
+                    decodePlan.cellY.push_back(gY + cellBias);
+                    decodePlan.strideX.push_back(strideX);
+                    decodePlan.strideY.push_back(strideY);
+                    decodePlan.anchorW.push_back(layer.anchorWidth[box] * 4.0f);
+                    decodePlan.anchorH.push_back(layer.anchorHeight[box] * 4.0f);
+                }
+            }
+        }
+        decodeLayer.numEntries = static_cast<int32_t>(decodePlan.size()) - decodeLayer.firstEntry;
+        decodePlan.layers.emplace_back(decodeLayer);
+
+        int64_t layerPitch = 1;
+        for(const auto &dim : shape)
+        {
+            layerPitch *= dim;
+        }
+        layerBase += layerPitch;
+    }
+    decodePlan.shapes = output_shape;
+
+    if(static_cast<int>(decodePlan.size()) > cfg.numBoxes)
+    {
+        std::cerr << "[DXAPP] [ER] Yolo::BuildDecodePlan : decode entries (" << decodePlan.size()
+                  << ") exceed numBoxes (" << cfg.numBoxes << ")." << std::endl;
+        decodePlan.clear();
+        return false;
+    }
+    std::cout << "[YOLO] Decode plan built: " << decodePlan.size() << " entries, "
+              << decodePlan.layers.size() << " layers" << std::endl;
     return true;
 }
 
+void Yolo::ClearCandidates()
+{
+    for(auto &indices : ScoreIndices)
+    {
+        indices.clear();
+    }
+    Result.clear();
+}
+
+void Yolo::ReserveCandidates(size_t perClass, size_t results)
+{
+    for(auto &indices : ScoreIndices)
+    {
+        indices.reserve(perClass);
+    }
+    Result.reserve(results);
+}
+
+size_t Yolo::CandidateCount() const
+{
+    size_t count = 0;
+    for(const auto &indices : ScoreIndices)
+    {
+        count += indices.size();
+    }
+    return count;
+}
+
 static bool scoreComapre(const std::pair<float, int> &a, const std::pair<float, int> &b)
 {
     if(a.first > b.first)
@@ -257,8 +411,6 @@ std::vector<BoundingBox> Yolo::PostProc(void* data, std::vector<std::vector<int6
     qDebug() << "[YOLO POSTPROC BUFFER] data_type:" << static_cast<int>(data_type);
     qDebug() << "[YOLO POSTPROC BUFFER] output_length:" << output_length;
     
-    std::vector<BoundingBox> result;
-    
     // 清空之前的結果
     for(int cls=0; cls<(int)cfg.numClasses; cls++)
     {
@@ -299,21 +451,20 @@ std::vector<BoundingBox> Yolo::PostProc(void* data, std::vector<std::vector<int6
             0,
             cfg.classNames, 
             ScoreIndices, Boxes.data(), Keypoints.data(), cfg.iouThreshold,
-            result,
+            Result,
             0
         );
         
-        qDebug() << "[YOLO POSTPROC BUFFER] ✅ NMS 後最終檢測結果:" << result.size() << "個目標";
+        qDebug() << "[YOLO POSTPROC BUFFER] ✅ NMS 後最終檢測結果:" << Result.size() << "個目標";
     }
     else
     {
         qDebug() << "[YOLO POSTPROC BUFFER] 單層輸出（簡化處理）";
         // 簡化處理：直接當作 float* 處理
-        return result;
     }
     
-    Result = result;
-    return result;
+    // NMS 直接寫入成員 Result（容量跨幀保留），返回時只做一次定長拷貝
+    return Result;
 }
 
 void Yolo::onnx_post_processing(dxrt::TensorPtrs &outputs, int64_t num_elements) {
@@ -727,20 +878,17 @@ void Yolo::raw_post_processing(dxrt::TensorPtrs outputs) {  // 改为按值传
 
 // 新增：FilterWithSort for void* buffer version
 // 參考：dx_app-1.11.0/demos/object_detection/yolo.cpp:143-305
+// 使用 LayerReorder 時預計算的 decodePlan，內層循環不再計算 stride / 偏移 / 讀取 anchor vector
 void Yolo::FilterWithSort(void* outputs, std::vector<std::vector<int64_t>> output_shape, dxrt::DataType data_type)
 {
     qDebug() << "[YOLO FILTER BUFFER] ========== FilterWithSort buffer 版本 ==========";
     qDebug() << "[YOLO FILTER BUFFER] output_shape.size():" << output_shape.size();
     qDebug() << "[YOLO FILTER BUFFER] cfg.layers.size():" << cfg.layers.size();
     
-    int boxIdx = 0;
-    int x = 0, y = 1, w = 2, h = 3;
     float ScoreThreshold = cfg.scoreThreshold;
     float conf_threshold = cfg.confThreshold;
     float rawThreshold = log(conf_threshold/(1-conf_threshold));
-    float score, score1, box_temp[4];
-    float *data;
-    float* output_per_layers = (float*)outputs;
+    const float* output_buffer = static_cast<const float*>(outputs);
     
     // 统计信息
     int totalBoxes = 0;
@@ -754,99 +902,82 @@ void Yolo::FilterWithSort(void* outputs, std::vector<std::vector<int64_t>> outpu
     
     if(anchorSize > 0)  // anchor-based YOLO (YOLOv5, YOLOv7 etc.)
     {
-        qDebug() << "[YOLO FILTER BUFFER] 使用 anchor-based 處理";
+        // 輸出 shape 與解碼表不一致時（例如未經 LayerReorder）重新構建
+        if(decodePlan.empty() || decodePlan.shapes != output_shape)
+        {
+            qDebug() << "[YOLO FILTER BUFFER] 解碼表與輸出 shape 不一致，重新構建";
+            if(!BuildDecodePlan(output_shape))
+            {
+                qDebug() << "[YOLO FILTER BUFFER ERROR] 解碼表構建失敗，跳過該幀";
+                return;
+            }
+        }
         
-        for(size_t i=0; i<cfg.layers.size(); i++)
+        const int numClasses = cfg.numClasses;
+        const int32_t* dataOffset = decodePlan.dataOffset.data();
+        const float* cellX = decodePlan.cellX.data();
+        const float* cellY = decodePlan.cellY.data();
+        const float* strideX = decodePlan.strideX.data();
+        const float* strideY = decodePlan.strideY.data();
+        const float* anchorW = decodePlan.anchorW.data();
+        const float* anchorH = decodePlan.anchorH.data();
+        float* boxes = Boxes.data();
+        
+        for(const auto &layer : decodePlan.layers)
         {
-            auto layer = cfg.layers[i];
-            int strideX = cfg.width / layer.numGridX;
-            int strideY = cfg.height / layer.numGridY;
-            int numGridX = layer.numGridX;
-            int numGridY = layer.numGridY;
-            int tensorIdx = layer.tensorIdx[0];
-            float scale_x_y = layer.scaleX;
+            const float xyPreScale = layer.xyPreScale;
+            const float xyPreBias = layer.xyPreBias;
+            const float xyGain = layer.xyGain;
+            const int end = layer.firstEntry + layer.numEntries;
             
-            // 計算當前層在 buffer 中的起始位置
-            int layer_pitch = 1;
-            if(i > 0)
+            for(int boxIdx=layer.firstEntry; boxIdx<end; boxIdx++)
             {
-                for(const auto &s : output_shape[i-1])
+                const float *data = output_buffer + dataOffset[boxIdx];
+                
+                // 快速檢查 objectness
+                if(data[4] <= rawThreshold)
                 {
-                    layer_pitch *= s;
+                    continue;
                 }
-                output_per_layers += layer_pitch;
-            }
-            
-            qDebug() << "[YOLO FILTER BUFFER] 處理層" << i << ":" << layer.name.c_str()
-                     << ", grid:" << numGridX << "x" << numGridY
-                     << ", stride:" << strideX << "x" << strideY
-                     << ", anchors:" << layer.numBoxes;
-            
-            int channels = output_shape[i].back();  // 最後一維是通道數
-            
-            for(int gY=0; gY<numGridY; gY++)
-            {
-                for(int gX=0; gX<numGridX; gX++)
+                passObjectness++;
+                float score1 = sigmoid(data[4]);
+                if(score1 <= conf_threshold)
                 {
-                    for(int box=0; box<layer.numBoxes; box++)
-                    { 
-                        totalBoxes++;
-                        bool boxDecoded = false;
-                        
-                        // 手動計算偏移（與之前修復的 raw_post_processing 一致）
-                        data = output_per_layers + (gY * numGridX * channels)
-                                                 + (gX * channels)
-                                                 + (box * (cfg.numClasses + 5));
-                        
-                        // 快速檢查 objectness
-                        if(data[4] > rawThreshold)
-                        {
-                            passObjectness++;
-                            score1 = sigmoid(data[4]);
-                            
-                            if(score1 > conf_threshold)
-                            {
-                                passConf++;
-                                for(int cls=0; cls<(int)cfg.numClasses; cls++)
-                                {
-                                    score = score1 * sigmoid(data[5+cls]);
-                                    
-                                    if (score > ScoreThreshold)
-                                    {
-                                        passScore++;
-                                        ScoreIndices[cls].emplace_back(score, boxIdx);
-                                        
-                                        if(!boxDecoded)
-                                        {
-                                            if(scale_x_y==0)
-                                            {
-                                                box_temp[x] = ( sigmoid(data[x]) * 2. - 0.5 + gX ) * strideX;
-                                                box_temp[y] = ( sigmoid(data[y]) * 2. - 0.5 + gY ) * strideY;
-                                            }
-                                            else
-                                            {
-                                                box_temp[x] = (sigmoid(data[x] * scale_x_y  - 0.5 * (scale_x_y - 1)) + gX) * strideX;
-                                                box_temp[y] = (sigmoid(data[y] * scale_x_y  - 0.5 * (scale_x_y - 1)) + gY) * strideY;
-                                            }
-                                            box_temp[w] = pow((sigmoid(data[w]) * 2.), 2) * layer.anchorWidth[box];
-                                            box_temp[h] = pow((sigmoid(data[h]) * 2.), 2) * layer.anchorHeight[box];
-                                            Boxes[boxIdx*4+0] = box_temp[x] - box_temp[w] / 2.; /*x1*/
-                                            Boxes[boxIdx*4+1] = box_temp[y] - box_temp[h] / 2.; /*y1*/
-                                            Boxes[boxIdx*4+2] = box_temp[x] + box_temp[w] / 2.; /*x2*/
-                                            Boxes[boxIdx*4+3] = box_temp[y] + box_temp[h] / 2.; /*y2*/
-                                            boxDecoded = true;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        boxIdx++;
+                    continue;
+                }
+                passConf++;
+                
+                bool boxDecoded = false;
+                for(int cls=0; cls<numClasses; cls++)
+                {
+                    float score = score1 * sigmoid(data[5+cls]);
+                    if(score <= ScoreThreshold)
+                    {
+                        continue;
+                    }
+                    passScore++;
+                    ScoreIndices[cls].emplace_back(score, boxIdx);
+                    
+                    if(!boxDecoded)
+                    {
+                        float tx = data[0] * xyPreScale + xyPreBias;
+                        float ty = data[1] * xyPreScale + xyPreBias;
+                        float sw = sigmoid(data[2]);
+                        float sh = sigmoid(data[3]);
+                        float cx = (sigmoid(tx) * xyGain + cellX[boxIdx]) * strideX[boxIdx];
+                        float cy = (sigmoid(ty) * xyGain + cellY[boxIdx]) * strideY[boxIdx];
+                        float halfW = sw * sw * anchorW[boxIdx] * 0.5f;
+                        float halfH = sh * sh * anchorH[boxIdx] * 0.5f;
+                        boxes[boxIdx*4+0] = cx - halfW; /*x1*/
+                        boxes[boxIdx*4+1] = cy - halfH; /*y1*/
+                        boxes[boxIdx*4+2] = cx + halfW; /*x2*/
+                        boxes[boxIdx*4+3] = cy + halfH; /*y2*/
+                        boxDecoded = true;
                     }
                 }
             }
-            
-            qDebug() << "[YOLO FILTER BUFFER] 層" << i << "處理完成，當前總 box 數:" << boxIdx;
         }
+        totalBoxes = static_cast<int>(decodePlan.size());
         
         qDebug() << "[YOLO FILTER] ========== 過濾統計 ==========";
         qDebug() << "[YOLO FILTER] 總 anchor boxes:" << totalBoxes;
@@ -856,6 +987,6 @@ void Yolo::FilterWithSort(void* outputs, std::vector<std::vector<int64_t>> outpu
         qDebug() << "[YOLO FILTER] 最終候選框數:" << passScore << "個";
     }
     
-    qDebug() << "[YOLO FILTER BUFFER] FilterWithSort 完成，總處理 box:" << boxIdx;
+    qDebug() << "[YOLO FILTER BUFFER] FilterWithSort 完成，總處理 box:" << totalBoxes;
 }
 
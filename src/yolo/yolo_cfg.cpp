@@ -241,4 +241,33 @@ YoloParam yolov5s_face_640 = {
     },
     {"face"},
     PostProcType::FACE
-};
\ No newline at end of file
+};
+
+const std::vector<YoloParamEntry>& GetYoloParamTable()
+{
+    static const std::vector<YoloParamEntry> table = {
+        {"yolov3_512", &yolov3_512},
+        {"yolov4_416", &yolov4_416},
+        {"yolov5s_320", &yolov5s_320},
+        {"yolov5s_512", &yolov5s_512},
+        {"yolov5s_640", &yolov5s_640},
+        {"yolox_s_512", &yolox_s_512},
+        {"yolov7_640", &yolov7_640},
+        {"yolov7_512", &yolov7_512},
+        {"yolov8_640", &yolov8_640},
+        {"yolov9_640", &yolov9_640},
+        {"yolov5s6_pose_640", &yolov5s6_pose_640},
+        {"yolov5s_face_640", &yolov5s_face_640},
+    };
+    return table;
+}
+
+YoloParam* FindYoloParam(const std::string& name)
+{
+    for (const auto& entry : GetYoloParamTable()) {
+        if (name == entry.name) {
+            return entry.param;
+        }
+    }
+    return nullptr;
+}
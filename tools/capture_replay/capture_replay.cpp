@@ -0,0 +1,145 @@
+// 录制文件回放工具：直接从 .dxcap 内存映射区驱动 Yolo::PostProc，不经过 NPU 和 UI
+//
+// 用法: CaptureReplay <capture.dxcap> --config <yolov7_640> [--loops N] [--print]
+//   --config  yolo_cfg.cpp 中的配置名（需与录制时的模型一致）
+//   --loops   重复回放次数（默认 1），用于稳定计时
+//   --print   打印每帧检测结果（已还原到原始图像坐标）
+#include <QCoreApplication>
+#include <QLoggingCategory>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <utils/capture_file.hpp>
+#include "yolo.h"
+
+using namespace dxapp::common;
+
+static void printUsage()
+{
+    std::printf("Usage: CaptureReplay <capture.dxcap> --config <name> [--loops N] [--print]\n");
+    std::printf("Configs:");
+    for (const auto& entry : GetYoloParamTable()) {
+        std::printf(" %s", entry.name);
+    }
+    std::printf("\n");
+}
+
+// 与 YoloDetector::postProcessFromBuffer 一致的 letterbox 反算
+static void scaleToInput(std::vector<BoundingBox>& boxes, const YoloParam& cfg, int origWidth, int origHeight)
+{
+    if (origWidth <= 0 || origHeight <= 0) {
+        return;
+    }
+    float ratio = std::min((float)cfg.width / origWidth, (float)cfg.height / origHeight);
+    float padWidth = (cfg.width - (int)(origWidth * ratio)) / 2.0f;
+    float padHeight = (cfg.height - (int)(origHeight * ratio)) / 2.0f;
+    for (auto& box : boxes) {
+        box.box[0] = (box.box[0] - padWidth) / ratio;
+        box.box[1] = (box.box[1] - padHeight) / ratio;
+        box.box[2] = (box.box[2] - padWidth) / ratio;
+        box.box[3] = (box.box[3] - padHeight) / ratio;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    // 后处理内部的 qDebug 日志会严重影响计时
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    std::string capturePath;
+    std::string configName;
+    int loops = 1;
+    bool printResults = false;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc) {
+            configName = argv[++i];
+        }
+        else if (arg == "--loops" && i + 1 < argc) {
+            loops = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (arg == "--print") {
+            printResults = true;
+        }
+        else if (arg[0] != '-') {
+            capturePath = arg;
+        }
+        else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    YoloParam* param = FindYoloParam(configName);
+    if (capturePath.empty() || !param) {
+        printUsage();
+        return 1;
+    }
+
+    CaptureReader reader;
+    if (!reader.open(capturePath)) {
+        std::fprintf(stderr, "Failed to open capture file: %s\n", capturePath.c_str());
+        return 1;
+    }
+    std::printf("Capture: %s\n", capturePath.c_str());
+    std::printf("  model: %s\n", reader.header().modelName);
+    std::printf("  frames: %zu%s, output: %llu bytes\n", reader.size(),
+                reader.recovered() ? " (index recovered by scan)" : "",
+                (unsigned long long)reader.header().outputSize);
+
+    // 由录制文件中的张量描述重建 shape 信息
+    dxrt::Tensors tensors;
+    std::vector<std::vector<int64_t>> shapes;
+    for (const auto& desc : reader.tensors()) {
+        std::vector<int64_t> shape(desc.dims, desc.dims + desc.numDims);
+        tensors.emplace_back(desc.name, shape, static_cast<dxrt::DataType>(desc.dtype));
+        shapes.push_back(shape);
+        std::printf("  tensor: %s dtype=%d\n", desc.name, desc.dtype);
+    }
+    if (tensors.empty() || reader.size() == 0) {
+        std::fprintf(stderr, "Capture file has no tensors or frames\n");
+        return 1;
+    }
+
+    Yolo yolo(*param);
+    if (!yolo.LayerReorder(tensors)) {
+        std::fprintf(stderr, "LayerReorder failed: config %s does not match the recorded model\n", configName.c_str());
+        return 1;
+    }
+
+    dxrt::DataType dataType = static_cast<dxrt::DataType>(reader.tensors().front().dtype);
+    int outputLength = static_cast<int>(reader.header().outputSize / sizeof(float));
+    uint64_t totalBoxes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int loop = 0; loop < loops; loop++) {
+        for (size_t i = 0; i < reader.size(); i++) {
+            const auto& record = reader.record(i);
+            // payload 直接指向映射区；PostProc 只读取输入数据
+            auto results = yolo.PostProc(const_cast<uint8_t*>(record.payload), shapes, dataType, outputLength);
+            totalBoxes += results.size();
+
+            if (printResults && loop == 0) {
+                scaleToInput(results, *param, record.header->inputWidth, record.header->inputHeight);
+                std::printf("frame %llu [%s] %zu boxes\n", (unsigned long long)record.header->frameId,
+                            record.header->inputRef, results.size());
+                for (const auto& box : results) {
+                    std::printf("  label=%d score=%.3f box=(%.1f, %.1f, %.1f, %.1f)\n",
+                                box.label, box.score, box.box[0], box.box[1], box.box[2], box.box[3]);
+                }
+            }
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    double totalFrames = (double)reader.size() * loops;
+    double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    std::printf("Post-processed %.0f frames in %.3f ms: %.0f ns/frame, %.1f frames/s, %.2f boxes/frame\n",
+                totalFrames, ns / 1e6, ns / totalFrames, totalFrames * 1e9 / ns, totalBoxes / totalFrames);
+    return 0;
+}
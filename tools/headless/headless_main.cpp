@@ -0,0 +1,212 @@
+// 无界面检测流水线（不依赖 QtWidgets / QtGui）
+//
+//   QtCamDetectHeadless --source camera:0 --duration 3600 --results results.jsonl
+//   QtCamDetectHeadless --source test.mp4 --no-loop --max-frames 1000
+//   QtCamDetectHeadless --source test.mp4 --replay capture.dxcap --stats-interval 1000
+//   QtCamDetectHeadless --source camera:0 --camera-roi 512,256,1280,1280 --camera-profile-save roi.mfs
+//   QtCamDetectHeadless --source camera:0 --camera-profile roi.mfs
+//   QtCamDetectHeadless --stream camera:0 --stream camera:1 --stream test.mp4 --stream-weights 2,2,1
+//   QtCamDetectHeadless --stream camera:all --max-in-flight 8 --batch-size 4 --batch-window-us 3000
+//   QtCamDetectHeadless --stream camera:all --devices all --max-in-flight 8
+//   QtCamDetectHeadless --source camera:0 --motion-gate --motion-threshold 8 --motion-refresh 60
+//   QtCamDetectHeadless --source camera:0 --warmup 8
+//   QtCamDetectHeadless --source test.mp4 --video-pacing realtime --decode-threads 4 --decode-queue 16
+//   QtCamDetectHeadless --source D:/parts/sku123 --no-loop --results sku123.jsonl
+//   QtCamDetectHeadless --stream D:/parts/sku123.lst --max-in-flight 8 --no-loop --results sku123.jsonl
+//   QtCamDetectHeadless --source synthetic:2448x2048@25,bayer,objects=8 --duration 600
+//   QtCamDetectHeadless --source v4l2:/dev/video0,1280x720,fmt=BGR3,buffers=8,dmabuf
+//   QtCamDetectHeadless --stream synthetic:1920x1080@60,mono8 --stream synthetic:1920x1080@60,mono8,seed=2 --max-in-flight 8
+//   QtCamDetectHeadless --config headless.ini
+//
+// 配置文件为 INI 格式，键名与命令行参数相同，放在 [headless] 分组下；命令行参数优先：
+//
+//   [headless]
+//   source=camera:0
+//   model=./assets/models/YoloV7.dxnn
+//   param-index=4
+//   duration=3600
+//   stats-interval=5000
+#include "AsyncLogger.h"
+#include "HeadlessRunner.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFileInfo>
+#include <QLoggingCategory>
+#include <QSettings>
+#include <csignal>
+#include <memory>
+
+static HeadlessRunner* g_runner = nullptr;
+
+static void onSignal(int)
+{
+    if (g_runner) {
+        g_runner->requestStop();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("QtCamDetectHeadless");
+    app.setApplicationVersion("1.0");
+    // 日志只输出到标准错误（统计信息走 qInfo，便于重定向或被日志采集），由后台线程批量写出
+    AsyncLoggerConfig logConfig;
+    AsyncLogger::instance().start(logConfig);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("无界面 YOLO 检测流水线");
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption configOption("config", "INI 配置文件（[headless] 分组）", "file");
+    QCommandLineOption sourceOption("source", "视频源: camera:<index>、v4l2:<device>[,WxH][,fmt=<fourcc>][,buffers=N][,dmabuf]、视频文件路径、图片序列（目录或 .txt/.lst 列表文件）或合成源 synthetic:[WxH][@fps][,mono8|bayer|bgr8][,objects=N][,pool=N][,seed=N]", "source");
+    QCommandLineOption streamOption("stream", "多路模式视频源（可重复，camera:all 表示全部相机），各路共享一个模型", "source");
+    QCommandLineOption weightsOption("stream-weights", "多路调度权重，逗号分隔，与 --stream 顺序对应（默认均为 1，即轮询）", "w1,w2,...");
+    QCommandLineOption inFlightOption("max-in-flight", "多路模式同时提交到 NPU 的帧数", "n");
+    QCommandLineOption batchOption("batch-size", "多路模式批大小（>1 时把多路的帧凑成一批，用向量 Run 一次提交）", "n");
+    QCommandLineOption batchWindowOption("batch-window-us", "凑批时间窗口（微秒）", "us");
+    QCommandLineOption acquisitionOption("acquisition", "相机取帧方式: polling（默认，零拷贝）或 callback", "mode");
+    QCommandLineOption cameraAutoOption("camera-auto-profile", "按模型输入尺寸自动配置相机合并倍数和像素格式");
+    QCommandLineOption cameraRoiOption("camera-roi", "相机端 ROI（全分辨率坐标 x,y,w,h），隐含 --camera-auto-profile", "x,y,w,h");
+    QCommandLineOption cameraProfileOption("camera-profile", "打开相机时加载的相机配置文件", "file");
+    QCommandLineOption cameraProfileSaveOption("camera-profile-save", "应用相机配置后保存到文件", "file");
+    QCommandLineOption motionGateOption("motion-gate", "画面静止时跳过推理（降采样亮度图块 SAD 对比滑动背景）");
+    QCommandLineOption motionThresholdOption("motion-threshold", "运动门控块阈值（块内平均灰度差）", "n");
+    QCommandLineOption motionBlocksOption("motion-min-blocks", "判定画面变化的最少变化块数", "n");
+    QCommandLineOption motionRefreshOption("motion-refresh", "静止时每 N 帧强制推理一次（0 表示不强制）", "n");
+    QCommandLineOption modelOption("model", "模型文件 (.dxnn)", "path");
+    QCommandLineOption paramOption("param-index", "YOLO 参数配置索引", "index");
+    QCommandLineOption warmupOption("warmup", "模型加载后的预热推理次数（0 表示不预热）", "n");
+    QCommandLineOption devicesOption("devices", "多设备负载均衡：NPU 设备编号，逗号分隔，或 all 表示全部设备", "ids|all");
+    QCommandLineOption replayOption("replay", "使用回放后端代替 NPU（目录或 .dxcap 文件）", "path");
+    QCommandLineOption replayLatencyOption("replay-latency-us", "回放后端模拟的推理延迟（微秒）", "us");
+    QCommandLineOption durationOption("duration", "运行时长（秒，0 表示不限）", "sec");
+    QCommandLineOption maxFramesOption("max-frames", "处理帧数上限（0 表示不限）", "n");
+    QCommandLineOption statsOption("stats-interval", "统计输出间隔（毫秒，0 表示只在结束时输出）", "ms");
+    QCommandLineOption timeoutOption("result-timeout", "单帧推理超时（毫秒）", "ms");
+    QCommandLineOption resultsOption("results", "检测结果输出文件（JSON Lines）", "file");
+    QCommandLineOption recordOption("record", "录制输出张量到 .dxcap 文件", "file");
+    QCommandLineOption noLoopOption("no-loop", "视频文件播放结束后退出");
+    QCommandLineOption pacingOption("video-pacing", "视频文件输出节奏: fast（默认，尽快输出）或 realtime（按文件帧率，跟不上时丢帧）", "mode");
+    QCommandLineOption decodeThreadsOption("decode-threads", "解码线程数（视频文件为 FFmpeg 线程，-1 使用默认值；图片序列为解码线程池，<=0 使用全部核心）", "n");
+    QCommandLineOption decodeQueueOption("decode-queue", "视频文件 / 图片序列预解码帧队列长度", "n");
+    QCommandLineOption verboseOption("verbose", "输出调试日志");
+    parser.addOptions({ configOption, sourceOption, streamOption, weightsOption, inFlightOption, batchOption,
+                        batchWindowOption, acquisitionOption, cameraAutoOption, cameraRoiOption,
+                        cameraProfileOption, cameraProfileSaveOption, motionGateOption, motionThresholdOption,
+                        motionBlocksOption, motionRefreshOption, modelOption, paramOption, warmupOption, devicesOption, replayOption,
+                        replayLatencyOption, durationOption, maxFramesOption, statsOption,
+                        timeoutOption, resultsOption, recordOption, noLoopOption, pacingOption, decodeThreadsOption,
+                        decodeQueueOption, verboseOption });
+    parser.process(app);
+
+    std::unique_ptr<QSettings> config;
+    if (parser.isSet(configOption)) {
+        config = std::make_unique<QSettings>(parser.value(configOption), QSettings::IniFormat);
+        if (!QFileInfo::exists(parser.value(configOption)) || config->status() != QSettings::NoError) {
+            qCritical() << "[HEADLESS] 无法读取配置文件:" << parser.value(configOption);
+            return 1;
+        }
+        config->beginGroup("headless");
+    }
+    // 命令行参数优先，其次配置文件，最后使用 HeadlessOptions 的默认值
+    auto value = [&](const QCommandLineOption& option, const QVariant& defaultValue) -> QVariant {
+        if (parser.isSet(option)) {
+            return parser.value(option);
+        }
+        if (config && config->contains(option.names().first())) {
+            return config->value(option.names().first());
+        }
+        return defaultValue;
+    };
+
+    HeadlessOptions options;
+    options.source = value(sourceOption, options.source).toString();
+    // INI 中多路视频源写为 stream=camera:0,camera:1,test.mp4（QSettings 解析为列表）
+    options.streams = parser.isSet(streamOption) ? parser.values(streamOption)
+        : (config ? config->value("stream").toStringList() : QStringList());
+    for (const QString& weight : value(weightsOption, QString()).toStringList().join(',').split(',', Qt::SkipEmptyParts)) {
+        options.streamWeights.append(weight.toInt());
+    }
+    options.maxInFlight = value(inFlightOption, options.maxInFlight).toInt();
+    options.batchSize = value(batchOption, options.batchSize).toInt();
+    options.batchWindowUs = value(batchWindowOption, options.batchWindowUs).toInt();
+    options.acquisition = value(acquisitionOption, options.acquisition).toString();
+    options.cameraAutoProfile = parser.isSet(cameraAutoOption) || (config && config->value("camera-auto-profile", false).toBool());
+    options.cameraProfilePath = value(cameraProfileOption, options.cameraProfilePath).toString();
+    options.cameraProfileSavePath = value(cameraProfileSaveOption, options.cameraProfileSavePath).toString();
+    // INI 中不加引号的 x,y,w,h 会被 QSettings 解析为列表
+    QString roiText = value(cameraRoiOption, QString()).toStringList().join(',');
+    if (!roiText.isEmpty()) {
+        QStringList parts = roiText.split(',');
+        if (parts.size() != 4) {
+            qCritical() << "[HEADLESS] --camera-roi 格式应为 x,y,w,h:" << roiText;
+            return 1;
+        }
+        options.cameraRoi = QRect(parts[0].toInt(), parts[1].toInt(), parts[2].toInt(), parts[3].toInt());
+    }
+    options.motionGate = parser.isSet(motionGateOption) || (config && config->value("motion-gate", false).toBool());
+    options.motionGateConfig.blockThreshold = value(motionThresholdOption, options.motionGateConfig.blockThreshold).toInt();
+    options.motionGateConfig.minChangedBlocks = value(motionBlocksOption, options.motionGateConfig.minChangedBlocks).toInt();
+    options.motionGateConfig.refreshInterval = value(motionRefreshOption, options.motionGateConfig.refreshInterval).toInt();
+    options.modelPath = value(modelOption, options.modelPath).toString();
+    options.parameterIndex = value(paramOption, options.parameterIndex).toInt();
+    options.warmupRuns = value(warmupOption, options.warmupRuns).toInt();
+    QString devicesText = value(devicesOption, QString()).toStringList().join(',');
+    if (!devicesText.isEmpty()) {
+        options.multiDevice = true;
+        if (devicesText != "all") {
+            for (const QString& device : devicesText.split(',', Qt::SkipEmptyParts)) {
+                bool ok = false;
+                options.devices.append(device.trimmed().toInt(&ok));
+                if (!ok) {
+                    qCritical() << "[HEADLESS] --devices 格式应为 0,1,... 或 all:" << devicesText;
+                    return 1;
+                }
+            }
+        }
+    }
+    options.replayPath = value(replayOption, options.replayPath).toString();
+    options.replayLatencyUs = value(replayLatencyOption, options.replayLatencyUs).toInt();
+    options.durationSec = value(durationOption, options.durationSec).toInt();
+    options.maxFrames = value(maxFramesOption, options.maxFrames).toLongLong();
+    options.statsIntervalMs = value(statsOption, options.statsIntervalMs).toInt();
+    options.resultTimeoutMs = value(timeoutOption, options.resultTimeoutMs).toInt();
+    options.resultsPath = value(resultsOption, options.resultsPath).toString();
+    options.recordPath = value(recordOption, options.recordPath).toString();
+    options.loop = !(parser.isSet(noLoopOption) || (config && config->value("no-loop", false).toBool()));
+    QString pacing = value(pacingOption, QString("fast")).toString();
+    if (pacing != "fast" && pacing != "realtime") {
+        qCritical() << "[HEADLESS] --video-pacing 应为 fast 或 realtime:" << pacing;
+        return 1;
+    }
+    options.videoDecoder.pacing = pacing == "realtime" ? VideoPacing::RealTime : VideoPacing::Unpaced;
+    options.videoDecoder.decodeThreads = value(decodeThreadsOption, options.videoDecoder.decodeThreads).toInt();
+    options.videoDecoder.queueCapacity = value(decodeQueueOption, options.videoDecoder.queueCapacity).toInt();
+    options.imageSequence.decodeThreads = value(decodeThreadsOption, options.imageSequence.decodeThreads).toInt();
+    options.imageSequence.queueCapacity = value(decodeQueueOption, options.imageSequence.queueCapacity).toInt();
+    bool verbose = parser.isSet(verboseOption) || (config && config->value("verbose", false).toBool());
+
+    // YoloDetector 等模块逐帧输出大量 qDebug，长时间运行时默认关闭
+    if (!verbose) {
+        QLoggingCategory::setFilterRules("*.debug=false");
+    }
+
+    HeadlessRunner runner(options);
+    QObject::connect(&runner, &HeadlessRunner::finished, &app, &QCoreApplication::exit, Qt::QueuedConnection);
+
+    g_runner = &runner;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    if (!runner.start()) {
+        g_runner = nullptr;
+        return 1;
+    }
+    int exitCode = app.exec();
+    g_runner = nullptr;
+    AsyncLogger::instance().stop();
+    return exitCode;
+}